@@ -0,0 +1,587 @@
+// Growth cost of the bump allocator (utility/allocators.h): the reserve-and-commit arena against
+// the copy-on-grow strategy it replaced, which allocated a block twice as large, copied everything
+// and freed the old one. Each run fills a fresh allocator with vector_instance_data-sized elements
+// from a 2 KB start, then the end-of-frame reset is timed against zeroing,
+// the entity pool (utility/pool_allocator.h) against malloc, and the upload ring
+// (utility/ring_allocator.h) per frame, and random reads over a large array with and without
+// huge pages (utility/os_memory.h). The checks run first, with the instance buffer capacity policy
+// (utility/instance_capacity.h) on a null backend; the program returns 1 if one fails.
+//   ./build/allocator_bench --json allocator.json
+
+#include "bench.h"
+#include "math/vector.hpp"
+#include "utility/allocators.h"
+#include "utility/instance_capacity.h"
+#include "utility/pool_allocator.h"
+#include "utility/ring_allocator.h"
+
+#include <stdlib.h>
+
+constexpr size_t ELEMENT_SIZE          = 80;
+constexpr size_t INITIAL_CAPACITY      = Kilobytes(2);
+constexpr size_t ARENA_RESERVE         = Megabytes(SCAST(size_t, 256));
+constexpr u32    AllocatorPushCounts[] = { 1024, 65536, 1u << 20 };
+constexpr u32    POOL_CHURN_COUNT      = 4096;
+constexpr size_t RING_SIZE             = Kilobytes(8);
+constexpr u32    RING_FRAMES           = 3;
+constexpr u32    RING_UPLOADS          = 64;
+constexpr size_t TLB_ARRAY_SIZE        = Megabytes(SCAST(size_t, 64));
+constexpr u32    TLB_READS             = 1u << 16;
+
+struct frame_reset_case
+{
+	size_t      Bytes;
+	const char* ClearName;
+	const char* ResetName;
+};
+
+static const frame_reset_case FrameResets[] =
+{
+	{ Kilobytes(SCAST(size_t, 16)) , "ClearAllocator 16 KB", "ResetAllocator 16 KB" },
+	{ Megabytes(SCAST(size_t, 1))  , "ClearAllocator 1 MB" , "ResetAllocator 1 MB"  },
+	{ Megabytes(SCAST(size_t, 16)) , "ClearAllocator 16 MB", "ResetAllocator 16 MB" },
+};
+
+static u32 FailureCount;
+
+static void Check(bool Condition, const char* Name)
+{
+	if (!Condition)
+	{
+		printf("FAILED: %s\n", Name);
+		FailureCount++;
+	}
+}
+
+// The previous BUMP_RESIZABLE growth, kept here as the baseline.
+struct copy_on_grow_allocator
+{
+	char*  Memory;
+	size_t At;
+	size_t Capacity;
+	size_t BytesCopied;
+};
+
+static copy_on_grow_allocator CreateCopyOnGrow(size_t Size)
+{
+	copy_on_grow_allocator Allocator = {};
+	Allocator.Capacity               = RoundUpToPage(Size, GetPageSize());
+	Allocator.Memory                 = (char*)ReserveMemory(Allocator.Capacity);
+	CommitMemory(Allocator.Memory, Allocator.Capacity);
+	return Allocator;
+}
+
+static void* PushCopyOnGrow(size_t Size, copy_on_grow_allocator* Allocator)
+{
+	if (Allocator->At + Size > Allocator->Capacity)
+	{
+		size_t NewCapacity = Allocator->Capacity * 2;
+		NewCapacity        = NewCapacity < Allocator->At + Size ? Allocator->At + Size : NewCapacity;
+		NewCapacity        = RoundUpToPage(NewCapacity, GetPageSize());
+
+		char* NewMemory = (char*)ReserveMemory(NewCapacity);
+		CommitMemory(NewMemory, NewCapacity);
+		memcpy(NewMemory, Allocator->Memory, Allocator->At);
+		ReleaseMemory(Allocator->Memory, Allocator->Capacity);
+
+		Allocator->BytesCopied += Allocator->At;
+		Allocator->Memory       = NewMemory;
+		Allocator->Capacity     = NewCapacity;
+	}
+
+	void* Block    = Allocator->Memory + Allocator->At;
+	Allocator->At += Size;
+	return Block;
+}
+
+static void CheckArena()
+{
+	bump_allocator Arena = CreateBumpAllocator(INITIAL_CAPACITY, BUMP_RESIZABLE, "Bench Arena", 2, ARENA_RESERVE);
+	Check(Arena.Memory && Arena.Capacity >= INITIAL_CAPACITY, "the arena commits its initial size");
+
+	u32* First = (u32*)PushSize(ELEMENT_SIZE, &Arena);
+	*First     = 0xC0FFEE;
+	for (u32 Index = 1; Index < 100000; Index++)
+	{
+		u32* Element = (u32*)PushSize(ELEMENT_SIZE, &Arena);
+		*Element     = Index;
+	}
+	Check(First == (u32*)Arena.Memory && *First == 0xC0FFEE, "pointers stay valid when the arena grows");
+	Check(*(u32*)(Arena.Memory + 99999 * ELEMENT_SIZE) == 99999, "grown pages keep their contents");
+	Check(Arena.Capacity <= Arena.Reserved && Arena.Capacity % GetPageSize() == 0, "the committed size stays inside the reservation");
+	Check(PushSize(ARENA_RESERVE, &Arena) == nullptr, "pushing past the reservation fails");
+	FreeAllocator(&Arena);
+	Check(Arena.Memory == nullptr, "freeing resets the allocator");
+
+	bump_allocator Fixed = CreateBumpAllocator(100, BUMP_FIXED, "Bench Fixed");
+	Check(PushSize(Fixed.Capacity, &Fixed) != nullptr && PushSize(1, &Fixed) == nullptr, "a fixed allocator never grows");
+	FreeAllocator(&Fixed);
+
+	bump_allocator Scratch = CreateBumpAllocator(INITIAL_CAPACITY, BUMP_RESIZABLE, "Bench Scratch", 2, ARENA_RESERVE);
+	u32* Kept              = (u32*)PushSize(ELEMENT_SIZE, &Scratch);
+	*Kept                  = 1;
+	temp_memory Outer      = BeginTemp(&Scratch);
+	PushSize(Kilobytes(64), &Scratch);
+	temp_memory Inner      = BeginTemp(&Scratch);
+	PushSize(Megabytes(SCAST(size_t, 1)), &Scratch);
+	EndTemp(Inner);
+	Check(Scratch.At == ELEMENT_SIZE + Kilobytes(64) && Scratch.Size == 2, "EndTemp rolls back to its checkpoint");
+	EndTemp(Outer);
+	Check(Scratch.At == ELEMENT_SIZE && Scratch.TempCount == 0 && *Kept == 1, "nested checkpoints keep what came before");
+	size_t Committed = Scratch.Capacity;
+	ResetAllocator(&Scratch);
+	Check(Scratch.At == 0 && Scratch.Size == 0 && Scratch.Capacity == Committed, "a reset keeps the committed pages");
+	FreeAllocator(&Scratch);
+
+	bump_allocator Aligned = CreateBumpAllocator(INITIAL_CAPACITY, BUMP_RESIZABLE, "Bench Aligned", 2, ARENA_RESERVE);
+	bool AllAligned        = true;
+	for (u32 Index = 0; Index < 1000; Index++)
+	{
+		PushSize(1 + Index % 13, &Aligned);
+		f64* Doubles   = PushArray<f64>(3, &Aligned);
+		u8*  Line      = PushArray<u8>(Index % 100, &Aligned, BUMP_CACHE_LINE);
+		vec_4* Vectors = PushStruct<vec_4>(&Aligned);
+		AllAligned    &= RCAST(size_t, Doubles) % alignof(f64) == 0 && RCAST(size_t, Line) % BUMP_CACHE_LINE == 0 &&
+		                 RCAST(size_t, Vectors) % alignof(vec_4) == 0;
+	}
+	Check(AllAligned, "typed and cache line pushes are aligned, also across growth");
+	Check(Aligned.Size == 4000, "Size counts the pushes, not the bytes");
+	vec_4* First4  = PushArray<vec_4>(3, &Aligned);
+	vec_4* Second4 = PushArray<vec_4>(2, &Aligned);
+	Check(Second4 == First4 + 3, "pushes of the same type stay contiguous");
+	PopSize(sizeof(vec_4), &Aligned);
+	Check(PushStruct<vec_4>(&Aligned) == Second4 + 1, "a popped element is pushed again in place");
+	FreeAllocator(&Aligned);
+
+	bump_allocator Array = CreateBumpAllocator(0, BUMP_RESIZABLE, "Bench Array", 2, Megabytes(SCAST(size_t, 4)));
+	u32* Values          = (u32*)GrowInPlace(64 * sizeof(u32), &Array);
+	Values[63]           = 63;
+	Check(GrowInPlace(Megabytes(SCAST(size_t, 4)), &Array) == Values && Values[63] == 63, "a single array grows in place");
+	Check(GrowInPlace(10 * sizeof(u32), &Array) == Values && Array.At == Megabytes(SCAST(size_t, 4)), "growing to a smaller size does nothing");
+	Check(GrowInPlace(Megabytes(SCAST(size_t, 4)) + 1, &Array) == nullptr, "growing past the reservation fails");
+	FreeAllocator(&Array);
+
+	bump_allocator Tagged = CreateBumpAllocator(100, BUMP_FIXED, "A tag longer than sixteen bytes");
+	Check(strlen(Tagged.Tag) == sizeof(Tagged.Tag) - 1, "long tags are truncated");
+	FreeAllocator(&Tagged);
+}
+
+static void CheckHugePages()
+{
+	size_t Granularity = GetMemoryGranularity(OS_MEMORY_HUGE_PAGES);
+	char*  Huge        = (char*)ReserveAndCommitMemory(TLB_ARRAY_SIZE, OS_MEMORY_HUGE_PAGES);
+	Check(Huge && RCAST(size_t, Huge) % Granularity == 0, "huge page ranges are aligned on a huge page");
+	if (Huge)
+	{
+		memset(Huge, 1, TLB_ARRAY_SIZE);
+		Check(Huge[0] == 1 && Huge[TLB_ARRAY_SIZE - 1] == 1, "huge page ranges are usable to the end");
+		ReleaseMemory(Huge, TLB_ARRAY_SIZE);
+	}
+
+#if defined(ALLOCATOR_HUGE_PAGES)
+	bump_allocator Arena = CreateBumpAllocator(INITIAL_CAPACITY, BUMP_RESIZABLE, "Bench Huge", 2, ARENA_RESERVE);
+	Check(Arena.Capacity < BUMP_HUGE_PAGE_THRESHOLD, "small arenas commit regular pages");
+	PushSize(BUMP_HUGE_PAGE_THRESHOLD + 1, &Arena);
+	Check(Arena.Capacity % Granularity == 0 && RCAST(size_t, Arena.Memory) % Granularity == 0,
+		  "large arenas commit whole, aligned huge pages");
+	FreeAllocator(&Arena);
+#endif
+}
+
+static void CheckPool()
+{
+	pool_allocator Pool = CreatePoolAllocator(ELEMENT_SIZE, 16, "Bench Pool", 100000);
+	Check(GetPoolElement(&Pool, POOL_HANDLE_NONE) == nullptr, "the zero handle is never valid");
+
+	static pool_handle Handles[100000];
+	bool Distinct = true;
+	for (u32 Index = 0; Index < 100000; Index++)
+	{
+		Handles[Index]                              = PoolAllocate(&Pool);
+		*GetPoolElement<u32>(&Pool, Handles[Index]) = Index;
+		Distinct                                   &= Handles[Index] != POOL_HANDLE_NONE;
+	}
+	Check(Distinct && Pool.Count == 100000, "the pool grows to MaxCount");
+	Check(PoolAllocate(&Pool) == POOL_HANDLE_NONE, "allocating past MaxCount fails");
+	Check(*GetPoolElement<u32>(&Pool, Handles[0]) == 0 && *GetPoolElement<u32>(&Pool, Handles[99999]) == 99999,
+		  "elements do not move when the pool grows");
+	Check(RCAST(size_t, GetPoolElement(&Pool, Handles[7])) % 16 == 0, "elements are aligned");
+
+	for (u32 Index = 0; Index < 100000; Index += 2)
+	{
+		PoolFree(&Pool, Handles[Index]);
+	}
+	Check(Pool.Count == 50000 && GetPoolElement(&Pool, Handles[10]) == nullptr && *GetPoolElement<u32>(&Pool, Handles[11]) == 11,
+		  "freed handles go stale, the others stay valid");
+	Check(!PoolFree(&Pool, Handles[10]) && Pool.Count == 50000, "freeing a stale handle does nothing");
+
+	u32 SlotCount     = Pool.SlotCount;
+	pool_handle Reuse = PoolAllocate(&Pool);
+	Check(Pool.SlotCount == SlotCount && (Reuse & POOL_INDEX_MASK) == (Handles[99998] & POOL_INDEX_MASK) && Reuse != Handles[99998],
+		  "freed slots are reused first, with a new generation");
+
+	pool_handle Previous = Reuse;
+	bool NeverRepeats    = true;
+	for (u32 Cycle = 0; Cycle < POOL_GENERATION_MASK - 2; Cycle++)
+	{
+		PoolFree(&Pool, Previous);
+		pool_handle Next = PoolAllocate(&Pool);
+		NeverRepeats    &= Next != Previous && Next != POOL_HANDLE_NONE && Next != Handles[99998];
+		Previous         = Next;
+	}
+	Check(NeverRepeats, "a slot goes through every generation before a handle repeats");
+	FreePoolAllocator(&Pool);
+}
+
+struct ring_upload
+{
+	size_t Offset;
+	size_t Size;
+	u8     Frame;
+};
+
+static bool HoldsFrame(u8* Memory, ring_upload Upload)
+{
+	for (size_t Index = 0; Index < Upload.Size; Index++)
+	{
+		if (Memory[Upload.Offset + Index] != Upload.Frame)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static void CheckRing()
+{
+	// Frames of varying sizes fill their uploads with their index, and every pending frame must
+	// still hold its own once the next one is written.
+	static u8   RingMemory[RING_SIZE];
+	ring_upload Uploads[RING_FRAMES][8] = {};
+	u32         UploadCounts[RING_FRAMES] = {};
+	ring_allocator Ring = CreateRingAllocator(RING_SIZE, RING_FRAMES);
+
+	bool KeepsPending = true;
+	bool AllAligned   = true;
+	u32  FailedCount  = 0;
+	for (u32 Frame = 0; Frame < 1000; Frame++)
+	{
+		BeginRingFrame(&Ring);
+
+		u32 Slot           = Frame % RING_FRAMES;
+		UploadCounts[Slot] = 0;
+		for (u32 Upload = 0; Upload < 1 + Frame % 8; Upload++)
+		{
+			size_t Size   = 1 + (Frame * 7 + Upload * 13) % 300;
+			size_t Offset = RingAllocate(&Ring, Size, 16);
+			if (Offset == RING_ALLOCATION_FAILED)
+			{
+				FailedCount++;
+				continue;
+			}
+
+			AllAligned = AllAligned && Offset % 16 == 0 && Offset + Size <= RING_SIZE;
+			memset(RingMemory + Offset, SCAST(u8, Frame), Size);
+			Uploads[Slot][UploadCounts[Slot]++] = { Offset, Size, SCAST(u8, Frame) };
+		}
+		EndRingFrame(&Ring);
+
+		for (u32 Pending = 0; Pending < RING_FRAMES && Pending <= Frame; Pending++)
+		{
+			for (u32 Upload = 0; Upload < UploadCounts[Pending]; Upload++)
+			{
+				KeepsPending = KeepsPending && HoldsFrame(RingMemory, Uploads[Pending][Upload]);
+			}
+		}
+	}
+	Check(FailedCount == 0 && Ring.WrapCount > 0, "the ring wraps around when it has room");
+	Check(AllAligned, "ring allocations are aligned and inside the ring");
+	Check(KeepsPending, "the data of pending frames is never overwritten");
+
+	ring_allocator Small = CreateRingAllocator(1024, 2);
+	Check(RingAllocate(&Small, 1025) == RING_ALLOCATION_FAILED, "an allocation larger than the ring fails");
+	Check(RingAllocate(&Small, 600) == 0, "the first allocation starts the ring");
+	EndRingFrame(&Small);
+	Check(RingAllocate(&Small, 600) == RING_ALLOCATION_FAILED, "the ring does not wrap into a pending frame");
+	Check(RingAllocate(&Small, 400) == 600, "what fits before the end is still allocated");
+	EndRingFrame(&Small);
+	BeginRingFrame(&Small);
+	Check(Small.PendingCount == 1 && RingAllocate(&Small, 600) == 0, "releasing the oldest frame gives its space back");
+	EndRingFrame(&Small);
+	ReleaseRingFrame(&Small);
+	ReleaseRingFrame(&Small);
+	Check(Small.Used == 0 && !ReleaseRingFrame(&Small) && RingAllocate(&Small, 1024) == 0, "an empty ring starts over");
+}
+
+// What the D3D11 backend does on UPDATE_RESOURCE_RECREATE, without the buffers.
+struct null_instance_buffer
+{
+	u32 Count;
+	u32 Capacity;
+	u32 ReallocationCount;
+};
+
+static void SetNullInstanceCount(null_instance_buffer* Buffer, u32 Count)
+{
+	u32 Capacity = GrowInstanceCapacity(Buffer->Capacity, Count > 0 ? Count : 1);
+	if (Capacity != Buffer->Capacity)
+	{
+		Buffer->Capacity           = Capacity;
+		Buffer->ReallocationCount += 1;
+	}
+	Buffer->Count = Count;
+}
+
+static void CheckInstanceCapacity()
+{
+	// One instance at a time, as CreateVectorEntity does: log2(100000 / 64) + 1 reallocations.
+	null_instance_buffer OneByOne = {};
+	bool Fits    = true;
+	bool Bounded = true;
+	for (u32 Count = 1; Count <= 100000; Count++)
+	{
+		SetNullInstanceCount(&OneByOne, Count);
+		Fits    &= OneByOne.Capacity >= Count;
+		Bounded &= OneByOne.Capacity <= 2 * Count + INSTANCE_MIN_CAPACITY;
+	}
+	Check(Fits && Bounded, "the capacity holds every instance and stays within twice the count");
+	Check(OneByOne.ReallocationCount == 12, "creating 100000 instances one by one reallocates 12 times");
+
+	null_instance_buffer Bulk = {};
+	SetNullInstanceCount(&Bulk, 1);
+	SetNullInstanceCount(&Bulk, 100000);
+	Check(Bulk.ReallocationCount == 2 && Bulk.Capacity == 100000, "a bulk creation reallocates once, to its count");
+
+	SetNullInstanceCount(&Bulk, 10);
+	SetNullInstanceCount(&Bulk, 0);
+	Check(Bulk.ReallocationCount == 2 && Bulk.Capacity == 100000 && Bulk.Count == 0, "the buffer never shrinks");
+	Check(GrowInstanceCapacity(0xF0000000, 0xF0000001) == 0xFFFFFFFF, "the capacity does not overflow");
+}
+
+// Only with ALLOCATOR_TELEMETRY: the counters of one tag through a known sequence.
+static void CheckTelemetry()
+{
+#if defined(ALLOCATOR_TELEMETRY)
+	bump_allocator First  = CreateBumpAllocator(Kilobytes(4), BUMP_RESIZABLE, "Bench Telemetry", 2, ARENA_RESERVE);
+	bump_allocator Second = CreateBumpAllocator(Kilobytes(4), BUMP_FIXED, "Bench Telemetry");
+	PushSize(Kilobytes(3), &Second);
+	for (u32 Index = 0; Index < 100; Index++)
+	{
+		PushSize(Kilobytes(1), &First);
+	}
+	temp_memory Temp = BeginTemp(&First);
+	PushSize(Kilobytes(50), &First);
+	EndTemp(Temp);
+	ResetAllocator(&First);
+	u8 Data[Kilobytes(1)] = {};
+	PushAndCopy(sizeof(Data), Data, &First);
+	PushSize(Kilobytes(9), &First);
+
+	allocator_telemetry* Telemetry = FindAllocatorTelemetry("Bench Telemetry");
+	Check(Telemetry && Telemetry->AllocatorCount == 2, "allocators with the same tag share an entry");
+	Check(Telemetry && Telemetry->PushCount == 104 && Telemetry->ClearCount == 1, "pushes and clears are counted");
+	Check(Telemetry && Telemetry->CurrentBytes == Kilobytes(13) && Telemetry->PeakBytes == Kilobytes(153), "current and peak bytes");
+	Check(Telemetry && Telemetry->GrowthCount > 0, "growths are counted");
+	Check(Telemetry && Telemetry->BytesCopied == 0, "growing in place copies nothing");
+	Check(Telemetry && Telemetry->CommittedBytes == First.Capacity + Second.Capacity, "committed bytes");
+
+	FreeAllocator(&First);
+	FreeAllocator(&Second);
+	Check(Telemetry && Telemetry->AllocatorCount == 0 && Telemetry->CurrentBytes == 0 && Telemetry->CommittedBytes == 0,
+		  "freeing removes the allocators' bytes");
+
+	char Written[64] = {};
+	FILE* File       = tmpfile();
+	if (File)
+	{
+		WriteJSONString(File, "a\"b\\c\n");
+		rewind(File);
+		fread(Written, 1, sizeof(Written) - 1, File);
+		fclose(File);
+	}
+	Check(strcmp(Written, "\"a\\\"b\\\\c\\u000a\"") == 0, "telemetry tags are escaped");
+#endif
+}
+
+// Longest single push over one fill, which is where copy-on-grow stalls.
+template <typename push_fn>
+static f64 MeasureWorstPush(u32 PushCount, push_fn Push)
+{
+	f64 Worst = 0;
+	for (u32 Index = 0; Index < PushCount; Index++)
+	{
+		f64 Start    = BenchNow();
+		u32* Element = (u32*)Push();
+		*Element     = Index;
+		f64 Elapsed  = BenchNow() - Start;
+		Worst        = Elapsed > Worst ? Elapsed : Worst;
+	}
+	return Worst;
+}
+
+int main(int ArgumentCount, char** Arguments)
+{
+#if defined(_WIN32)
+	BenchReport.Backend   = "VirtualAlloc";
+#else
+	BenchReport.Backend   = "mmap";
+#endif
+	BenchReport.Precision = "-";
+	printf("Backend: %s, page size: %zu bytes, huge page size: %zu bytes, element: %zu bytes\n", BenchReport.Backend, GetPageSize(),
+		   GetHugePageSize(), ELEMENT_SIZE);
+
+	CheckArena();
+	CheckHugePages();
+	CheckPool();
+	CheckRing();
+	CheckInstanceCapacity();
+	CheckTelemetry();
+	printf("%u check(s) failed\n", FailureCount);
+
+	for (u32 PushCount : AllocatorPushCounts)
+	{
+		RunBatchedBenchmark("CopyOnGrow fill", PushCount, [&]()
+		{
+			copy_on_grow_allocator Allocator = CreateCopyOnGrow(INITIAL_CAPACITY);
+			for (u32 Index = 0; Index < PushCount; Index++)
+			{
+				*(u32*)PushCopyOnGrow(ELEMENT_SIZE, &Allocator) = Index;
+			}
+			BenchEscape(Allocator.Memory);
+			ReleaseMemory(Allocator.Memory, Allocator.Capacity);
+		});
+		RunBatchedBenchmark("ReserveCommit fill", PushCount, [&]()
+		{
+			bump_allocator Arena = CreateBumpAllocator(INITIAL_CAPACITY, BUMP_RESIZABLE, "Bench Arena", 2, ARENA_RESERVE);
+			for (u32 Index = 0; Index < PushCount; Index++)
+			{
+				*(u32*)PushSize(ELEMENT_SIZE, &Arena) = Index;
+			}
+			BenchEscape(Arena.Memory);
+			FreeAllocator(&Arena);
+		});
+
+		copy_on_grow_allocator Allocator = CreateCopyOnGrow(INITIAL_CAPACITY);
+		f64 CopyWorst                    = MeasureWorstPush(PushCount, [&]() { return PushCopyOnGrow(ELEMENT_SIZE, &Allocator); });
+		ReleaseMemory(Allocator.Memory, Allocator.Capacity);
+
+		bump_allocator Arena = CreateBumpAllocator(INITIAL_CAPACITY, BUMP_RESIZABLE, "Bench Arena", 2, ARENA_RESERVE);
+		f64 ArenaWorst       = MeasureWorstPush(PushCount, [&]() { return PushSize(ELEMENT_SIZE, &Arena); });
+		FreeAllocator(&Arena);
+
+		printf("  %7u pushes: worst push %10.0f ns copy-on-grow (%zu bytes copied) | %10.0f ns reserve-commit (0 copied)\n",
+			   PushCount, CopyWorst, Allocator.BytesCopied, ArenaWorst);
+	}
+
+	// Frame reset after a frame's worth of draw list geometry: zeroing grows with it, a reset does not.
+	for (u32 FrameIndex = 0; FrameIndex < ARRAY_LENGTH(FrameResets); FrameIndex++)
+	{
+		frame_reset_case Case = FrameResets[FrameIndex];
+		bump_allocator Frame  = CreateBumpAllocator(Case.Bytes, BUMP_RESIZABLE, "Bench Frame", 2, ARENA_RESERVE);
+
+		RunBatchedBenchmark(Case.ClearName, 1, [&]()
+		{
+			PushSize(Case.Bytes, &Frame);
+			ClearAllocator(&Frame);
+			BenchEscape(Frame.Memory);
+		});
+		RunBatchedBenchmark(Case.ResetName, 1, [&]()
+		{
+			PushSize(Case.Bytes, &Frame);
+			ResetAllocator(&Frame);
+			BenchEscape(Frame.Memory);
+		});
+		FreeAllocator(&Frame);
+	}
+
+	// Entity churn: half of the live elements are freed and allocated again, in a scattered order.
+	static pool_handle ChurnHandles[POOL_CHURN_COUNT];
+	static void*       ChurnPointers[POOL_CHURN_COUNT];
+	pool_allocator ChurnPool = CreatePoolAllocator(ELEMENT_SIZE, 16, "Bench Churn");
+	for (u32 Index = 0; Index < POOL_CHURN_COUNT; Index++)
+	{
+		ChurnHandles[Index]  = PoolAllocate(&ChurnPool);
+		ChurnPointers[Index] = malloc(ELEMENT_SIZE);
+	}
+	RunBatchedBenchmark("Pool free+allocate", POOL_CHURN_COUNT / 2, [&]()
+	{
+		for (u32 Index = 0; Index < POOL_CHURN_COUNT / 2; Index++)
+		{
+			u32 Slot = (Index * 2654435761u) % POOL_CHURN_COUNT;
+			PoolFree(&ChurnPool, ChurnHandles[Slot]);
+			ChurnHandles[Slot]                                   = PoolAllocate(&ChurnPool);
+			*GetPoolElement<u32>(&ChurnPool, ChurnHandles[Slot]) = Index;
+		}
+	});
+	RunBatchedBenchmark("malloc free+allocate", POOL_CHURN_COUNT / 2, [&]()
+	{
+		for (u32 Index = 0; Index < POOL_CHURN_COUNT / 2; Index++)
+		{
+			u32 Slot = (Index * 2654435761u) % POOL_CHURN_COUNT;
+			free(ChurnPointers[Slot]);
+			ChurnPointers[Slot]        = malloc(ELEMENT_SIZE);
+			*(u32*)ChurnPointers[Slot] = Index;
+		}
+		BenchEscape(ChurnPointers);
+	});
+	for (u32 Index = 0; Index < POOL_CHURN_COUNT; Index++)
+	{
+		free(ChurnPointers[Index]);
+	}
+	FreePoolAllocator(&ChurnPool);
+
+	// Scattered reads over an array larger than the TLB covers with regular pages, as culling and
+	// the gizmo rebuild do over the instance data.
+	const char* TLBNames[] = { "Random reads 64 MB pages", "Random reads 64 MB huge pages" };
+	const u32   TLBFlags[] = { OS_MEMORY_DEFAULT, OS_MEMORY_HUGE_PAGES };
+	for (u32 Case = 0; Case < ARRAY_LENGTH(TLBFlags); Case++)
+	{
+		u8* Array = (u8*)ReserveAndCommitMemory(TLB_ARRAY_SIZE, TLBFlags[Case]);
+		if (!Array)
+		{
+			continue;
+		}
+		memset(Array, 1, TLB_ARRAY_SIZE);
+
+		u64 Sum = 0;
+		u64 Seed = 1;
+		RunBatchedBenchmark(TLBNames[Case], TLB_READS, [&]()
+		{
+			for (u32 Read = 0; Read < TLB_READS; Read++)
+			{
+				Seed  = Seed * 6364136223846793005ull + 1442695040888963407ull;
+				Sum  += Array[(Seed >> 24) % TLB_ARRAY_SIZE];
+			}
+			BenchEscape(&Sum);
+		});
+		ReleaseMemory(Array, TLB_ARRAY_SIZE);
+	}
+
+	// One frame of uploads sub-allocated from the ring, as the renderer does for its geometry.
+	ring_allocator UploadRing = CreateRingAllocator(Megabytes(SCAST(size_t, 1)), RING_FRAMES);
+	RunBatchedBenchmark("Ring frame 64 uploads", RING_UPLOADS, [&]()
+	{
+		BeginRingFrame(&UploadRing);
+		size_t Last = 0;
+		for (u32 Upload = 0; Upload < RING_UPLOADS; Upload++)
+		{
+			Last = RingAllocate(&UploadRing, 256 + Upload * 16, 16);
+		}
+		EndRingFrame(&UploadRing);
+		BenchEscape(&Last);
+	});
+
+#if defined(ALLOCATOR_TELEMETRY)
+	if (WriteAllocatorTelemetryJSON("allocator_telemetry.json"))
+	{
+		printf("Wrote allocator_telemetry.json\n");
+	}
+#endif
+
+	const char* JSONPath = FindJSONPath(ArgumentCount, Arguments);
+	if (JSONPath && WriteBenchJSON(JSONPath))
+	{
+		printf("Wrote %s\n", JSONPath);
+	}
+	return FailureCount == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#pragma once
+
+// Small timing harness shared by the benchmarks. Each benchmark runs a body over a batch of
+// elements; the batch is repeated until one sample takes at least BENCH_MIN_SAMPLE_NS, and
+// the statistics are computed over BENCH_SAMPLE_COUNT samples, in ns per element.
+
+#include <chrono>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <math.h>
+#include <string.h>
+
+#include "utility/types.h"
+
+constexpr u32 BENCH_SAMPLE_COUNT  = 15;
+constexpr f64 BENCH_MIN_SAMPLE_NS = 2e5;
+constexpr u32 BENCH_MAX_RESULTS   = 128;
+
+struct bench_result
+{
+	const char* Name;
+	u32         BatchSize;
+	u32         Repeats;
+	f64         MeanNs;
+	f64         MinNs;
+	f64         VarianceNs;
+	f64         OpsPerSecond;
+};
+
+struct bench_report
+{
+	const char*  Backend;
+	const char*  Precision;
+	u32          Count;
+	bench_result Results[BENCH_MAX_RESULTS];
+};
+
+static bench_report BenchReport;
+
+inline static f64 BenchNow()
+{
+	return std::chrono::duration<f64, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Forces the compiler to assume memory changed, so repeated batches are not folded into one.
+inline static void BenchClobberMemory()
+{
+#if defined(_MSC_VER)
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : : "memory");
+#endif
+}
+
+// Makes the compiler treat the buffer as visible to the clobber above. Benchmarks call it once
+// on their output arrays, otherwise stores nobody reads can be dropped entirely.
+inline static void BenchEscape(void* Pointer)
+{
+#if defined(_MSC_VER)
+	static void* volatile EscapedPointer;
+	EscapedPointer = Pointer;
+#else
+	asm volatile("" : : "r"(Pointer) : "memory");
+#endif
+}
+
+// Body() processes the whole batch of BatchSize elements, for kernels that take arrays.
+template <typename batch_fn>
+static bench_result RunBatchedBenchmark(const char* Name, u32 BatchSize, batch_fn Body)
+{
+	auto RunBatch = [&]()
+	{
+		Body();
+		BenchClobberMemory();
+	};
+
+	// Warm up and find how many batches make one sample long enough to time.
+	u32 Repeats = 1;
+	for (;;)
+	{
+		f64 Start = BenchNow();
+		for (u32 Repeat = 0; Repeat < Repeats; Repeat++)
+		{
+			RunBatch();
+		}
+		if (BenchNow() - Start >= BENCH_MIN_SAMPLE_NS || Repeats >= (1u << 30))
+		{
+			break;
+		}
+		Repeats *= 2;
+	}
+
+	f64 Samples[BENCH_SAMPLE_COUNT];
+	for (u32 SampleIndex = 0; SampleIndex < BENCH_SAMPLE_COUNT; SampleIndex++)
+	{
+		f64 Start = BenchNow();
+		for (u32 Repeat = 0; Repeat < Repeats; Repeat++)
+		{
+			RunBatch();
+		}
+		Samples[SampleIndex] = (BenchNow() - Start) / ((f64)Repeats * BatchSize);
+	}
+
+	bench_result Result = {};
+	Result.Name         = Name;
+	Result.BatchSize    = BatchSize;
+	Result.Repeats      = Repeats;
+	Result.MinNs        = Samples[0];
+	for (u32 SampleIndex = 0; SampleIndex < BENCH_SAMPLE_COUNT; SampleIndex++)
+	{
+		Result.MeanNs += Samples[SampleIndex] / BENCH_SAMPLE_COUNT;
+		Result.MinNs   = Samples[SampleIndex] < Result.MinNs ? Samples[SampleIndex] : Result.MinNs;
+	}
+	for (u32 SampleIndex = 0; SampleIndex < BENCH_SAMPLE_COUNT; SampleIndex++)
+	{
+		f64 Delta          = Samples[SampleIndex] - Result.MeanNs;
+		Result.VarianceNs += Delta * Delta / (BENCH_SAMPLE_COUNT - 1);
+	}
+	Result.OpsPerSecond = 1e9 / Result.MeanNs;
+
+	printf("%-32s %6u | %9.3f ns/op | min %9.3f | stddev %7.3f (%5.1f%%) | %8.2f Mop/s\n",
+		   Name, BatchSize, Result.MeanNs, Result.MinNs, sqrt(Result.VarianceNs),
+		   100.0 * sqrt(Result.VarianceNs) / Result.MeanNs, Result.OpsPerSecond * 1e-6);
+
+	if (BenchReport.Count < BENCH_MAX_RESULTS)
+	{
+		BenchReport.Results[BenchReport.Count++] = Result;
+	}
+	return Result;
+}
+
+// Body(Index) processes one element; it is called for Index in [0, BatchSize).
+template <typename body_fn>
+static bench_result RunBenchmark(const char* Name, u32 BatchSize, body_fn Body)
+{
+	return RunBatchedBenchmark(Name, BatchSize, [&]()
+	{
+		for (u32 Index = 0; Index < BatchSize; Index++)
+		{
+			Body(Index);
+		}
+	});
+}
+
+static bool WriteBenchJSON(const char* Path)
+{
+	FILE* File = fopen(Path, "w");
+	if (!File)
+	{
+		fprintf(stderr, "Could not open %s\n", Path);
+		return false;
+	}
+
+	fprintf(File, "{\n  \"backend\": \"%s\",\n  \"precision\": \"%s\",\n  \"samples\": %u,\n  \"results\": [\n",
+		    BenchReport.Backend, BenchReport.Precision, BENCH_SAMPLE_COUNT);
+	for (u32 Index = 0; Index < BenchReport.Count; Index++)
+	{
+		bench_result* Result = &BenchReport.Results[Index];
+		fprintf(File, "    {\"name\": \"%s\", \"batch\": %u, \"repeats\": %u, \"ns_per_op\": %.4f, \"min_ns\": %.4f, "
+			          "\"variance_ns2\": %.6f, \"ops_per_second\": %.1f}%s\n",
+			    Result->Name, Result->BatchSize, Result->Repeats, Result->MeanNs, Result->MinNs,
+			    Result->VarianceNs, Result->OpsPerSecond, Index + 1 < BenchReport.Count ? "," : "");
+	}
+	fprintf(File, "  ]\n}\n");
+
+	fclose(File);
+	return true;
+}
+
+// Returns the path following --json on the command line, or nullptr.
+static const char* FindJSONPath(int ArgumentCount, char** Arguments)
+{
+	for (int Index = 1; Index + 1 < ArgumentCount; Index++)
+	{
+		if (strcmp(Arguments[Index], "--json") == 0)
+		{
+			return Arguments[Index + 1];
+		}
+	}
+	return nullptr;
+}
\ No newline at end of file
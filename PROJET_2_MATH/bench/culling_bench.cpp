@@ -0,0 +1,272 @@
+// Frustum culling of the scene (space.cpp and entities.cpp) on a null backend: the grid and the
+// vector gizmos are set up as in the app, then culled from fixed cameras. The checks compare the
+// visible counts with known values, and the grid with the scalar IsBoxInFrustum test;
+// the timings re-cull the whole grid and a large set of gizmos. The program returns 1 if a check
+// fails.
+//   ./build/culling_bench --json culling.json
+
+#include "bench.h"
+#include "math/matrix.hpp"
+#include "math/frustum.hpp"
+#include "utility/allocators.h"
+
+// The parts of asset_table.cpp, dx11_main.cpp and dx11_camera.cpp the scene code uses. Instance
+// buffers only keep their counts, which is what the checks read.
+enum UPDATE_RESOURCE_TYPE : u16
+{
+	UPDATE_RESOURCE_NONE       = 1 << 0,
+	UPDATE_RESOURCE_RECREATE   = 1 << 1,
+	UPDATE_RESOURCE_DISCARD    = 1 << 2,
+	UPDATE_RESOURCE_NO_DISCARD = 1 << 3,
+};
+
+enum ENTITY_ASSET_TAG
+{
+	ENTITY_ASSET_NONE,
+
+	ENTITY_ASSET_VECTOR_GIZMO,
+	ENTITY_ASSET_GRID_CELL,
+	ENTITY_ASSET_CUBE,
+
+	ENTITY_ASSET_COUNT,
+};
+
+enum PIPELINE_TAG
+{
+	PIPELINE_NONE,
+
+	PIPELINE_GIZMOS,
+	PIPELINE_GRID,
+	PIPELINE_CUBE,
+
+	PIPELINE_COUNT
+};
+
+struct entity_asset_info { const char* Path; };
+struct pipeline_info     { u32 ShaderInputType; };
+struct mesh_info         { u32 VertexCount; };
+struct render_pipeline   { u32 Tag; };
+
+struct instance_buffer
+{
+	u32 Count;
+	u32 Capacity;
+};
+
+struct instance_range
+{
+	u32 First;
+	u32 Count;
+};
+
+constexpr u32 CULLING_MAX_RESOURCES = 8;
+
+static struct
+{
+	struct
+	{
+		instance_buffer InstanceDataBuffers[CULLING_MAX_RESOURCES];
+		u32             InstanceBufferCount;
+	} Resources;
+} Backend;
+
+static struct
+{
+	mat_4   ViewProjection;
+	frustum Frustum;
+	u32     FrustumVersion;
+} Camera;
+
+static entity_asset_info AssetTable[ENTITY_ASSET_COUNT];
+static pipeline_info     PipelineTable[PIPELINE_COUNT];
+
+static render_pipeline* CreateRenderPipeline(pipeline_info) { return nullptr; }
+static mesh_info*       LoadMesh(const char*) { return nullptr; }
+static u32  CreateObjectResource(void*, size_t) { return 0; }
+static void UpdateObjectData(u32, void*, size_t, u16) {}
+static void PushDrawCommand(u32, u32, mesh_info*, render_pipeline*) {}
+
+static u32 CreateInstancedResource(u32 InstanceCount, void*, size_t)
+{
+	u32 Key = ++Backend.Resources.InstanceBufferCount;
+	Backend.Resources.InstanceDataBuffers[Key] = { InstanceCount, InstanceCount };
+	return Key;
+}
+
+static void UpdateInstanceData(u32 InstanceResourceKey, void*, size_t, u32 InstanceCount, size_t, u16 UpdateFlags)
+{
+	instance_buffer* Buffer = &Backend.Resources.InstanceDataBuffers[InstanceResourceKey];
+	if (UpdateFlags & UPDATE_RESOURCE_RECREATE)
+	{
+		Buffer->Count    = InstanceCount;
+		Buffer->Capacity = InstanceCount > Buffer->Capacity ? InstanceCount : Buffer->Capacity;
+	}
+}
+
+static void UpdateVisibleInstances(u32 InstanceResourceKey, void*, u32 VisibleCount)
+{
+	Backend.Resources.InstanceDataBuffers[InstanceResourceKey].Count = VisibleCount;
+}
+
+static void UpdateInstanceRanges(u32 InstanceResourceKey, void*, const instance_range*, u32, u32 VisibleCount)
+{
+	Backend.Resources.InstanceDataBuffers[InstanceResourceKey].Count = VisibleCount;
+}
+
+#include "entities.cpp"
+#include "space.cpp"
+
+constexpr u32 CULLING_GIZMO_COUNT = 16384;
+
+// Grid cells drawn from the cameras below, which the checks expect. The grid is 101 x 101 cells;
+// from above, the vertical field of view leaves out one edge row.
+constexpr u32 CULLING_FRONT_CELLS    = 4710;
+constexpr u32 CULLING_TOP_DOWN_CELLS = 10100;
+
+static u32 FailureCount;
+
+static void Check(bool Condition, const char* What)
+{
+	if (!Condition)
+	{
+		printf("FAILED: %s\n", What);
+		FailureCount++;
+	}
+}
+
+// Same projection as the app's camera: 90 degrees, 16:9, near 0.1, far 100.
+static void SetCamera(vec_3 Position, vec_3 Focus)
+{
+	Camera.ViewProjection  = ProjectionMatrix(90, 16.0f / 9.0f, 0.1f, 100) * FocusMatrix(vec_3(0, 1, 0), Position, Focus);
+	Camera.Frustum         = ExtractFrustumPlanes(Camera.ViewProjection);
+	Camera.FrustumVersion += 1;
+}
+
+static u32 GetDrawnCells()
+{
+	return Backend.Resources.InstanceDataBuffers[Space.CellInstanceResourceKey].Count;
+}
+
+static u32 GetDrawnGizmos()
+{
+	return Backend.Resources.InstanceDataBuffers[EntityManager.VectorInstanceResourceKey].Count;
+}
+
+// Cells in the frustum by the scalar box test, one cell at a time.
+static u32 CountVisibleCells()
+{
+	cell_instance_data* Cells = (cell_instance_data*)Space.CellInstanceData.Memory;
+	u32 VisibleCount          = 0;
+	for (u32 Index = 0; Index < Space.CellCount; Index++)
+	{
+		VisibleCount += IsBoxInFrustum(Camera.Frustum, Cells[Index].Position + SPACE_ORIGIN + CELL_BOUNDS_OFFSET, CELL_BOUNDS_HALF_EXTENTS);
+	}
+	return VisibleCount;
+}
+
+static void RunFrame()
+{
+	UpdateEntities();
+	UpdateSpace();
+}
+
+static void CheckSceneCulling()
+{
+	SetCamera(vec_3(0, 2, -10), vec_3(0, 0, 0));
+	InitializeEntityManager();
+	Initialize3DSpace();
+	RunFrame();
+	Check(CullSpaceCells() == CULLING_FRONT_CELLS && GetDrawnCells() == CULLING_FRONT_CELLS, "grid cells drawn from the front camera");
+	Check(CountVisibleCells() == CULLING_FRONT_CELLS, "CullSpaceCells matches IsBoxInFrustum from the front camera");
+
+	// Four vectors around the origin, two behind the camera and one past the far plane.
+	f32 Origins[3][7]      = { { 0, 1, -2, 3, 0, 5, 0 }, { 0, 0, 1, 0, 0, 0, 0 }, { 0, 2, 0, -3, -20, -30, 150 } };
+	f32 Destinations[3][7] = { { 1, 1, -2, 3, 0, 5, 0 }, { 0, 1, 3, 0, 1, 1, 1 }, { 1, 3, 1, -2, -20, -30, 151 } };
+	soa_vec_3 OriginStreams      = { Origins[0], Origins[1], Origins[2] };
+	soa_vec_3 DestinationStreams = { Destinations[0], Destinations[1], Destinations[2] };
+	Check(CreateSimulationVectors(OriginStreams, DestinationStreams, vec_4(1, 1, 1, 1), 7) == 7, "the vectors are created");
+	RunFrame();
+	Check(GetDrawnGizmos() == 4, "only the gizmos in front of the camera are drawn");
+
+	// Moving one of them behind the camera drops it; moving it back brings it back.
+	simulation_vector* Moved = GetSimulationVector(EntityManager.VectorInstances[1]);
+	Moved->Origin            = vec_3(1, 0, -25);
+	Moved->Direction         = vec_3(1, 0, -24);
+	UpdateVectorPosition(Moved);
+	RunFrame();
+	Check(GetDrawnGizmos() == 3, "a gizmo moved behind the camera is no longer drawn");
+	Moved->Origin    = vec_3(1, 0, 2);
+	Moved->Direction = vec_3(1, 1, 3);
+	UpdateVectorPosition(Moved);
+	RunFrame();
+	Check(GetDrawnGizmos() == 4, "a gizmo moved back in front is drawn again");
+
+	// Above the grid looking down, all but the vector past the far end of the grid are in view;
+	// below it, looking down, nothing is.
+	SetCamera(vec_3(0, 50, 0), vec_3(0, 49, 0.001f));
+	RunFrame();
+	Check(GetDrawnCells() == CULLING_TOP_DOWN_CELLS && CountVisibleCells() == CULLING_TOP_DOWN_CELLS, "grid cells drawn from above");
+	Check(GetDrawnGizmos() == 6, "gizmos drawn from above");
+	SetCamera(vec_3(0, -5, 0), vec_3(0, -6, 0.001f));
+	RunFrame();
+	Check(GetDrawnCells() == 0, "no grid cell is drawn looking away from the grid");
+	Check(GetDrawnGizmos() == 0, "no gizmo is drawn looking away from the vectors");
+
+	// Back to the first camera: the same cells and gizmos as before.
+	SetCamera(vec_3(0, 2, -10), vec_3(0, 0, 0));
+	RunFrame();
+	Check(GetDrawnCells() == CULLING_FRONT_CELLS && GetDrawnGizmos() == 4, "the front camera draws the same again");
+}
+
+// Fills the scene with gizmos spread over the grid, for the timings.
+static void CreateBenchGizmos()
+{
+	static f32 Origins[3][CULLING_GIZMO_COUNT];
+	static f32 Destinations[3][CULLING_GIZMO_COUNT];
+	for (u32 Index = 0; Index < CULLING_GIZMO_COUNT; Index++)
+	{
+		Origins[0][Index]      = (f32)((Index * 7) % 101) - 50.0f;
+		Origins[1][Index]      = (f32)((Index * 13) % 11);
+		Origins[2][Index]      = (f32)((Index * 3) % 101) - 50.0f;
+		Destinations[0][Index] = Origins[0][Index] + 1.0f;
+		Destinations[1][Index] = Origins[1][Index] + 2.0f;
+		Destinations[2][Index] = Origins[2][Index] + (f32)(Index % 3);
+	}
+
+	soa_vec_3 OriginStreams      = { Origins[0], Origins[1], Origins[2] };
+	soa_vec_3 DestinationStreams = { Destinations[0], Destinations[1], Destinations[2] };
+	CreateSimulationVectors(OriginStreams, DestinationStreams, vec_4(1, 1, 1, 1), CULLING_GIZMO_COUNT);
+	RunFrame();
+}
+
+int main(int ArgumentCount, char** Arguments)
+{
+	BenchReport.Backend   = MATH_BACKEND_NAME;
+	BenchReport.Precision = MATH_PRECISION_NAME;
+	printf("Backend: %s%s, precision: %s\n", MATH_BACKEND_NAME, MATH_SIMD_FMA ? " + FMA" : "", MATH_PRECISION_NAME);
+
+	CheckSceneCulling();
+	printf("%u check(s) failed\n", FailureCount);
+
+	CreateBenchGizmos();
+	RunBatchedBenchmark("CullSpaceCells", Space.CellCount, [&]()
+	{
+		Camera.FrustumVersion += 1;
+		u32 VisibleCount       = CullSpaceCells();
+		BenchEscape(&VisibleCount);
+	});
+	RunBatchedBenchmark("CullVectorGizmos", EntityManager.VectorEntitysCount, [&]()
+	{
+		Camera.FrustumVersion += 1;
+		u32 VisibleCount       = CullVectorGizmos();
+		BenchEscape(&VisibleCount);
+	});
+
+	const char* JSONPath = FindJSONPath(ArgumentCount, Arguments);
+	if (JSONPath && !WriteBenchJSON(JSONPath))
+	{
+		return 1;
+	}
+
+	return FailureCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+// Reproducibility check for the deterministic simulation mode (math/simulation.hpp). It replays a
+// fixed cube trajectory through the same steps as entities.cpp and hashes the state after each one.
+// The Q32.32 checksum must equal DETERMINISTIC_CHECKSUM on every compiler, optimization level and
+// instruction set; the program returns 1 otherwise, or if the Q32.32 divide differs from the long
+// division it replaced. The f64 checksum is printed for comparison, together with how far the two
+// trajectories drift apart.
+//   ./build/determinism_bench --json determinism.json
+
+#include "bench.h"
+#include "math/simulation.hpp"
+
+constexpr u64 DETERMINISTIC_CHECKSUM = 0x8694418E0B6EAECBull;
+constexpr u32 TRAJECTORY_STEPS       = 4096;
+
+struct trajectory_result
+{
+	u64       Checksum;
+	f64       MaxDrift;
+	vec_3_f64 FinalPosition;
+};
+
+static vec_3_f64 ReferencePositions[2 * TRAJECTORY_STEPS];
+
+// Same sequence as the UI: a push, then free flight under gravity; and the constant-force update.
+template <typename T>
+static trajectory_result RunTrajectory(bool RecordReference)
+{
+	trajectory_result Result = {};
+	Result.Checksum          = SIMULATION_HASH_SEED;
+
+	vec<T, 3> Position = VectorCast<T>(vec_3(1.0f, 0.5f, 1.0f));
+	vec<T, 3> Velocity = vec<T, 3>();
+	AddPushImpulse(&Velocity, vec_3(1.0f, 2.0f, 0.5f), 5.0f, 1.5f);
+
+	for (u32 Step = 0; Step < 2 * TRAJECTORY_STEPS; Step++)
+	{
+		if (Step < TRAJECTORY_STEPS)
+		{
+			IntegrateGravity(&Velocity);
+			IntegratePosition(&Position, Velocity);
+		}
+		else
+		{
+			IntegrateCubeForces(&Position, &Velocity, 2.5f, (Step & 1) != 0);
+		}
+
+		Result.Checksum = HashSimulationState(Result.Checksum, Position);
+		Result.Checksum = HashSimulationState(Result.Checksum, Velocity);
+
+		vec_3_f64 Current = VectorCast<f64>(Position);
+		if (RecordReference)
+		{
+			ReferencePositions[Step] = Current;
+		}
+		else
+		{
+			vec_3_f64 Delta = Current - ReferencePositions[Step];
+			f64 Drift       = sqrt(Dot(Delta, Delta));
+			Result.MaxDrift = Drift > Result.MaxDrift ? Drift : Result.MaxDrift;
+		}
+	}
+
+	Result.FinalPosition = VectorCast<f64>(Position);
+	return Result;
+}
+
+// The bit-by-bit long division operator/ used before the 128-bit divide, rounding included.
+static q32_32 LongDivideFixed(q32_32 Left, q32_32 Right)
+{
+	bool Negative  = (Left.Raw < 0) != (Right.Raw < 0);
+	u64  Numerator = Left.Raw < 0 ? SCAST(u64, 0) - SCAST(u64, Left.Raw) : SCAST(u64, Left.Raw);
+	u64  Divisor   = Right.Raw < 0 ? SCAST(u64, 0) - SCAST(u64, Right.Raw) : SCAST(u64, Right.Raw);
+
+	u64 Quotient  = Numerator / Divisor;
+	u64 Remainder = Numerator % Divisor;
+	for (u32 Bit = 0; Bit < 32; Bit++)
+	{
+		bool Carry = (Remainder >> 63) != 0;
+		Remainder <<= 1;
+		Quotient  <<= 1;
+		if (Carry || Remainder >= Divisor)
+		{
+			Remainder -= Divisor;
+			Quotient  |= 1;
+		}
+	}
+	if (Remainder >= Divisor - Remainder)
+	{
+		Quotient += 1;
+	}
+	return FixedFromRaw(SCAST(i64, Negative ? SCAST(u64, 0) - Quotient : Quotient));
+}
+
+constexpr u32 DIVIDE_CHECK_COUNT = 1u << 20;
+
+// operator/ against LongDivideFixed on random operands of every magnitude, quotients that wrap
+// included. Returns how many differ.
+static u32 CheckFixedDivide()
+{
+	u64 State      = 0x9E3779B97F4A7C15ull;
+	u32 Mismatches = 0;
+	for (u32 Index = 0; Index < DIVIDE_CHECK_COUNT; Index++)
+	{
+		State ^= State << 13;
+		State ^= State >> 7;
+		State ^= State << 17;
+		i64 Left  = SCAST(i64, State) >> (State & 63);
+		i64 Right = SCAST(i64, State * 0x2545F4914F6CDD1Dull) >> ((State >> 6) & 63);
+		if (Right == 0)
+		{
+			continue;
+		}
+		Mismatches += (FixedFromRaw(Left) / FixedFromRaw(Right)) != LongDivideFixed(FixedFromRaw(Left), FixedFromRaw(Right));
+	}
+	return Mismatches;
+}
+
+int main(int ArgumentCount, char** Arguments)
+{
+	BenchReport.Backend   = MATH_BACKEND_NAME;
+	BenchReport.Precision = MATH_SIMULATION_NAME;
+	printf("Backend: %s%s, simulation: %s\n", MATH_BACKEND_NAME, MATH_SIMD_FMA ? " + FMA" : "", MATH_SIMULATION_NAME);
+
+	trajectory_result Float = RunTrajectory<f64>(true);
+	trajectory_result Fixed = RunTrajectory<q32_32>(false);
+
+	printf("f64    checksum %016llx, final position (%.9f, %.9f, %.9f)\n", (unsigned long long)Float.Checksum,
+		   Float.FinalPosition.x, Float.FinalPosition.y, Float.FinalPosition.z);
+	printf("Q32.32 checksum %016llx, final position (%.9f, %.9f, %.9f), max drift from f64 %.3e\n",
+		   (unsigned long long)Fixed.Checksum, Fixed.FinalPosition.x, Fixed.FinalPosition.y, Fixed.FinalPosition.z,
+		   Fixed.MaxDrift);
+
+	bool Passed = Fixed.Checksum == DETERMINISTIC_CHECKSUM;
+	printf("Q32.32 checksum %s (expected %016llx)\n", Passed ? "matches" : "DIFFERS", (unsigned long long)DETERMINISTIC_CHECKSUM);
+
+	u32 DivideMismatches = CheckFixedDivide();
+	printf("Q32.32 divide: %u of %u differ from the long division\n", DivideMismatches, DIVIDE_CHECK_COUNT);
+	Passed = Passed && DivideMismatches == 0;
+
+	vec_3_f64 FloatPosition = vec_3_f64(1.0, 0.5, 1.0);
+	vec_3_f64 FloatVelocity = vec_3_f64(0.5, 1.0, 0.25);
+	vec_3_q32 FixedPosition = VectorCast<q32_32>(FloatPosition);
+	vec_3_q32 FixedVelocity = VectorCast<q32_32>(FloatVelocity);
+	RunBatchedBenchmark("IntegrateCubeForces f64", TRAJECTORY_STEPS, [&]()
+	{
+		for (u32 Step = 0; Step < TRAJECTORY_STEPS; Step++) IntegrateCubeForces(&FloatPosition, &FloatVelocity, 2.5f, true);
+		BenchEscape(&FloatPosition);
+	});
+	RunBatchedBenchmark("IntegrateCubeForces Q32.32", TRAJECTORY_STEPS, [&]()
+	{
+		for (u32 Step = 0; Step < TRAJECTORY_STEPS; Step++) IntegrateCubeForces(&FixedPosition, &FixedVelocity, 2.5f, true);
+		BenchEscape(&FixedPosition);
+	});
+	RunBatchedBenchmark("IntegrateGravity+Position f64", TRAJECTORY_STEPS, [&]()
+	{
+		for (u32 Step = 0; Step < TRAJECTORY_STEPS; Step++)
+		{
+			IntegrateGravity(&FloatVelocity);
+			IntegratePosition(&FloatPosition, FloatVelocity);
+		}
+		BenchEscape(&FloatPosition);
+	});
+	RunBatchedBenchmark("IntegrateGravity+Position Q32.32", TRAJECTORY_STEPS, [&]()
+	{
+		for (u32 Step = 0; Step < TRAJECTORY_STEPS; Step++)
+		{
+			IntegrateGravity(&FixedVelocity);
+			IntegratePosition(&FixedPosition, FixedVelocity);
+		}
+		BenchEscape(&FixedPosition);
+	});
+
+	const char* JSONPath = FindJSONPath(ArgumentCount, Arguments);
+	if (JSONPath && WriteBenchJSON(JSONPath))
+	{
+		printf("Wrote %s\n", JSONPath);
+	}
+	return Passed ? 0 : 1;
+}
\ No newline at end of file
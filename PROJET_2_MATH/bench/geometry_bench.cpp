@@ -0,0 +1,327 @@
+// Correctness checks and timings for math/geometry.hpp and the frustum culling kernels.
+// The checks run first: known cases for the scalar queries, then the batched kernels against
+// the scalar ones on random inputs. The program returns 1 if any check fails.
+//   ./build/geometry_bench --json geometry.json
+
+#include "bench.h"
+#include "math/geometry.hpp"
+#include "math/frustum.hpp"
+
+constexpr u32 GEOMETRY_COUNT        = 16384;
+constexpr u32 GeometryBatchSizes[]  = { 64, 1024, GEOMETRY_COUNT };
+// The batched kernels skip the scalar code's FMA contraction, so values may differ in the last bits.
+constexpr f32 GEOMETRY_TOLERANCE    = 1e-4f;
+
+static f32 BoxMin[3][GEOMETRY_COUNT];
+static f32 BoxMax[3][GEOMETRY_COUNT];
+static f32 Centers[3][GEOMETRY_COUNT];
+static f32 Radii[GEOMETRY_COUNT];
+static f32 Normals[3][GEOMETRY_COUNT];
+static f32 Distances[GEOMETRY_COUNT];
+static f32 StartsA[3][GEOMETRY_COUNT];
+static f32 EndsA[3][GEOMETRY_COUNT];
+static f32 StartsB[3][GEOMETRY_COUNT];
+static f32 EndsB[3][GEOMETRY_COUNT];
+
+static f32 OutputS[GEOMETRY_COUNT];
+static f32 OutputT[GEOMETRY_COUNT];
+static f32 OutputD[GEOMETRY_COUNT];
+static u32 OutputIndices[GEOMETRY_COUNT];
+
+static soa_vec_3 Streams(f32 (&Arrays)[3][GEOMETRY_COUNT])
+{
+	soa_vec_3 Result = { Arrays[0], Arrays[1], Arrays[2] };
+	return Result;
+}
+
+static vec_3 StreamVector(f32 (&Arrays)[3][GEOMETRY_COUNT], u32 Index)
+{
+	return vec_3(Arrays[0][Index], Arrays[1][Index], Arrays[2][Index]);
+}
+
+static u32 RandomState = 0x2545f491;
+static f32 Random(f32 Min, f32 Max)
+{
+	RandomState = RandomState * 1664525u + 1013904223u;
+	f32 Unit    = (f32)(RandomState >> 8) / (f32)(1 << 24);
+	return Min + (Max - Min) * Unit;
+}
+
+static void FillInputs()
+{
+	for (u32 Index = 0; Index < GEOMETRY_COUNT; Index++)
+	{
+		for (u32 Axis = 0; Axis < 3; Axis++)
+		{
+			f32 Center            = Random(-50, 50);
+			f32 HalfSize          = Random(0.1f, 5);
+			BoxMin[Axis][Index]   = Center - HalfSize;
+			BoxMax[Axis][Index]   = Center + HalfSize;
+			Centers[Axis][Index]  = Random(-50, 50);
+			Normals[Axis][Index]  = Random(-1, 1);
+			StartsA[Axis][Index]  = Random(-10, 10);
+			EndsA[Axis][Index]    = Random(-10, 10);
+			StartsB[Axis][Index]  = Random(-10, 10);
+			EndsB[Axis][Index]    = Random(-10, 10);
+		}
+		Radii[Index]     = Random(0.1f, 10);
+		Distances[Index] = Random(-20, 20);
+
+		// A few degenerate and parallel segments to cover the special cases.
+		if (Index % 61 == 0)
+		{
+			for (u32 Axis = 0; Axis < 3; Axis++) EndsA[Axis][Index] = StartsA[Axis][Index];
+		}
+		if (Index % 67 == 0)
+		{
+			for (u32 Axis = 0; Axis < 3; Axis++) EndsB[Axis][Index] = StartsB[Axis][Index];
+		}
+		if (Index % 71 == 0)
+		{
+			for (u32 Axis = 0; Axis < 3; Axis++) EndsB[Axis][Index] = StartsB[Axis][Index] + (EndsA[Axis][Index] - StartsA[Axis][Index]);
+		}
+	}
+
+	BenchEscape(BoxMin);
+	BenchEscape(BoxMax);
+	BenchEscape(Centers);
+	BenchEscape(Radii);
+	BenchEscape(Normals);
+	BenchEscape(Distances);
+	BenchEscape(OutputS);
+	BenchEscape(OutputT);
+	BenchEscape(OutputD);
+	BenchEscape(OutputIndices);
+}
+
+static u32 FailureCount;
+
+static void Check(bool Condition, const char* What)
+{
+	if (!Condition)
+	{
+		printf("FAILED: %s\n", What);
+		FailureCount++;
+	}
+}
+
+static bool NearlyEqual(f32 A, f32 B)
+{
+	f32 Difference = A - B;
+	f32 Scale      = 1 + (A < 0 ? -A : A);
+	return (Difference < 0 ? -Difference : Difference) <= GEOMETRY_TOLERANCE * Scale;
+}
+
+static void CheckScalarQueries()
+{
+	f32 t = 0;
+	ray Ray = { vec_3(0, 0, -5), vec_3(0, 0, 1) };
+
+	aabb Box = { vec_3(-1, -1, -1), vec_3(1, 1, 1) };
+	Check(RayIntersectsAABB(Ray, Box, &t) && t == 4, "ray-AABB front hit");
+	Check(!RayIntersectsAABB(ray{ vec_3(0, 2, -5), vec_3(0, 0, 1) }, Box, &t) && t == GEOMETRY_NO_HIT, "ray-AABB parallel miss");
+	Check(!RayIntersectsAABB(ray{ vec_3(0, 0, 5), vec_3(0, 0, 1) }, Box, &t), "ray-AABB behind");
+	Check(RayIntersectsAABB(ray{ vec_3(0, 0, 0), vec_3(1, 1, 0) }, Box, &t) && t == 0, "ray-AABB from inside");
+
+	Check(RayIntersectsPlane(Ray, PlaneFromPointNormal(vec_3(0, 0, 2), vec_3(0, 0, -1)), &t) && t == 7, "ray-plane hit");
+	Check(!RayIntersectsPlane(Ray, PlaneFromPointNormal(vec_3(0, 0, -6), vec_3(0, 0, 1)), &t), "ray-plane behind");
+	Check(!RayIntersectsPlane(Ray, PlaneFromPointNormal(vec_3(1, 0, 0), vec_3(1, 0, 0)), &t), "ray-plane parallel");
+	Check(NearlyEqual(SignedDistance(PlaneFromTriangle(vec_3(0, 0, 0), vec_3(1, 0, 0), vec_3(0, 1, 0)), vec_3(3, 3, 2)), 2),
+		  "plane from triangle");
+
+	Check(RayIntersectsSphere(Ray, sphere{ vec_3(0, 0, 0), 2 }, &t) && t == 3, "ray-sphere hit");
+	Check(RayIntersectsSphere(ray{ vec_3(0, 0, 0), vec_3(0, 0, 1) }, sphere{ vec_3(0, 0, 0), 2 }, &t) && t == 0, "ray-sphere inside");
+	Check(!RayIntersectsSphere(Ray, sphere{ vec_3(0, 3, 0), 2 }, &t), "ray-sphere beside");
+	Check(!RayIntersectsSphere(Ray, sphere{ vec_3(0, 0, -10), 2 }, &t), "ray-sphere behind");
+	Check(RayIntersectsSphere(ray{ vec_3(0, 0, -5), vec_3(0, 0, 2) }, sphere{ vec_3(0, 0, 0), 1 }, &t) && t == 2,
+		  "ray-sphere unnormalized direction");
+
+	segment_closest_points Closest = ClosestPointsSegmentSegment(segment{ vec_3(-1, 0, 0), vec_3(1, 0, 0) },
+		                                                         segment{ vec_3(0, -1, 1), vec_3(0, 1, 1) });
+	Check(Closest.s == 0.5f && Closest.t == 0.5f && Closest.DistanceSquared == 1, "segments crossing");
+	Closest = ClosestPointsSegmentSegment(segment{ vec_3(0, 0, 0), vec_3(1, 0, 0) }, segment{ vec_3(3, 1, 0), vec_3(5, 1, 0) });
+	Check(Closest.s == 1 && Closest.t == 0 && Closest.DistanceSquared == 5, "segments parallel apart");
+	Closest = ClosestPointsSegmentSegment(segment{ vec_3(2, 2, 2), vec_3(2, 2, 2) }, segment{ vec_3(0, 0, 0), vec_3(4, 0, 0) });
+	Check(Closest.t == 0.5f && Closest.DistanceSquared == 8, "point against segment");
+
+	Check(AABBOverlap(Box, aabb{ vec_3(0.5f, 0.5f, 0.5f), vec_3(3, 3, 3) }), "AABB overlap");
+	Check(!AABBOverlap(Box, aabb{ vec_3(0.5f, 1.5f, 0.5f), vec_3(3, 3, 3) }), "AABB apart");
+}
+
+static void CheckBatchedQueries()
+{
+	soa_aabb Boxes       = { Streams(BoxMin), Streams(BoxMax) };
+	soa_sphere Spheres   = { Streams(Centers), Radii };
+	soa_plane Planes     = { Streams(Normals), Distances };
+	soa_segment SegmentA = { Streams(StartsA), Streams(EndsA) };
+	soa_segment SegmentB = { Streams(StartsB), Streams(EndsB) };
+
+	u32 Mismatches = 0;
+	for (u32 RayIndex = 0; RayIndex < 16; RayIndex++)
+	{
+		ray Ray = { vec_3(Random(-60, 60), Random(-60, 60), Random(-60, 60)), vec_3(Random(-1, 1), Random(-1, 1), Random(-1, 1)) };
+		if (RayIndex == 0)
+		{
+			Ray.Direction = vec_3(0, 0, 1);
+		}
+
+		f32 t = 0;
+		BatchRayAABB(Ray, Boxes, GEOMETRY_COUNT, OutputT);
+		for (u32 Index = 0; Index < GEOMETRY_COUNT; Index++)
+		{
+			RayIntersectsAABB(Ray, aabb{ StreamVector(BoxMin, Index), StreamVector(BoxMax, Index) }, &t);
+			Mismatches += !NearlyEqual(t, OutputT[Index]);
+		}
+
+		BatchRayPlane(Ray, Planes, GEOMETRY_COUNT, OutputT);
+		for (u32 Index = 0; Index < GEOMETRY_COUNT; Index++)
+		{
+			RayIntersectsPlane(Ray, plane{ StreamVector(Normals, Index), Distances[Index] }, &t);
+			Mismatches += !NearlyEqual(t, OutputT[Index]);
+		}
+
+		BatchRaySphere(Ray, Spheres, GEOMETRY_COUNT, OutputT);
+		for (u32 Index = 0; Index < GEOMETRY_COUNT; Index++)
+		{
+			RayIntersectsSphere(Ray, sphere{ StreamVector(Centers, Index), Radii[Index] }, &t);
+			Mismatches += !NearlyEqual(t, OutputT[Index]);
+		}
+	}
+	Check(Mismatches == 0, "batched ray queries match the scalar ones");
+
+	Mismatches = 0;
+	BatchSegmentSegment(SegmentA, SegmentB, GEOMETRY_COUNT, OutputS, OutputT, OutputD);
+	for (u32 Index = 0; Index < GEOMETRY_COUNT; Index++)
+	{
+		segment A = { StreamVector(StartsA, Index), StreamVector(EndsA, Index) };
+		segment B = { StreamVector(StartsB, Index), StreamVector(EndsB, Index) };
+		segment_closest_points Closest = ClosestPointsSegmentSegment(A, B);
+
+		// Parallel segments have a whole range of closest points; only the distance is unique.
+		vec_3 d1      = A.End - A.Start;
+		vec_3 d2      = B.End - B.Start;
+		vec_3 Cross   = VectorProduct(d1, d2);
+		bool Parallel = Dot(Cross, Cross) <= 1e-6f * Dot(d1, d1) * Dot(d2, d2);
+
+		Mismatches += !NearlyEqual(Closest.DistanceSquared, OutputD[Index]) ||
+			          (!Parallel && (!NearlyEqual(Closest.s, OutputS[Index]) || !NearlyEqual(Closest.t, OutputT[Index])));
+	}
+	Check(Mismatches == 0, "batched segment-segment matches the scalar one");
+
+	aabb Box = { vec_3(-20, -20, -20), vec_3(15, 10, 25) };
+	u32 OverlapCount = BatchAABBOverlap(Box, Boxes, GEOMETRY_COUNT, OutputIndices);
+	u32 Expected     = 0;
+	Mismatches       = 0;
+	for (u32 Index = 0; Index < GEOMETRY_COUNT; Index++)
+	{
+		if (AABBOverlap(Box, aabb{ StreamVector(BoxMin, Index), StreamVector(BoxMax, Index) }))
+		{
+			Mismatches += Expected >= OverlapCount || OutputIndices[Expected] != Index;
+			Expected++;
+		}
+	}
+	Check(Mismatches == 0 && Expected == OverlapCount, "batched AABB overlap matches the scalar one");
+
+	frustum Frustum  = ExtractFrustumPlanes(ProjectionMatrix(70, 16.0f / 9.0f, 0.1f, 100) *
+		                                    FocusMatrix(vec_3(0, 1, 0), vec_3(0, 5, -30), vec_3(0, 0, 0)));
+	u32 VisibleCount = CullSpheres(Frustum, Streams(Centers), Radii, GEOMETRY_COUNT, OutputIndices);
+	Expected         = 0;
+	Mismatches       = 0;
+	for (u32 Index = 0; Index < GEOMETRY_COUNT; Index++)
+	{
+		if (IsSphereInFrustum(Frustum, StreamVector(Centers, Index), Radii[Index]))
+		{
+			Mismatches += Expected >= VisibleCount || OutputIndices[Expected] != Index;
+			Expected++;
+		}
+	}
+	Check(Mismatches == 0 && Expected == VisibleCount, "CullSpheres matches IsSphereInFrustum");
+}
+
+template <typename batch_fn>
+static void RunAllSizes(const char* Name, batch_fn Body)
+{
+	for (u32 BatchSize : GeometryBatchSizes)
+	{
+		RunBatchedBenchmark(Name, BatchSize, [&]() { Body(BatchSize); });
+	}
+}
+
+int main(int ArgumentCount, char** Arguments)
+{
+	BenchReport.Backend   = MATH_BACKEND_NAME;
+	BenchReport.Precision = MATH_PRECISION_NAME;
+	printf("Backend: %s%s, precision: %s\n", MATH_BACKEND_NAME, MATH_SIMD_FMA ? " + FMA" : "", MATH_PRECISION_NAME);
+
+	FillInputs();
+	CheckScalarQueries();
+	CheckBatchedQueries();
+	printf("%u check(s) failed\n", FailureCount);
+
+	ray Ray              = { vec_3(-55, 3, -60), Normalize(vec_3(1, 0.1f, 1)) };
+	soa_aabb Boxes       = { Streams(BoxMin), Streams(BoxMax) };
+	soa_sphere Spheres   = { Streams(Centers), Radii };
+	soa_plane Planes     = { Streams(Normals), Distances };
+	soa_segment SegmentA = { Streams(StartsA), Streams(EndsA) };
+	soa_segment SegmentB = { Streams(StartsB), Streams(EndsB) };
+	aabb Box             = { vec_3(-20, -20, -20), vec_3(15, 10, 25) };
+	frustum Frustum      = ExtractFrustumPlanes(ProjectionMatrix(70, 16.0f / 9.0f, 0.1f, 100) *
+		                                        FocusMatrix(vec_3(0, 1, 0), vec_3(0, 5, -30), vec_3(0, 0, 0)));
+
+	RunAllSizes("RayIntersectsAABB", [&](u32 Count)
+	{
+		for (u32 i = 0; i < Count; i++) RayIntersectsAABB(Ray, aabb{ StreamVector(BoxMin, i), StreamVector(BoxMax, i) }, &OutputT[i]);
+	});
+	RunAllSizes("BatchRayAABB", [&](u32 Count) { BatchRayAABB(Ray, Boxes, Count, OutputT); });
+	RunAllSizes("RayIntersectsPlane", [&](u32 Count)
+	{
+		for (u32 i = 0; i < Count; i++) RayIntersectsPlane(Ray, plane{ StreamVector(Normals, i), Distances[i] }, &OutputT[i]);
+	});
+	RunAllSizes("BatchRayPlane", [&](u32 Count) { BatchRayPlane(Ray, Planes, Count, OutputT); });
+	RunAllSizes("RayIntersectsSphere", [&](u32 Count)
+	{
+		for (u32 i = 0; i < Count; i++) RayIntersectsSphere(Ray, sphere{ StreamVector(Centers, i), Radii[i] }, &OutputT[i]);
+	});
+	RunAllSizes("BatchRaySphere", [&](u32 Count) { BatchRaySphere(Ray, Spheres, Count, OutputT); });
+	RunAllSizes("ClosestPointsSegmentSegment", [&](u32 Count)
+	{
+		for (u32 i = 0; i < Count; i++)
+		{
+			OutputD[i] = ClosestPointsSegmentSegment(segment{ StreamVector(StartsA, i), StreamVector(EndsA, i) },
+				                                     segment{ StreamVector(StartsB, i), StreamVector(EndsB, i) }).DistanceSquared;
+		}
+	});
+	RunAllSizes("BatchSegmentSegment", [&](u32 Count) { BatchSegmentSegment(SegmentA, SegmentB, Count, OutputS, OutputT, OutputD); });
+	RunAllSizes("AABBOverlap", [&](u32 Count)
+	{
+		u32 OverlapCount = 0;
+		for (u32 i = 0; i < Count; i++)
+		{
+			if (AABBOverlap(Box, aabb{ StreamVector(BoxMin, i), StreamVector(BoxMax, i) }))
+			{
+				OutputIndices[OverlapCount++] = i;
+			}
+		}
+	});
+	RunAllSizes("BatchAABBOverlap", [&](u32 Count) { BatchAABBOverlap(Box, Boxes, Count, OutputIndices); });
+	RunAllSizes("IsSphereInFrustum", [&](u32 Count)
+	{
+		u32 VisibleCount = 0;
+		for (u32 i = 0; i < Count; i++)
+		{
+			if (IsSphereInFrustum(Frustum, StreamVector(Centers, i), Radii[i]))
+			{
+				OutputIndices[VisibleCount++] = i;
+			}
+		}
+	});
+	RunAllSizes("CullSpheres", [&](u32 Count) { CullSpheres(Frustum, Streams(Centers), Radii, Count, OutputIndices); });
+
+	const char* JSONPath = FindJSONPath(ArgumentCount, Arguments);
+	if (JSONPath && !WriteBenchJSON(JSONPath))
+	{
+		return 1;
+	}
+
+	return FailureCount == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,229 @@
+// Microbenchmarks for the math kernels the app uses, at scalar (1) and batched sizes.
+// Prints ns/op, throughput and spread; --json <path> also writes the results as JSON.
+// Also checks the vector calculator batches against the scalar vec_3 rules of the calculator UI.
+//   cmake -S . -B build -DCMAKE_BUILD_TYPE=Release && cmake --build build && ./build/kernel_bench --json kernels.json
+
+#include "bench.h"
+#include "math/matrix.hpp"
+#include "math/batch.hpp"
+
+// The calculator only reads Origin and Direction; its output goes to the stub below instead of the entities.
+struct simulation_vector
+{
+	vec_3 Origin;
+	vec_3 Direction;
+};
+
+static u32 CreateSimulationVectors(soa_vec_3 Origins, soa_vec_3 Destinations, vec_4 Color, u32 Count);
+
+#include "vector_calculator.cpp"
+
+constexpr u32 KERNEL_MAX_BATCH = 16384;
+constexpr u32 KernelBatchSizes[] = { 1, 64, 1024, KERNEL_MAX_BATCH };
+
+static vec_3 InputA[KERNEL_MAX_BATCH];
+static vec_3 InputB[KERNEL_MAX_BATCH];
+static vec_4 InputC[KERNEL_MAX_BATCH];
+static mat_4 InputM[KERNEL_MAX_BATCH];
+static f32   InputF[KERNEL_MAX_BATCH];
+
+static f32   OutputF[KERNEL_MAX_BATCH];
+static vec_3 OutputV[KERNEL_MAX_BATCH];
+static mat_4 OutputM[KERNEL_MAX_BATCH];
+
+static void FillInputs()
+{
+	u32 State = 0x9e3779b9;
+	auto Random = [&State](f32 Min, f32 Max)
+	{
+		State    = State * 1664525u + 1013904223u;
+		f32 Unit = (f32)(State >> 8) / (f32)(1 << 24);
+		return Min + (Max - Min) * Unit;
+	};
+
+	for (u32 Index = 0; Index < KERNEL_MAX_BATCH; Index++)
+	{
+		InputA[Index] = vec_3(Random(-10, 10), Random(-10, 10), Random(-10, 10));
+		InputB[Index] = vec_3(Random(-10, 10), Random(-10, 10), Random(-10, 10));
+		InputC[Index] = vec_4(Random(-10, 10), Random(-10, 10), Random(-10, 10), Random(-10, 10));
+		InputF[Index] = Random(30, 110);
+		InputM[Index] = TranslationMatrix(InputA[Index]) * RotationMatrixFromEulerAngles(InputB[Index] * 30.0f);
+	}
+
+	BenchEscape(InputA);
+	BenchEscape(InputB);
+	BenchEscape(InputC);
+	BenchEscape(InputM);
+	BenchEscape(InputF);
+	BenchEscape(OutputF);
+	BenchEscape(OutputV);
+	BenchEscape(OutputM);
+}
+
+constexpr u32   CALCULATOR_LEFT_COUNT  = 1003;
+constexpr u32   CALCULATOR_RIGHT_COUNT = 29;
+constexpr u32   CALCULATOR_LARGE_COUNT = 300;
+constexpr f32   CALCULATOR_TOLERANCE   = 1e-4f;
+
+static simulation_vector CalculatorLeft[CALCULATOR_LEFT_COUNT];
+static simulation_vector CalculatorRight[CALCULATOR_LARGE_COUNT];
+
+static u32               FailureCount;
+static calculator_batch* CheckedBatch;
+static u32               CheckedCount;
+static u32               Mismatches;
+
+static void Check(bool Condition, const char* What)
+{
+	if (!Condition)
+	{
+		printf("FAILED: %s\n", What);
+		FailureCount++;
+	}
+}
+
+static vec_3 StreamVector(soa_vec_3 Streams, u32 Index)
+{
+	return vec_3(Streams.x[Index], Streams.y[Index], Streams.z[Index]);
+}
+
+static bool NearlyEqual(vec_3 A, vec_3 B)
+{
+	f32 Size = VectorLength(A);
+	return AreNearlyEqual(A, B, CALCULATOR_TOLERANCE * (1 + Size));
+}
+
+// Same rules as the calculator UI: the world-space vector is Direction - Origin, a subtraction starts at
+// the right tip and every other operation at the left origin.
+static void GetScalarResult(calculator_batch* Batch, simulation_vector Left, simulation_vector Right, vec_3* Origin, vec_3* Destination)
+{
+	vec_3 LeftVector  = Left.Direction - Left.Origin;
+	vec_3 RightVector = Right.Direction - Right.Origin;
+	vec_3 Result      = {};
+	*Origin           = Left.Origin;
+
+	switch (Batch->OpType)
+	{
+	case OPERATION_ADDITION:          Result = LeftVector + RightVector; break;
+	case OPERATION_SUBTRACTION:       Result = LeftVector - RightVector; *Origin = Right.Direction; break;
+	case OPERATION_VECTOR_PRODUCT:    Result = VectorProduct(LeftVector, RightVector); break;
+	case OPERATION_SCALING:           Result = LeftVector * Batch->Scalar; break;
+	case OPERATION_VECTOR_PROJECTION: Result = ProjectVectorOnVector(RightVector, LeftVector); break;
+	case OPERATION_PLANE_PROJECTION:  Result = ProjectVectorOnPlane(LeftVector, Batch->PlaneNormal); break;
+	default:                          break;
+	}
+
+	*Destination = *Origin + Result;
+}
+
+// Stands in for the entities: compares what CreateCalculatedVectors would create with the scalar path.
+static u32 CreateSimulationVectors(soa_vec_3 Origins, soa_vec_3 Destinations, vec_4 Color, u32 Count)
+{
+	calculator_batch* Batch = CheckedBatch;
+	bool IsUnary            = IsUnaryOperation(Batch->OpType);
+	u32 RightCount          = Batch->Layout == CALCULATOR_N_BY_ONE ? 1 : Batch->RightCount;
+
+	for (u32 Index = 0; Index < Count; Index++)
+	{
+		u32 LeftIndex  = IsUnary || Batch->Layout == CALCULATOR_N_BY_ONE ? Index : Index / RightCount;
+		u32 RightIndex = IsUnary || Batch->Layout == CALCULATOR_N_BY_ONE ? 0 : Index % RightCount;
+
+		vec_3 Origin, Destination;
+		GetScalarResult(Batch, Batch->Left[LeftIndex], Batch->Right[RightIndex], &Origin, &Destination);
+		Mismatches += !NearlyEqual(Origin, StreamVector(Origins, Index)) ||
+		              !NearlyEqual(Destination, StreamVector(Destinations, Index));
+	}
+
+	CheckedCount = Count;
+	return Count;
+}
+
+static void CheckCalculatorBatch(OPERATION_TYPE OpType, CALCULATOR_LAYOUT Layout, u32 LeftCount, u32 RightCount)
+{
+	calculator_batch Batch = {};
+	Batch.OpType           = OpType;
+	Batch.Layout           = Layout;
+	Batch.Left             = CalculatorLeft;
+	Batch.LeftCount        = LeftCount;
+	Batch.Right            = CalculatorRight;
+	Batch.RightCount       = RightCount;
+	Batch.Scalar           = -2.5f;
+	Batch.PlaneNormal      = vec_3(1, 2, -3);
+
+	CheckedBatch = &Batch;
+	CheckedCount = 0;
+	Mismatches   = 0;
+
+	u32 Expected = GetCalculatorOutputCount(&Batch);
+	u32 Created  = CreateCalculatedVectors(&Batch, vec_4(1, 1, 1, 1));
+
+	static const char* OperationNames[OPERATION_TYPE_COUNT] =
+	{
+		"addition", "subtraction", "vector product", "scaling", "vector projection", "plane projection",
+	};
+
+	char What[128];
+	snprintf(What, sizeof(What), "calculator %s %u x %u (%s) matches the scalar path", OperationNames[OpType], LeftCount,
+	         RightCount, Layout == CALCULATOR_N_BY_ONE ? "N x 1" : "N x N");
+	Check(Mismatches == 0 && Created == Expected && CheckedCount == Expected, What);
+}
+
+static void CheckCalculatorBatches()
+{
+	for (u32 Index = 0; Index < CALCULATOR_LEFT_COUNT; Index++)
+	{
+		CalculatorLeft[Index] = { InputA[Index], InputB[Index] };
+	}
+	for (u32 Index = 0; Index < CALCULATOR_LARGE_COUNT; Index++)
+	{
+		CalculatorRight[Index] = { InputB[KERNEL_MAX_BATCH - 1 - Index], InputA[KERNEL_MAX_BATCH - 1 - Index] };
+	}
+
+	// 1003 and 29 leave a remainder after every 4- or 8-wide loop; the 300 x 300 batch grows the scratch.
+	for (u32 OpType = 0; OpType < OPERATION_TYPE_COUNT; OpType++)
+	{
+		CheckCalculatorBatch((OPERATION_TYPE)OpType, CALCULATOR_N_BY_ONE, CALCULATOR_LEFT_COUNT, CALCULATOR_RIGHT_COUNT);
+		CheckCalculatorBatch((OPERATION_TYPE)OpType, CALCULATOR_N_BY_N, 37, CALCULATOR_RIGHT_COUNT);
+		CheckCalculatorBatch((OPERATION_TYPE)OpType, CALCULATOR_N_BY_N, CALCULATOR_LARGE_COUNT, CALCULATOR_LARGE_COUNT);
+	}
+}
+
+template <typename body_fn>
+static void RunAllSizes(const char* Name, body_fn Body)
+{
+	for (u32 BatchSize : KernelBatchSizes)
+	{
+		RunBenchmark(Name, BatchSize, Body);
+	}
+}
+
+int main(int ArgumentCount, char** Arguments)
+{
+	BenchReport.Backend   = MATH_BACKEND_NAME;
+	BenchReport.Precision = MATH_PRECISION_NAME;
+	printf("Backend: %s%s, precision: %s\n", MATH_BACKEND_NAME, MATH_SIMD_FMA ? " + FMA" : "", MATH_PRECISION_NAME);
+
+	FillInputs();
+	CheckCalculatorBatches();
+	printf("%u check(s) failed\n", FailureCount);
+
+	RunAllSizes("Dot(vec_3)", [](u32 i) { OutputF[i] = Dot(InputA[i], InputB[i]); });
+	RunAllSizes("Dot(vec_4)", [](u32 i) { OutputF[i] = Dot(InputC[i], InputC[KERNEL_MAX_BATCH - 1 - i]); });
+	RunAllSizes("VectorProduct", [](u32 i) { OutputV[i] = VectorProduct(InputA[i], InputB[i]); });
+	RunAllSizes("Normalize", [](u32 i) { OutputV[i] = Normalize(InputA[i]); });
+	RunAllSizes("GetAngleBetween", [](u32 i) { OutputF[i] = GetAngleBetween(InputA[i], InputB[i]); });
+	RunAllSizes("ProjectVectorOnVector", [](u32 i) { OutputV[i] = ProjectVectorOnVector(InputA[i], InputB[i]); });
+	RunAllSizes("ProjectVectorOnPlane", [](u32 i) { OutputV[i] = ProjectVectorOnPlane(InputA[i], InputB[i]); });
+	RunAllSizes("mat_4 operator*", [](u32 i) { OutputM[i] = InputM[i] * InputM[KERNEL_MAX_BATCH - 1 - i]; });
+	RunAllSizes("RotationMatrixFromEulerAngles", [](u32 i) { OutputM[i] = RotationMatrixFromEulerAngles(InputA[i] * 36.0f); });
+	RunAllSizes("FocusMatrix", [](u32 i) { OutputM[i] = FocusMatrix(vec_3(0, 1, 0), InputA[i], InputB[i]); });
+	RunAllSizes("ProjectionMatrix", [](u32 i) { OutputM[i] = ProjectionMatrix(InputF[i], 16.0f / 9.0f, 0.1f, 100.0f); });
+
+	const char* JSONPath = FindJSONPath(ArgumentCount, Arguments);
+	if (JSONPath && !WriteBenchJSON(JSONPath))
+	{
+		return 1;
+	}
+
+	return FailureCount == 0 ? 0 : 1;
+}
\ No newline at end of file
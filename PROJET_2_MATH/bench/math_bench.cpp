@@ -0,0 +1,529 @@
+// Microbenchmark for the mat_4 multiply, the batched transform kernels and the gizmo rebuild. Built by the CMake project in this folder,
+// or directly: g++ -O2 -march=native -I../src math_bench.cpp -o math_bench
+
+#include <chrono>
+#include <string.h>
+
+#include "math/batch.hpp"
+#include "math/quaternion.hpp"
+
+// Copy of the original scalar Dot() and multiply, kept as the baseline.
+inline static f32 ReferenceDot(vec_4 vl, vec_4 vr)
+{
+	f32 Result = 0;
+	for (u32 VectorIndex = 0; VectorIndex < VEC_4_LENGTH; VectorIndex++)
+	{
+		Result += vl.AsArray[VectorIndex] * vr.AsArray[VectorIndex];
+	}
+	return Result;
+}
+
+inline static mat_4 ReferenceMultiply(mat_4 Transform, mat_4 Base)
+{
+	vec_4 FirstColumn  = vec_4(Base.AsArray[0], Base.AsArray[4], Base.AsArray[8] , Base.AsArray[12]);
+	vec_4 SecondColumn = vec_4(Base.AsArray[1], Base.AsArray[5], Base.AsArray[9] , Base.AsArray[13]);
+	vec_4 ThirdColumn  = vec_4(Base.AsArray[2], Base.AsArray[6], Base.AsArray[10], Base.AsArray[14]);
+	vec_4 FourthColumn = vec_4(Base.AsArray[3], Base.AsArray[7], Base.AsArray[11], Base.AsArray[15]);
+
+	mat_4 Result;
+	for (u32 RowIndex = 0; RowIndex < MAT_4_ROW_COUNT; RowIndex++)
+	{
+		vec_4 Row          = Transform[RowIndex];
+
+		Result[RowIndex].x = ReferenceDot(Row, FirstColumn);
+		Result[RowIndex].y = ReferenceDot(Row, SecondColumn);
+		Result[RowIndex].z = ReferenceDot(Row, ThirdColumn);
+		Result[RowIndex].w = ReferenceDot(Row, FourthColumn);
+	}
+
+	return Result;
+}
+
+// Copy of the scalar affine multiply, which the SSE one has to match bit for bit.
+inline static affine_3x4 ReferenceAffineMultiply(affine_3x4 Transform, affine_3x4 Base)
+{
+	affine_3x4 Result;
+	for (u32 RowIndex = 0; RowIndex < AFFINE_ROW_COUNT; RowIndex++)
+	{
+		vec_4 Row = Transform[RowIndex];
+		for (u32 Column = 0; Column < VEC_4_LENGTH; Column++)
+		{
+			Result[RowIndex][Column] = Row.x * Base.Rows[0][Column] +
+				                       Row.y * Base.Rows[1][Column] +
+				                       Row.z * Base.Rows[2][Column];
+		}
+		Result[RowIndex].w += Row.w;
+	}
+	return Result;
+}
+
+// Copy of the scalar cofactor inverse, the baseline for the SSE block inverse.
+inline static mat_4 ReferenceInverse(mat_4 m)
+{
+	f32 a[16];
+	memcpy(a, m.AsArray, sizeof(a));
+
+	f32 S0 = a[0] * a[5] - a[4] * a[1];
+	f32 S1 = a[0] * a[6] - a[4] * a[2];
+	f32 S2 = a[0] * a[7] - a[4] * a[3];
+	f32 S3 = a[1] * a[6] - a[5] * a[2];
+	f32 S4 = a[1] * a[7] - a[5] * a[3];
+	f32 S5 = a[2] * a[7] - a[6] * a[3];
+
+	f32 C5 = a[10] * a[15] - a[14] * a[11];
+	f32 C4 = a[9]  * a[15] - a[13] * a[11];
+	f32 C3 = a[9]  * a[14] - a[13] * a[10];
+	f32 C2 = a[8]  * a[15] - a[12] * a[11];
+	f32 C1 = a[8]  * a[14] - a[12] * a[10];
+	f32 C0 = a[8]  * a[13] - a[12] * a[9];
+
+	f32 Determinant = S0 * C5 - S1 * C4 + S2 * C3 + S3 * C2 - S4 * C1 + S5 * C0;
+	if (Determinant == 0)
+	{
+		return mat_4();
+	}
+
+	f32 InvDet   = 1.0f / Determinant;
+	mat_4 Result = mat_4(
+		vec_4(( a[5]  * C5 - a[6]  * C4 + a[7]  * C3) * InvDet,
+		      (-a[1]  * C5 + a[2]  * C4 - a[3]  * C3) * InvDet,
+		      ( a[13] * S5 - a[14] * S4 + a[15] * S3) * InvDet,
+		      (-a[9]  * S5 + a[10] * S4 - a[11] * S3) * InvDet),
+		vec_4((-a[4]  * C5 + a[6]  * C2 - a[7]  * C1) * InvDet,
+		      ( a[0]  * C5 - a[2]  * C2 + a[3]  * C1) * InvDet,
+		      (-a[12] * S5 + a[14] * S2 - a[15] * S1) * InvDet,
+		      ( a[8]  * S5 - a[10] * S2 + a[11] * S1) * InvDet),
+		vec_4(( a[4]  * C4 - a[5]  * C2 + a[7]  * C0) * InvDet,
+		      (-a[0]  * C4 + a[1]  * C2 - a[3]  * C0) * InvDet,
+		      ( a[12] * S4 - a[13] * S2 + a[15] * S0) * InvDet,
+		      (-a[8]  * S4 + a[9]  * S2 - a[11] * S0) * InvDet),
+		vec_4((-a[4]  * C3 + a[5]  * C1 - a[6]  * C0) * InvDet,
+		      ( a[0]  * C3 - a[1]  * C1 + a[2]  * C0) * InvDet,
+		      (-a[12] * S3 + a[13] * S1 - a[14] * S0) * InvDet,
+		      ( a[8]  * S3 - a[9]  * S1 + a[10] * S0) * InvDet)
+	);
+	return Result;
+}
+
+constexpr u32 BENCH_MATRIX_COUNT = 1024;
+constexpr u32 BENCH_REPEAT_COUNT = 2000;
+
+static mat_4 Inputs[BENCH_MATRIX_COUNT];
+static volatile f32 Sink;
+
+template <typename multiply_fn>
+static f64 TimeMultiply(multiply_fn Multiply)
+{
+	auto Start = std::chrono::steady_clock::now();
+
+	mat_4 Accumulator = IdentityMatrix();
+	for (u32 Repeat = 0; Repeat < BENCH_REPEAT_COUNT; Repeat++)
+	{
+		for (u32 Index = 0; Index < BENCH_MATRIX_COUNT; Index++)
+		{
+			Accumulator = Multiply(Inputs[Index], Accumulator);
+		}
+	}
+	Sink = Accumulator.AsArray[0];
+
+	auto End      = std::chrono::steady_clock::now();
+	f64 TotalNs   = std::chrono::duration<f64, std::nano>(End - Start).count();
+	f64 OpCount   = (f64)BENCH_MATRIX_COUNT * BENCH_REPEAT_COUNT;
+	return TotalNs / OpCount;
+}
+
+// Both inverses are within about 1e-5 of a double precision one on these inputs, the
+// projections being the worst conditioned; their difference is checked with some margin.
+constexpr f32 BENCH_INVERSE_TOLERANCE = 1e-4f;
+
+static mat_4 InverseInputs[BENCH_MATRIX_COUNT];
+static mat_4 InverseOutputs[BENCH_MATRIX_COUNT];
+
+template <typename inverse_fn>
+static f64 TimeInverse(inverse_fn Invert)
+{
+	auto Start = std::chrono::steady_clock::now();
+	for (u32 Repeat = 0; Repeat < BENCH_REPEAT_COUNT; Repeat++)
+	{
+		for (u32 Index = 0; Index < BENCH_MATRIX_COUNT; Index++)
+		{
+			InverseOutputs[Index] = Invert(InverseInputs[Index]);
+		}
+		Sink = InverseOutputs[Repeat % BENCH_MATRIX_COUNT].AsArray[0];
+	}
+	auto End = std::chrono::steady_clock::now();
+	return std::chrono::duration<f64, std::nano>(End - Start).count() / ((f64)BENCH_MATRIX_COUNT * BENCH_REPEAT_COUNT);
+}
+
+// Half camera like (rotation, scale and translation, then a perspective row), half general
+// matrices with a heavy diagonal. Returns the largest difference with the scalar inverse,
+// relative to its largest element, or 1 if a singular matrix does not give the identity.
+static f32 BenchInverse()
+{
+	for (u32 Index = 0; Index < BENCH_MATRIX_COUNT; Index++)
+	{
+		f32 Angle = (f32)Index;
+		if (Index % 2 == 0)
+		{
+			mat_4 Model = TranslationMatrix(vec_3(Angle * 0.1f, -2, 5)) * RotationMatrixFromEulerAngles(vec_3(Angle, Angle * 0.5f, 30)) *
+				          ScalingMatrix(vec_3(1 + (f32)(Index % 7), 2, 0.5f));
+			InverseInputs[Index] = ProjectionMatrix(60 + (f32)(Index % 30), 16.0f / 9.0f, 0.1f, 100) * Model;
+		}
+		else
+		{
+			for (u32 Element = 0; Element < 16; Element++)
+			{
+				InverseInputs[Index].AsArray[Element] = (f32)((Index * 31 + Element * 17) % 23) * 0.1f - 1.1f;
+			}
+			for (u32 RowIndex = 0; RowIndex < MAT_4_ROW_COUNT; RowIndex++)
+			{
+				InverseInputs[Index][RowIndex][RowIndex] += 4.0f;
+			}
+		}
+	}
+
+	f32 MaxError = 0.0f;
+	for (u32 Index = 0; Index < BENCH_MATRIX_COUNT; Index++)
+	{
+		mat_4 Expected = ReferenceInverse(InverseInputs[Index]);
+		mat_4 Actual   = Inverse(InverseInputs[Index]);
+
+		f32 Scale = 0.0f;
+		for (u32 Element = 0; Element < 16; Element++)
+		{
+			f32 Magnitude = fabsf(Expected.AsArray[Element]);
+			Scale         = Magnitude > Scale ? Magnitude : Scale;
+		}
+		for (u32 Element = 0; Element < 16; Element++)
+		{
+			f32 Error = fabsf(Expected.AsArray[Element] - Actual.AsArray[Element]) / Scale;
+			MaxError  = Error > MaxError ? Error : MaxError;
+		}
+	}
+
+	mat_4 Singular = Inverse(mat_4(vec_4(1, 2, 3, 4), vec_4(2, 4, 6, 8), vec_4(0, 1, 0, 1), vec_4(5, 0, 2, 1)));
+	mat_4 Identity = IdentityMatrix();
+	if (memcmp(&Singular, &Identity, sizeof(mat_4)) != 0)
+	{
+		printf("FAILED: a singular matrix does not invert to the identity\n");
+		MaxError = 1.0f;
+	}
+
+	f64 ScalarNs = TimeInverse([](mat_4 m) { return ReferenceInverse(m); });
+	f64 SimdNs   = TimeInverse([](mat_4 m) { return Inverse(m); });
+	printf("Inverse(mat_4)    : %.2f ns/op (scalar: %.2f, %.2fx), max relative error %g\n",
+		   SimdNs, ScalarNs, ScalarNs / SimdNs, MaxError);
+	return MaxError;
+}
+
+constexpr u32 BENCH_BATCH_COUNT = 16384;
+
+static f32 PointStreams[6][BENCH_BATCH_COUNT];
+static mat_4 BatchOutput[BENCH_BATCH_COUNT];
+
+template <typename body_fn>
+static f64 TimeBatch(u32 Repeats, body_fn Body)
+{
+	auto Start = std::chrono::steady_clock::now();
+	for (u32 Repeat = 0; Repeat < Repeats; Repeat++)
+	{
+		Body();
+	}
+	auto End = std::chrono::steady_clock::now();
+	return std::chrono::duration<f64, std::nano>(End - Start).count() / ((f64)Repeats * BENCH_BATCH_COUNT);
+}
+
+static void BenchBatchKernels()
+{
+	for (u32 Index = 0; Index < BENCH_BATCH_COUNT; Index++)
+	{
+		for (u32 Stream = 0; Stream < 6; Stream++)
+		{
+			PointStreams[Stream][Index] = (f32)((Index * (Stream + 3)) % 97) * 0.1f;
+		}
+	}
+
+	soa_vec_3 In        = { PointStreams[0], PointStreams[1], PointStreams[2] };
+	soa_vec_3 Out       = { PointStreams[3], PointStreams[4], PointStreams[5] };
+	mat_4     Transform = TranslationMatrix(vec_3(1, 2, 3)) * RotationMatrixFromEulerAngles(vec_3(10, 20, 30));
+
+	f64 ScalarPointNs = TimeBatch(200, [&]()
+	{
+		for (u32 Index = 0; Index < BENCH_BATCH_COUNT; Index++)
+		{
+			mat_4 Point = mat_4(vec_4(In.x[Index], 0, 0, 0), vec_4(In.y[Index], 0, 0, 0),
+				                vec_4(In.z[Index], 0, 0, 0), vec_4(1, 0, 0, 0));
+			mat_4 Moved = Transform * Point;
+			Out.x[Index] = Moved.AsArray[0];
+			Out.y[Index] = Moved.AsArray[4];
+			Out.z[Index] = Moved.AsArray[8];
+		}
+		Sink = Out.x[BENCH_BATCH_COUNT - 1];
+	});
+	f64 BatchPointNs = TimeBatch(200, [&]()
+	{
+		TransformPoints(Transform, In, Out, BENCH_BATCH_COUNT);
+		Sink = Out.x[BENCH_BATCH_COUNT - 1];
+	});
+
+	// Gizmo style Translation * Rotation * Scale, with the rotation given as basis columns.
+	f64 ScalarComposeNs = TimeBatch(50, [&]()
+	{
+		for (u32 Index = 0; Index < BENCH_BATCH_COUNT; Index++)
+		{
+			mat_4 Rotation = mat_4(
+				vec_4(In.x[Index], Out.x[Index], In.z[Index], 0),
+				vec_4(In.y[Index], Out.y[Index], In.x[Index], 0),
+				vec_4(In.z[Index], Out.z[Index], In.y[Index], 0),
+				vec_4(0, 0, 0, 1)
+			);
+			BatchOutput[Index] = TranslationMatrix(vec_3(Out.x[Index], Out.y[Index], Out.z[Index])) * Rotation *
+				                 ScalingMatrix(vec_3(1.0f, 1.0f, In.x[Index]));
+		}
+		Sink = BatchOutput[BENCH_BATCH_COUNT - 1].AsArray[0];
+	});
+
+	static f32 Ones[BENCH_BATCH_COUNT];
+	for (u32 Index = 0; Index < BENCH_BATCH_COUNT; Index++)
+	{
+		Ones[Index] = 1.0f;
+	}
+	soa_vec_3 Forward = { In.z, In.x, In.y };
+	soa_vec_3 Scale   = { Ones, Ones, In.x };
+	f64 BatchComposeNs = TimeBatch(50, [&]()
+	{
+		ComposeTransforms(Out, In, Out, Forward, Scale, BatchOutput, sizeof(mat_4), BENCH_BATCH_COUNT);
+		Sink = BatchOutput[BENCH_BATCH_COUNT - 1].AsArray[0];
+	});
+
+	printf("TransformPoints   : %.2f ns/point (per-point mat_4: %.2f, %.2fx)\n",
+		   BatchPointNs, ScalarPointNs, ScalarPointNs / BatchPointNs);
+	printf("ComposeTransforms : %.2f ns/matrix (T * R * S: %.2f, %.2fx)\n",
+		   BatchComposeNs, ScalarComposeNs, ScalarComposeNs / BatchComposeNs);
+}
+
+// The gizmo transform as entities.cpp built it before BuildGizmoTransforms, one vector at a time.
+inline static mat_4 ReferenceGizmo(vec_3 Origin, vec_3 Tip, vec_3 Rotation)
+{
+	vec_3 OriginToPoint      = Tip - Origin;
+	vec_3 Direction          = Normalize(OriginToPoint);
+	vec_3 DefaultOrientation = vec_3(0.0f, 0.0f, 1.0f);
+	affine_3x4 Scale         = ScalingAffine(vec_3(1.0f, 1.0f, VectorLength(OriginToPoint)));
+
+	if (AreEqual(Direction, DefaultOrientation))
+	{
+		DefaultOrientation = vec_3(0.0f, 1.0f, 0.0f);
+	}
+
+	vec_3 Right = Normalize(VectorProduct(DefaultOrientation, Direction));
+	vec_3 Up    = Normalize(VectorProduct(Direction, Right));
+
+	affine_3x4 ObjectRotation = affine_3x4(
+		vec_4(Right.x, Up.x, Direction.x, 0),
+		vec_4(Right.y, Up.y, Direction.y, 0),
+		vec_4(Right.z, Up.z, Direction.z, 0)
+	);
+	affine_3x4 EulerRotation = MatrixToAffine(QuatToMatrix(QuatFromEulerAngles(Rotation)));
+	affine_3x4 Translation   = TranslationAffine(Origin + OriginToPoint * 0.5f);
+
+	return AffineToMatrix(Translation * (ObjectRotation * EulerRotation) * Scale);
+}
+
+// Same layout as the gizmo instance data: the transform is followed by the color.
+struct gizmo_instance
+{
+	mat_4 Transform;
+	vec_4 Color;
+};
+
+constexpr u32 BENCH_GIZMO_COUNT     = 100000;
+constexpr f32 BENCH_GIZMO_TOLERANCE = 1e-4f;
+
+static f32 GizmoStreams[9][BENCH_GIZMO_COUNT];
+static gizmo_instance GizmoInstances[BENCH_GIZMO_COUNT];
+
+// Returns the largest difference with the scalar gizmo, over every matrix element.
+static f32 BenchGizmoTransforms()
+{
+	soa_vec_3 Origins   = { GizmoStreams[0], GizmoStreams[1], GizmoStreams[2] };
+	soa_vec_3 Tips      = { GizmoStreams[3], GizmoStreams[4], GizmoStreams[5] };
+	soa_vec_3 Rotations = { GizmoStreams[6], GizmoStreams[7], GizmoStreams[8] };
+	for (u32 Index = 0; Index < BENCH_GIZMO_COUNT; Index++)
+	{
+		Origins.x[Index]   = (f32)((Index * 7) % 101) * 0.1f - 5.0f;
+		Origins.y[Index]   = (f32)((Index * 13) % 89) * 0.1f - 4.0f;
+		Origins.z[Index]   = (f32)((Index * 3) % 53) * 0.1f - 2.5f;
+		Tips.x[Index]      = Origins.x[Index] + (f32)((Index * 11) % 61) * 0.1f - 3.0f;
+		Tips.y[Index]      = Origins.y[Index] + (f32)((Index * 5) % 47) * 0.1f - 2.2f;
+		Tips.z[Index]      = Origins.z[Index] + 0.5f + (f32)((Index * 17) % 37) * 0.1f;
+		Rotations.x[Index] = (f32)((Index * 19) % 360);
+		Rotations.y[Index] = (f32)((Index * 23) % 360);
+		Rotations.z[Index] = (f32)((Index * 29) % 360);
+
+		// Some vectors along +Z, which turn around +Y instead.
+		if (Index % 64 == 0)
+		{
+			Tips.x[Index] = Origins.x[Index];
+			Tips.y[Index] = Origins.y[Index];
+		}
+	}
+
+	f64 ScalarNs = TimeBatch(5, [&]()
+	{
+		for (u32 Index = 0; Index < BENCH_GIZMO_COUNT; Index++)
+		{
+			GizmoInstances[Index].Transform = ReferenceGizmo(vec_3(Origins.x[Index], Origins.y[Index], Origins.z[Index]),
+				                                             vec_3(Tips.x[Index], Tips.y[Index], Tips.z[Index]),
+				                                             vec_3(Rotations.x[Index], Rotations.y[Index], Rotations.z[Index]));
+		}
+		Sink = GizmoInstances[BENCH_GIZMO_COUNT - 1].Transform.AsArray[0];
+	});
+	f64 BatchNs = TimeBatch(20, [&]()
+	{
+		BuildGizmoTransforms(Origins, Tips, Rotations, &GizmoInstances[0].Transform, sizeof(gizmo_instance), BENCH_GIZMO_COUNT);
+		Sink = GizmoInstances[BENCH_GIZMO_COUNT - 1].Transform.AsArray[0];
+	});
+
+	// Checked from an odd offset so the SSE and scalar tails run too.
+	BuildGizmoTransforms(OffsetVectorStreams(Origins, 3), OffsetVectorStreams(Tips, 3), OffsetVectorStreams(Rotations, 3),
+		                 &GizmoInstances[3].Transform, sizeof(gizmo_instance), BENCH_GIZMO_COUNT - 3);
+
+	f32 MaxError = 0.0f;
+	for (u32 Index = 0; Index < BENCH_GIZMO_COUNT; Index++)
+	{
+		mat_4 Expected = ReferenceGizmo(vec_3(Origins.x[Index], Origins.y[Index], Origins.z[Index]),
+			                            vec_3(Tips.x[Index], Tips.y[Index], Tips.z[Index]),
+			                            vec_3(Rotations.x[Index], Rotations.y[Index], Rotations.z[Index]));
+		for (u32 Element = 0; Element < 16; Element++)
+		{
+			f32 Error = fabsf(Expected.AsArray[Element] - GizmoInstances[Index].Transform.AsArray[Element]);
+			MaxError  = Error > MaxError ? Error : MaxError;
+		}
+	}
+
+	// TimeBatch divides by BENCH_BATCH_COUNT.
+	f64 PerGizmo = (f64)BENCH_BATCH_COUNT / BENCH_GIZMO_COUNT;
+	printf("Gizmo transforms  : %.2f ns/gizmo, %.3f ms per %u (scalar: %.2f ns, %.2fx), max error %g\n",
+		   BatchNs * PerGizmo, BatchNs * BENCH_BATCH_COUNT * 1e-6, BENCH_GIZMO_COUNT, ScalarNs * PerGizmo,
+		   ScalarNs / BatchNs, MaxError);
+	return MaxError;
+}
+
+constexpr u32 BENCH_AXIS_LENGTH_COUNT = 1000 + 100;
+constexpr u32 BENCH_AXIS_GIZMO_COUNT  = 2 * BENCH_AXIS_LENGTH_COUNT + 1;
+
+static f32 AxisStreams[9][BENCH_AXIS_GIZMO_COUNT];
+static mat_4 AxisGizmos[BENCH_AXIS_GIZMO_COUNT];
+
+// Vectors exactly along +Z and -Z, which the random gizmos never hit: lengths 0.1 to 100 in 0.1
+// steps, then every whole length. The gizmo is then the identity basis, flipped on X and Z for -Z,
+// scaled on Z. Returns how many differ from it or are not finite. The count is odd, for the tails.
+static u32 CheckAxisGizmos()
+{
+	soa_vec_3 Origins   = { AxisStreams[0], AxisStreams[1], AxisStreams[2] };
+	soa_vec_3 Tips      = { AxisStreams[3], AxisStreams[4], AxisStreams[5] };
+	soa_vec_3 Rotations = { AxisStreams[6], AxisStreams[7], AxisStreams[8] };
+	for (u32 Index = 0; Index < BENCH_AXIS_GIZMO_COUNT; Index++)
+	{
+		u32 Step   = Index % BENCH_AXIS_LENGTH_COUNT;
+		f32 Length = Step < 1000 ? (f32)(Step + 1) * 0.1f : (f32)(Step - 999);
+		Tips.z[Index] = Index < BENCH_AXIS_LENGTH_COUNT || Index == BENCH_AXIS_GIZMO_COUNT - 1 ? Length : -Length;
+	}
+
+	BuildGizmoTransforms(Origins, Tips, Rotations, AxisGizmos, sizeof(mat_4), BENCH_AXIS_GIZMO_COUNT);
+
+	u32 Failures = 0;
+	for (u32 Index = 0; Index < BENCH_AXIS_GIZMO_COUNT; Index++)
+	{
+		f32 Z    = Tips.z[Index];
+		f32 Flip = Z < 0.0f ? -1.0f : 1.0f;
+		mat_4 Expected(vec_4(Flip, 0, 0, 0), vec_4(0, 1, 0, 0), vec_4(0, 0, Z, Z * 0.5f), vec_4(0, 0, 0, 1));
+
+		bool Matches = true;
+		for (u32 Element = 0; Element < 16; Element++)
+		{
+			f32 Actual = AxisGizmos[Index].AsArray[Element];
+			Matches   &= fabsf(Expected.AsArray[Element] - Actual) <= BENCH_GIZMO_TOLERANCE * fabsf(Z) + BENCH_GIZMO_TOLERANCE;
+		}
+		if (!Matches && Failures++ < 4)
+		{
+			printf("FAILED: gizmo of (0, 0, 0) -> (0, 0, %g) is wrong, row 2 is (%g, %g, %g, %g)\n", Z,
+				   AxisGizmos[Index].Rows[2].x, AxisGizmos[Index].Rows[2].y, AxisGizmos[Index].Rows[2].z, AxisGizmos[Index].Rows[2].w);
+		}
+	}
+	printf("Axis gizmos       : %u / %u wrong\n", Failures, BENCH_AXIS_GIZMO_COUNT);
+	return Failures;
+}
+
+int main()
+{
+	for (u32 Index = 0; Index < BENCH_MATRIX_COUNT; Index++)
+	{
+		f32 Angle     = (f32)Index;
+		Inputs[Index] = RotationMatrixFromEulerAngles(vec_3(Angle, Angle * 0.5f, Angle * 0.25f));
+	}
+
+	u32 Mismatches = 0;
+	for (u32 Index = 0; Index + 1 < BENCH_MATRIX_COUNT; Index++)
+	{
+		mat_4 Expected = ReferenceMultiply(Inputs[Index], Inputs[Index + 1]);
+		mat_4 Actual   = Inputs[Index] * Inputs[Index + 1];
+		Mismatches    += memcmp(&Expected, &Actual, sizeof(mat_4)) != 0;
+	}
+
+	// Translations with zeros and negative zeros, since those are where the summation order shows.
+	u32 AffineMismatches = 0;
+	for (u32 Index = 0; Index + 1 < BENCH_MATRIX_COUNT; Index++)
+	{
+		affine_3x4 Transform = MatrixToAffine(Inputs[Index]);
+		affine_3x4 Base      = MatrixToAffine(Inputs[Index + 1]);
+		for (u32 RowIndex = 0; RowIndex < AFFINE_ROW_COUNT; RowIndex++)
+		{
+			Transform[RowIndex].w = (Index + RowIndex) % 3 == 0 ? -0.0f : (f32)((Index * 7 + RowIndex) % 5) - 2.0f;
+			Base[RowIndex].w      = (f32)((Index * 3 + RowIndex) % 7) - 3.0f;
+		}
+
+		affine_3x4 Expected = ReferenceAffineMultiply(Transform, Base);
+		affine_3x4 Actual   = Transform * Base;
+		AffineMismatches   += memcmp(&Expected, &Actual, sizeof(affine_3x4)) != 0;
+	}
+
+	f64 ScalarNs = TimeMultiply([](mat_4 L, mat_4 R) { return ReferenceMultiply(L, R); });
+	f64 SimdNs   = TimeMultiply([](mat_4 L, mat_4 R) { return L * R; });
+
+	printf("Backend           : %s%s\n", MATH_BACKEND_NAME, MATH_SIMD_FMA ? " + FMA" : "");
+	printf("Bitwise mismatches: %u / %u\n", Mismatches, BENCH_MATRIX_COUNT - 1);
+	printf("Affine mismatches : %u / %u\n", AffineMismatches, BENCH_MATRIX_COUNT - 1);
+	printf("mat_4 * (scalar)  : %.2f ns/op\n", ScalarNs);
+	printf("mat_4 * (%-6s)  : %.2f ns/op\n", MATH_BACKEND_NAME, SimdNs);
+	printf("Speedup           : %.2fx\n", ScalarNs / SimdNs);
+
+	// With FMA the compiler decides which scalar products it fuses, so only the plain build is exact.
+	if (!MATH_SIMD_FMA && AffineMismatches != 0)
+	{
+		printf("FAILED: the affine multiply differs from the scalar one\n");
+		return 1;
+	}
+
+	f32 InverseError = BenchInverse();
+	if (!(InverseError <= BENCH_INVERSE_TOLERANCE))
+	{
+		printf("FAILED: Inverse(mat_4) differs from the scalar one by %g\n", InverseError);
+		return 1;
+	}
+
+	BenchBatchKernels();
+
+	f32 GizmoError = BenchGizmoTransforms();
+	if (!(GizmoError <= BENCH_GIZMO_TOLERANCE))
+	{
+		printf("FAILED: gizmo transforms differ from the scalar ones by %g\n", GizmoError);
+		return 1;
+	}
+	if (CheckAxisGizmos() != 0)
+	{
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,116 @@
+// Accuracy and speed of the fast-approximate math against libm. Built by the CMake project in this folder,
+// or directly: g++ -O2 -march=native -I../src precision_bench.cpp -o precision_bench
+// Add -DMATH_FAST_APPROX to also time the library paths (Normalize, RotationMatrixFromEulerAngles) in fast mode.
+
+#include <chrono>
+#include <math.h>
+
+#include "math/matrix.hpp"
+
+constexpr u32 SAMPLE_COUNT = 1 << 20;
+constexpr u32 REPEAT_COUNT = 20;
+
+static f32 Samples[SAMPLE_COUNT];
+static volatile f32 Sink;
+
+struct error_stats
+{
+	f64 MaxAbsolute;
+	f64 MaxRelative;
+};
+
+template <typename approx_fn, typename reference_fn>
+static error_stats MeasureError(approx_fn Approx, reference_fn Reference)
+{
+	error_stats Stats = {};
+	for (u32 Index = 0; Index < SAMPLE_COUNT; Index++)
+	{
+		f64 Expected = Reference((f64)Samples[Index]);
+		f64 Actual   = (f64)Approx(Samples[Index]);
+		f64 Absolute = fabs(Actual - Expected);
+
+		Stats.MaxAbsolute = Absolute > Stats.MaxAbsolute ? Absolute : Stats.MaxAbsolute;
+		if (fabs(Expected) > 1e-3)
+		{
+			f64 Relative      = Absolute / fabs(Expected);
+			Stats.MaxRelative = Relative > Stats.MaxRelative ? Relative : Stats.MaxRelative;
+		}
+	}
+	return Stats;
+}
+
+template <typename body_fn>
+static f64 TimePerSample(body_fn Body)
+{
+	auto Start = std::chrono::steady_clock::now();
+	for (u32 Repeat = 0; Repeat < REPEAT_COUNT; Repeat++)
+	{
+		f32 Sum = 0;
+		for (u32 Index = 0; Index < SAMPLE_COUNT; Index++)
+		{
+			Sum += Body(Samples[Index]);
+		}
+		Sink = Sum;
+	}
+	auto End = std::chrono::steady_clock::now();
+	return std::chrono::duration<f64, std::nano>(End - Start).count() / ((f64)REPEAT_COUNT * SAMPLE_COUNT);
+}
+
+template <typename exact_fn, typename fast_fn, typename reference_fn>
+static void Compare(const char* Name, exact_fn Exact, fast_fn Fast, reference_fn Reference)
+{
+	error_stats ExactError = MeasureError(Exact, Reference);
+	error_stats FastError  = MeasureError(Fast, Reference);
+	f64         ExactNs    = TimePerSample(Exact);
+	f64         FastNs     = TimePerSample(Fast);
+
+	printf("%-12s | exact %6.2f ns, abs %.2e, rel %.2e | fast %6.2f ns, abs %.2e, rel %.2e | %.2fx\n",
+		   Name, ExactNs, ExactError.MaxAbsolute, ExactError.MaxRelative,
+		   FastNs, FastError.MaxAbsolute, FastError.MaxRelative, ExactNs / FastNs);
+}
+
+static void FillSamples(f32 Min, f32 Max)
+{
+	u32 State = 0x12345678;
+	for (u32 Index = 0; Index < SAMPLE_COUNT; Index++)
+	{
+		State          = State * 1664525u + 1013904223u;
+		f32 Unit       = (f32)(State >> 8) / (f32)(1 << 24);
+		Samples[Index] = Min + (Max - Min) * Unit;
+	}
+}
+
+int main()
+{
+	printf("Backend: %s, policy: %s\n", MATH_BACKEND_NAME, MATH_PRECISION_NAME);
+
+	FillSamples(-1000.0f, 1000.0f);
+	Compare("sin", [](f32 x) { return sinf(x); }, [](f32 x) { return FastSin(x); }, [](f64 x) { return sin(x); });
+	Compare("cos", [](f32 x) { return cosf(x); }, [](f32 x) { return FastCos(x); }, [](f64 x) { return cos(x); });
+
+	FillSamples(-1.5f, 1.5f);
+	Compare("tan", [](f32 x) { return tanf(x); }, [](f32 x) { return FastTan(x); }, [](f64 x) { return tan(x); });
+
+	FillSamples(1e-6f, 1e6f);
+	Compare("1/sqrt", [](f32 x) { return 1.0f / sqrtf(x); }, [](f32 x) { return FastInvSqrt(x); },
+		    [](f64 x) { return 1.0 / sqrt(x); });
+
+	// Normalize is measured on the x component of (x, 1, 2).
+	FillSamples(-100.0f, 100.0f);
+	Compare("normalize",
+		    [](f32 x)
+		    {
+			    f32 Length = sqrtf(x * x + 5.0f);
+			    return vec_3(x / Length, 1.0f / Length, 2.0f / Length).x;
+		    },
+		    [](f32 x) { return FastNormalize(vec_3(x, 1, 2)).x; },
+		    [](f64 x) { return x / sqrt(x * x + 5.0); });
+
+	FillSamples(-360.0f, 360.0f);
+	f64 RotationNs = TimePerSample([](f32 x) { return RotationMatrixFromEulerAngles(vec_3(x, x * 0.5f, x * 0.25f)).AsArray[0]; });
+	f64 NormalizeNs = TimePerSample([](f32 x) { return Normalize(vec_3(x, 1, 2)).x; });
+	printf("%-12s | %s policy: %.2f ns\n", "euler matrix", MATH_PRECISION_NAME, RotationNs);
+	printf("%-12s | %s policy: %.2f ns\n", "Normalize", MATH_PRECISION_NAME, NormalizeNs);
+
+	return 0;
+}
\ No newline at end of file
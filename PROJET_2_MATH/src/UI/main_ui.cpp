@@ -40,7 +40,7 @@ static void RenderSimulationUI()
     ImGui::Text("Simulation");
     ImGui::BeginChild("Simulation", ImVec2(0, 0), true);
     RenderCalculatorUI(&SimulationUI.Calculator, &SimulationUI.VectorStorage);
-    RenderPhysicsSimulationUI(&SimulationUI.Physics);
+    RenderPhysicsSimulationUI(&SimulationUI.Physics, &SimulationUI.VectorStorage);
     ImGui::EndChild();
 
     ImGui::End();
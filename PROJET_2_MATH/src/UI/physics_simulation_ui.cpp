@@ -1,24 +1,30 @@
 struct physics_simulation_ui
 {
     bool ApplyGravity     = false;
-    simulation_cube* Cube = nullptr;
-    vector_ui*        ForceVector;
+    cube_handle      Cube = POOL_HANDLE_NONE;
+    vector_handle    ForceVector = POOL_HANDLE_NONE;
 };
 
-static void RenderPhysicsSimulationUI(physics_simulation_ui* PhysicsSimulation)
+static void RenderPhysicsSimulationUI(physics_simulation_ui* PhysicsSimulation, vectors_storage_ui* VectorStorage)
 {
-    if (!PhysicsSimulation->Cube)
+    simulation_cube* Cube = GetSimulationCube(PhysicsSimulation->Cube);
+    if (!Cube)
     {
         PhysicsSimulation->Cube = CreateSimulationCube(vec_3(1.0f, 0.5f, 1.0f));
+        Cube                    = GetSimulationCube(PhysicsSimulation->Cube);
+        if (!Cube)
+        {
+            return;
+        }
     }
 
     ImGui::SeparatorText("Simulation physique");
 
     ImGui::BeginChild("ForceVectorTarget", ImVec2(140, 30), true);
     {
-        if (PhysicsSimulation->ForceVector)
+        if (vector_ui* ForceVectorUI = GetVectorUI(VectorStorage, PhysicsSimulation->ForceVector))
         {
-            ImGui::Text("%s", PhysicsSimulation->ForceVector->Label);
+            ImGui::Text("%s", ForceVectorUI->Label);
         }
         else
         {
@@ -29,8 +35,8 @@ static void RenderPhysicsSimulationUI(physics_simulation_ui* PhysicsSimulation)
         {
             if (const ImGuiPayload* Payload = ImGui::AcceptDragDropPayload("VECTOR_UI"))
             {
-                IM_ASSERT(Payload->DataSize == sizeof(vector_ui*));
-                PhysicsSimulation->ForceVector = *(vector_ui**)Payload->Data;
+                IM_ASSERT(Payload->DataSize == sizeof(vector_handle));
+                PhysicsSimulation->ForceVector = *(vector_handle*)Payload->Data;
             }
             ImGui::EndDragDropTarget();
         }
@@ -47,52 +53,55 @@ static void RenderPhysicsSimulationUI(physics_simulation_ui* PhysicsSimulation)
         ImGui::TableSetColumnIndex(0);
         ImGui::Text("Puissance:");
         ImGui::TableSetColumnIndex(1);
-        ImGui::InputFloat("##ForceMagnitude", &PhysicsSimulation->Cube->ForceMagnitude);
+        ImGui::InputFloat("##ForceMagnitude", &Cube->ForceMagnitude);
 
         ImGui::TableNextRow();
         ImGui::TableSetColumnIndex(0);
         ImGui::Text("Gravite:");
         ImGui::TableSetColumnIndex(1);
-        ImGui::Checkbox("##ApplyGravity", &PhysicsSimulation->Cube->AffectedByGravity);
+        ImGui::Checkbox("##ApplyGravity", &Cube->AffectedByGravity);
 
         ImGui::TableNextRow();
         ImGui::TableSetColumnIndex(0);
         ImGui::Text("Simulation:");
         ImGui::TableSetColumnIndex(1);
-        if (ImGui::Button("Simuler le cube", ImVec2(150, 25)) && PhysicsSimulation->ForceVector)
+        simulation_vector* ForceVector = GetSimulationVector(PhysicsSimulation->ForceVector);
+        if (ImGui::Button("Simuler le cube", ImVec2(150, 25)) && ForceVector)
         { 
-            vec_3 ForceToApply = PhysicsSimulation->ForceVector->Vector->Direction;
-            ApplyPushForce(PhysicsSimulation->Cube, ForceToApply);
+            vec_3 ForceToApply = ForceVector->Direction;
+            ApplyPushForce(Cube, ForceToApply);
 
-            PhysicsSimulation->Cube->IsBeingSimulated = true;
+            Cube->IsBeingSimulated = true;
         }
 
         ImGui::TableNextRow();
         ImGui::TableSetColumnIndex(0);
         ImGui::Text("Simulation:");
         ImGui::TableSetColumnIndex(1);
-        if (ImGui::Button("Reinitialiser le cube", ImVec2(150, 25)) && PhysicsSimulation->Cube->IsBeingSimulated)
+        if (ImGui::Button("Reinitialiser le cube", ImVec2(150, 25)) && Cube->IsBeingSimulated)
         {
-            StopCubeSimulation(PhysicsSimulation->Cube);
+            StopCubeSimulation(Cube);
         }
 
         ImGui::TableNextRow();
         ImGui::TableSetColumnIndex(0);
         ImGui::Text("Position:");
         ImGui::TableSetColumnIndex(1);
-        ImGui::Text("(%f, %f, %f)", PhysicsSimulation->Cube->Position.x, PhysicsSimulation->Cube->Position.y, PhysicsSimulation->Cube->Position.z);
+        vec_3_f64 Position = VectorCast<f64>(Cube->Position);
+        ImGui::Text("(%f, %f, %f)", Position.x, Position.y, Position.z);
 
         ImGui::TableNextRow();
         ImGui::TableSetColumnIndex(0);
         ImGui::Text("Velocite:");
         ImGui::TableSetColumnIndex(1);
-        ImGui::Text("(%f, %f, %f)", PhysicsSimulation->Cube->Velocity.x, PhysicsSimulation->Cube->Velocity.y, PhysicsSimulation->Cube->Velocity.z);
+        vec_3_f64 Velocity = VectorCast<f64>(Cube->Velocity);
+        ImGui::Text("(%f, %f, %f)", Velocity.x, Velocity.y, Velocity.z);
 
         ImGui::TableNextRow();
         ImGui::TableSetColumnIndex(0);
         ImGui::Text("Masse:");
         ImGui::TableSetColumnIndex(1);
-        ImGui::InputFloat("##CubeMass", &PhysicsSimulation->Cube->Mass);
+        ImGui::InputFloat("##CubeMass", &Cube->Mass);
 
         ImGui::EndTable();
     }
@@ -1,15 +1,3 @@
-enum OPERATION_TYPE
-{
-    OPERATION_ADDITION,
-    OPERATION_SUBTRACTION,
-    OPERATION_VECTOR_PRODUCT,
-    OPERATION_SCALING,
-    OPERATION_VECTOR_PROJECTION,
-    OPERATION_PLANE_PROJECTION,
-
-    OPERATION_TYPE_COUNT
-};
-
 enum PLANES_TYPE
 {
     XY_PLANE,
@@ -32,9 +20,9 @@ struct vector_calculator_ui
 {
     bool       IsInitialized;
 
-    vector_ui* LeftVector;
-    vector_ui* RightVector;
-    f32        Scalar;
+    vector_handle LeftVector;
+    vector_handle RightVector;
+    f32           Scalar;
 
     u32                CurrentCalculator;
     calculator_info_ui CalculatorInfos[OPERATION_TYPE_COUNT];
@@ -118,9 +106,9 @@ static void RenderCalculatorUI(vector_calculator_ui* VectorCalculator, vectors_s
 
         ImGui::BeginChild(LeftDropTarget, ImVec2(140, 30), true);
         {
-            if (VectorCalculator->LeftVector)
+            if (vector_ui* LeftVectorUI = GetVectorUI(VectorStorage, VectorCalculator->LeftVector))
             {
-                ImGui::Text("%s", VectorCalculator->LeftVector->Label);
+                ImGui::Text("%s", LeftVectorUI->Label);
             }
             else
             {
@@ -131,8 +119,8 @@ static void RenderCalculatorUI(vector_calculator_ui* VectorCalculator, vectors_s
             {
                 if (const ImGuiPayload* Payload = ImGui::AcceptDragDropPayload("VECTOR_UI"))
                 {
-                    IM_ASSERT(Payload->DataSize == sizeof(vector_ui*));
-                    VectorCalculator->LeftVector = *(vector_ui**)Payload->Data;
+                    IM_ASSERT(Payload->DataSize == sizeof(vector_handle));
+                    VectorCalculator->LeftVector = *(vector_handle*)Payload->Data;
                 }
                 ImGui::EndDragDropTarget();
             }
@@ -188,9 +176,9 @@ static void RenderCalculatorUI(vector_calculator_ui* VectorCalculator, vectors_s
 
             ImGui::BeginChild(RightDropTarget, ImVec2(140, 30), true);
             {
-                if (VectorCalculator->RightVector)
+                if (vector_ui* RightVectorUI = GetVectorUI(VectorStorage, VectorCalculator->RightVector))
                 {
-                    ImGui::Text("%s", VectorCalculator->RightVector->Label);
+                    ImGui::Text("%s", RightVectorUI->Label);
                 }
                 else
                 {
@@ -201,8 +189,8 @@ static void RenderCalculatorUI(vector_calculator_ui* VectorCalculator, vectors_s
                 {
                     if (const ImGuiPayload* Payload = ImGui::AcceptDragDropPayload("VECTOR_UI"))
                     {
-                        IM_ASSERT(Payload->DataSize == sizeof(vector_ui*));
-                        VectorCalculator->RightVector = *(vector_ui**)Payload->Data;
+                        IM_ASSERT(Payload->DataSize == sizeof(vector_handle));
+                        VectorCalculator->RightVector = *(vector_handle*)Payload->Data;
                     }
                     ImGui::EndDragDropTarget();
                 }
@@ -215,17 +203,18 @@ static void RenderCalculatorUI(vector_calculator_ui* VectorCalculator, vectors_s
 
     ImGui::SameLine();
 
+    simulation_vector* LeftVector  = GetSimulationVector(VectorCalculator->LeftVector);
+    simulation_vector* RightVector = GetSimulationVector(VectorCalculator->RightVector);
+
     bool ValidOutput       = false;
-    bool ValidLeftVector   = VectorCalculator->LeftVector ? true : false;
-    bool ValidRightVector  = VectorCalculator->RightVector ? true : false;
+    bool ValidLeftVector   = LeftVector ? true : false;
+    bool ValidRightVector  = RightVector ? true : false;
     bool ValidScalar       = VectorCalculator->Scalar != 0 ? true : false;
     bool IsPlaneProjection = CalculatorInfo->OpType == OPERATION_PLANE_PROJECTION
                                                        ? true : false;
     
     if (ValidLeftVector && ValidRightVector)
     {
-        simulation_vector* LeftVector = VectorCalculator->LeftVector->Vector;
-        simulation_vector* RightVector = VectorCalculator->RightVector->Vector;
         vec_3 Destination = vec_3();
         vec_3 Origin = vec_3();
 
@@ -278,7 +267,7 @@ static void RenderCalculatorUI(vector_calculator_ui* VectorCalculator, vectors_s
 
     if (ValidLeftVector && ValidScalar)
     {
-        simulation_vector* Vector = VectorCalculator->LeftVector->Vector;
+        simulation_vector* Vector = LeftVector;
 
         vec_3 WorldVector = Vector->Direction - Vector->Origin;
 
@@ -290,7 +279,7 @@ static void RenderCalculatorUI(vector_calculator_ui* VectorCalculator, vectors_s
 
     if (ValidLeftVector && IsPlaneProjection)
     {
-        simulation_vector* Vector = VectorCalculator->LeftVector->Vector;
+        simulation_vector* Vector = LeftVector;
 
         vec_3 WorldVector = Vector->Direction - Vector->Origin;
         vec_3 Projected   = ProjectVectorOnPlane(WorldVector, VectorCalculator->PlaneNormal);
@@ -316,8 +305,8 @@ static void RenderCalculatorUI(vector_calculator_ui* VectorCalculator, vectors_s
         CalculatorInfo->OutputOrigin    = vec_3();
         memcpy(CalculatorInfo->OutputLabel, "Vecteur sans nom.", 18);
         
-        VectorCalculator->LeftVector  = nullptr;
-        VectorCalculator->RightVector = nullptr;
+        VectorCalculator->LeftVector  = POOL_HANDLE_NONE;
+        VectorCalculator->RightVector = POOL_HANDLE_NONE;
     }
 
     ImGui::Text("=== Resultat ===");
@@ -1,7 +1,7 @@
 struct vector_ui
 {
-    char Label[64] = {};
-    simulation_vector* Vector;
+    char Label[64]       = {};
+    vector_handle Vector = POOL_HANDLE_NONE;
 };
 
 struct vector_state_change
@@ -23,17 +23,107 @@ struct external_vector_ui
 {
     bool Initialized          = false;
     char Label[64]            = {};
-    simulation_vector* Vector = nullptr;
+    vector_handle Vector      = POOL_HANDLE_NONE;
 };
 
+// Les autres panneaux gardent le handle du vecteur plutot qu'un pointeur: un vecteur supprime est
+// remplace par le dernier de la liste, et Slots, indexe comme le pool de vecteurs, dit ou il est.
+// Les deux tableaux ont Capacity elements et grandissent sur place, comme ceux des entites.
 struct vectors_storage_ui
 {
+    bool      Initialized             = false;
     u32       Count                   = 0;
-    vector_ui Vectors[MAX_VECTORS]    = {};
+    u32       Capacity                = 0;
+    vector_ui* Vectors                = nullptr;
+    u32*      Slots                   = nullptr;
+    bump_allocator VectorsArena       = {};
+    bump_allocator SlotsArena         = {};
     new_vector_ui NewVector           = {};
     external_vector_ui ExternalVector = {};
 };
 
+// nullptr si le vecteur a ete supprime.
+static vector_ui* GetVectorUI(vectors_storage_ui* VectorStorage, vector_handle Handle)
+{
+    u32 Index = Handle & POOL_INDEX_MASK;
+    if (Handle == POOL_HANDLE_NONE || Index >= VectorStorage->Capacity)
+    {
+        return nullptr;
+    }
+
+    u32 Slot = VectorStorage->Slots[Index];
+    if (Slot >= VectorStorage->Count || VectorStorage->Vectors[Slot].Vector != Handle)
+    {
+        return nullptr;
+    }
+    return &VectorStorage->Vectors[Slot];
+}
+
+// Fait de la place pour Required vecteurs et index du pool. Chaque tableau a sa propre arene, reservee
+// pour tout le pool: elle grandit sur place, rien n'est copie.
+static bool ReserveVectorUI(vectors_storage_ui* VectorStorage, u32 Required)
+{
+    u32 OldCapacity = VectorStorage->Capacity;
+    u32 Capacity    = GrowInstanceCapacity(OldCapacity, Required);
+    if (Capacity == OldCapacity)
+    {
+        return true;
+    }
+
+    if (OldCapacity == 0)
+    {
+        VectorStorage->VectorsArena = CreateBumpAllocator(0, BUMP_RESIZABLE, "Vectors UI", 2, POOL_MAX_COUNT * sizeof(vector_ui));
+        VectorStorage->SlotsArena   = CreateBumpAllocator(0, BUMP_RESIZABLE, "Vectors UI", 2, POOL_MAX_COUNT * sizeof(u32));
+        VectorStorage->Vectors      = RCAST(vector_ui*, VectorStorage->VectorsArena.Memory);
+        VectorStorage->Slots        = RCAST(u32*, VectorStorage->SlotsArena.Memory);
+    }
+    if (!GrowInPlace(Capacity * sizeof(vector_ui), &VectorStorage->VectorsArena) ||
+        !GrowInPlace(Capacity * sizeof(u32), &VectorStorage->SlotsArena))
+    {
+        return false;
+    }
+
+    for (u32 Slot = OldCapacity; Slot < Capacity; Slot++)
+    {
+        VectorStorage->Vectors[Slot] = vector_ui();
+        VectorStorage->Slots[Slot]   = 0;
+    }
+    VectorStorage->Capacity = Capacity;
+    return true;
+}
+
+static void AddVectorUI(vectors_storage_ui* VectorStorage, vector_handle Handle, const char* Label)
+{
+    u32 Index    = Handle & POOL_INDEX_MASK;
+    u32 Required = VectorStorage->Count + 1 > Index + 1 ? VectorStorage->Count + 1 : Index + 1;
+    if (Handle == POOL_HANDLE_NONE || !ReserveVectorUI(VectorStorage, Required))
+    {
+        return;
+    }
+
+    u32 Slot            = VectorStorage->Count;
+    vector_ui* VectorUI = &VectorStorage->Vectors[Slot];
+    VectorUI->Vector    = Handle;
+    strncpy_s(VectorUI->Label, Label, sizeof(VectorUI->Label) - 1);
+    VectorUI->Label[sizeof(VectorUI->Label) - 1] = '\0';
+
+    VectorStorage->Slots[Index] = Slot;
+    VectorStorage->Count++;
+}
+
+static void DeleteVectorUI(vectors_storage_ui* VectorStorage, u32 Slot)
+{
+    DestroySimulationVector(VectorStorage->Vectors[Slot].Vector);
+
+    u32 LastSlot                     = --VectorStorage->Count;
+    VectorStorage->Vectors[Slot]     = VectorStorage->Vectors[LastSlot];
+    VectorStorage->Vectors[LastSlot] = vector_ui();
+    if (Slot != LastSlot)
+    {
+        VectorStorage->Slots[VectorStorage->Vectors[Slot].Vector & POOL_INDEX_MASK] = Slot;
+    }
+}
+
 static vector_state_change ShowVectorMenu(vec_4* OutColor, vec_3* OutOrigin, vec_3* OutDirection,
                                           vec_3* OutRotation, char* OutName, size_t OutNameSize, bool Sliders)
 {
@@ -122,39 +212,27 @@ static void RenderVectorStorageUI(vectors_storage_ui* VectorStorage)
 {
 
     // Initialisation du UI
-    if (VectorStorage->Count == 0)
+    if (!VectorStorage->Initialized)
     {
-        vector_ui XAxis = {};
-        XAxis.Vector    = CreateSimulationVector(vec_3(0.0f, 0.0f, 0.0f), vec_3(1.0f, 0.0f, 0.0f), vec_4(1.0f, 0.0f, 0.0f, 1.0f));;
-        CreateVectorEntity(XAxis.Vector);
-        memcpy(XAxis.Label, "Axe X", 6);
-
-        vector_ui YAxis = {};
-        YAxis.Vector    = CreateSimulationVector(vec_3(), vec_3(0.0f, 1.0f, 0.0f), vec_4(0.0f, 1.0f, 0.0f, 1.0f));
-        CreateVectorEntity(YAxis.Vector);
-        memcpy(YAxis.Label, "Axe Y", 6);
-
-        vector_ui ZAxis = {};
-        ZAxis.Vector    = CreateSimulationVector(vec_3(), vec_3(0.0f, 0.0f, 1.0f), vec_4(0.0f, 0.0f, 1.0f, 1.0f));
-        CreateVectorEntity(ZAxis.Vector);
-        memcpy(ZAxis.Label, "Axe Z", 6);
-
-        VectorStorage->Vectors[0] = XAxis;
-        VectorStorage->Vectors[1] = YAxis;
-        VectorStorage->Vectors[2] = ZAxis;
-        VectorStorage->Count      = 3;
+        vector_handle XAxis = CreateSimulationVector(vec_3(0.0f, 0.0f, 0.0f), vec_3(1.0f, 0.0f, 0.0f), vec_4(1.0f, 0.0f, 0.0f, 1.0f));
+        CreateVectorEntity(XAxis);
+        AddVectorUI(VectorStorage, XAxis, "Axe X");
+
+        vector_handle YAxis = CreateSimulationVector(vec_3(), vec_3(0.0f, 1.0f, 0.0f), vec_4(0.0f, 1.0f, 0.0f, 1.0f));
+        CreateVectorEntity(YAxis);
+        AddVectorUI(VectorStorage, YAxis, "Axe Y");
+
+        vector_handle ZAxis = CreateSimulationVector(vec_3(), vec_3(0.0f, 0.0f, 1.0f), vec_4(0.0f, 0.0f, 1.0f, 1.0f));
+        CreateVectorEntity(ZAxis);
+        AddVectorUI(VectorStorage, ZAxis, "Axe Z");
+
+        VectorStorage->Initialized = true;
     }
 
     // Creer un vecteur a partir d'un autre vecteur creer a l'exterieur de ce systeme.
     if (VectorStorage->ExternalVector.Initialized)
     {
-        u32 Index = VectorStorage->Count;
-        VectorStorage->Count++;
-
-        vector_ui* VectorUI = &VectorStorage->Vectors[Index];
-        VectorUI->Vector    = VectorStorage->ExternalVector.Vector;
-        memcpy(VectorUI->Label, VectorStorage->ExternalVector.Label, sizeof(VectorUI->Label));
-
+        AddVectorUI(VectorStorage, VectorStorage->ExternalVector.Vector, VectorStorage->ExternalVector.Label);
         VectorStorage->ExternalVector.Initialized = false;
     }
 
@@ -179,13 +257,9 @@ static void RenderVectorStorageUI(vectors_storage_ui* VectorStorage)
         {
             if (CanCreateVector())
             {
-                vector_ui* V = &VectorStorage->Vectors[VectorStorage->Count];
-                VectorStorage->Count++;
-
-                V->Vector = CreateSimulationVector(VectorStorage->NewVector.Origin, VectorStorage->NewVector.Direction, VectorStorage->NewVector.Color);
-                CreateVectorEntity(V->Vector);
-                strncpy_s(V->Label, VectorStorage->NewVector.Name, sizeof(V->Label) - 1);
-                V->Label[sizeof(V->Label) - 1] = '\0';
+                vector_handle Vector = CreateSimulationVector(VectorStorage->NewVector.Origin, VectorStorage->NewVector.Direction, VectorStorage->NewVector.Color);
+                CreateVectorEntity(Vector);
+                AddVectorUI(VectorStorage, Vector, VectorStorage->NewVector.Name);
             }
 
             VectorStorage->NewVector = new_vector_ui();
@@ -201,18 +275,19 @@ static void RenderVectorStorageUI(vectors_storage_ui* VectorStorage)
         ImGui::EndPopup();
     }
 
-    // Montre les vecteurs dans une liste
+    // Montre les vecteurs dans une liste. L'ID vient du handle: il suit le vecteur quand la liste change.
+    u32 DeletedIndex = VectorStorage->Count;
     for (u32 Index = 0; Index < VectorStorage->Count; Index++)
     {
         vector_ui* VecUI = &VectorStorage->Vectors[Index];
 
         char TreeLabel[128];
-        snprintf(TreeLabel, sizeof(TreeLabel), "%s##%d", VecUI->Label, Index);
+        snprintf(TreeLabel, sizeof(TreeLabel), "%s##%u", VecUI->Label, VecUI->Vector);
 
         bool NodeIsOpen = ImGui::TreeNodeEx(TreeLabel, ImGuiTreeNodeFlags_SpanAvailWidth);
         if (ImGui::BeginDragDropSource())
         {
-            ImGui::SetDragDropPayload("VECTOR_UI", &VecUI, sizeof(vector_ui*));
+            ImGui::SetDragDropPayload("VECTOR_UI", &VecUI->Vector, sizeof(vector_handle));
             ImGui::TextUnformatted(VecUI->Label);
             ImGui::EndDragDropSource();
         }
@@ -224,18 +299,32 @@ static void RenderVectorStorageUI(vectors_storage_ui* VectorStorage)
 
             ImGui::PushStyleVar(ImGuiStyleVar_CellPadding, ImVec2(2, 2));
 
-            simulation_vector* Vector       = VecUI->Vector;
-            vector_state_change VectorState = ShowVectorMenu(&Vector->Color, &Vector->Origin, &Vector->Direction,
-                                                             &Vector->Rotation, nullptr, 0, true);
-
-            if (VectorState.PositionChanged)
+            simulation_vector* Vector = GetSimulationVector(VecUI->Vector);
+            if (Vector)
             {
-                UpdateVectorPosition(VecUI->Vector);
-            }
-
-            if (VectorState.ColorChanged)
-            {
-                UpdateVectorColor(VecUI->Vector);
+                vector_state_change VectorState = ShowVectorMenu(&Vector->Color, &Vector->Origin, &Vector->Direction,
+                                                                 &Vector->Rotation, nullptr, 0, true);
+
+                if (VectorState.PositionChanged)
+                {
+                    UpdateVectorPosition(Vector);
+                }
+
+                if (VectorState.ColorChanged)
+                {
+                    UpdateVectorColor(Vector);
+                }
+
+                bool AttachedToCube = IsVectorAttachedToCube(Vector);
+                if (ImGui::Checkbox("Attacher au cube", &AttachedToCube))
+                {
+                    AttachVectorToCube(Vector, AttachedToCube);
+                }
+
+                if (ImGui::Button("Supprimer"))
+                {
+                    DeletedIndex = Index;
+                }
             }
 
             ImGui::PopStyleVar();
@@ -244,5 +333,11 @@ static void RenderVectorStorageUI(vectors_storage_ui* VectorStorage)
         }
     }
 
+    // Apres la boucle: la suppression deplace le dernier vecteur de la liste.
+    if (DeletedIndex < VectorStorage->Count)
+    {
+        DeleteVectorUI(VectorStorage, DeletedIndex);
+    }
+
     ImGui::EndChild();
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "math/vector.hpp"
 #include "math/matrix.hpp"
+#include "math/frustum.hpp"
 
 struct dx11_projection_camera
 {
@@ -24,6 +25,14 @@ struct dx11_projection_camera
 	mat_4 ViewMatrix;
 	mat_4 Projection;
 
+	// Recomputed only when the view or the projection changes.
+	mat_4 ViewProjection;
+	mat_4 InverseViewProjection;
+
+	// Planes of ViewProjection. FrustumVersion changes with them, so culled lists know when to rebuild.
+	frustum Frustum;
+	u32     FrustumVersion;
+
 	ID3D11Buffer* Buffer;
 };
 
@@ -38,12 +47,27 @@ struct camera_frame_data
 };
 
 
+static void UpdateCameraViewProjection()
+{
+	Camera.ViewProjection        = Camera.Projection * Camera.ViewMatrix;
+	Camera.InverseViewProjection = Inverse(Camera.ViewProjection);
+	Camera.Frustum               = ExtractFrustumPlanes(Camera.ViewProjection);
+	Camera.FrustumVersion       += 1;
+}
+
+// NDC point (x, y in [-1, 1]) back to world space, through the cached inverse.
+static vec_3 UnprojectFromNDC(vec_3 NDCPoint)
+{
+	vec_3 WorldPoint = TransformProjectedPoint(Camera.InverseViewProjection, NDCPoint);
+	return WorldPoint;
+}
+
 static vec_3 ComputeCameraDirection(f32 Yaw, f32 Pitch)
 {
 	vec_3 Direction;
-	Direction.x = cosf(Yaw) * cosf(Pitch);
-	Direction.y = sinf(Pitch);
-	Direction.z = sinf(Yaw) * cosf(Pitch);
+	Direction.x = Cosine(Yaw) * Cosine(Pitch);
+	Direction.y = Sine(Pitch);
+	Direction.z = Sine(Yaw) * Cosine(Pitch);
 	return Normalize(Direction);
 }
 
@@ -108,6 +132,8 @@ static void InitializeCamera(f32 AspectRatio, f32 FovDegree, vec_3 CameraPositio
 	Camera.ViewMatrix  = View;
 	Camera.Projection  = Projection;
 	Camera.Pos         = CameraPosition;
+
+	UpdateCameraViewProjection();
 }
 
 static camera_frame_data BuildCameraFrameData()
@@ -214,6 +240,8 @@ static bool UpdateProjectionCamera()
 		vec_3 FocusPoint  = Camera.Pos + Camera.Direction;
 		Camera.ViewMatrix = FocusMatrix(Camera.Up, Camera.Pos, FocusPoint);
 		Camera.Projection = ProjectionMatrix(Camera.FOV, Camera.AspectRatio, Camera.NearPlane, Camera.FarPlane);
+
+		UpdateCameraViewProjection();
 	}
 
 	return ShouldUpdate;
@@ -10,11 +10,14 @@
 #include "math/matrix.hpp"
 #include "utility/types.h"
 #include "utility/allocators.h"
+#include "utility/ring_allocator.h"
+#include "utility/instance_capacity.h"
 
 enum UPDATE_RESOURCE_TYPE : u16
 {
 	UPDATE_RESOURCE_NONE = 1 << 0,
 
+	// For instance buffers: sets the instance count, reallocating only when it outgrows the capacity.
 	UPDATE_RESOURCE_RECREATE = 1 << 1,
 	UPDATE_RESOURCE_DISCARD = 1 << 2,
 	UPDATE_RESOURCE_NO_DISCARD = 1 << 3,
@@ -24,6 +27,8 @@ struct mesh_info
 {
 	bump_allocator VertexBuffer;
 	bump_allocator IndexBuffer;
+	u32            VertexCount;
+	u32            IndexCount;
 };
 
 struct render_pipeline
@@ -99,6 +104,14 @@ struct instance_buffer
 	ID3D11ShaderResourceView* SRV;
 	u32 Stride;
 	u32 Count;
+	u32 Capacity;
+};
+
+// Instances First to First + Count - 1 of an instance buffer.
+struct instance_range
+{
+	u32 First;
+	u32 Count;
 };
 
 // TODO: Define max for these
@@ -125,20 +138,23 @@ struct backend_state
 	ID3D11DepthStencilView* DepthAndStencil;
 	render_pipeline* LastState;
 
-	ID3D11Buffer* VertexBuffer;
-	ID3D11Buffer* IndexBuffer;
+	ID3D11Buffer*  UploadBuffer;
+	ring_allocator UploadRing;
+	u32            UploadWrapCount;
+	bool           UploadDiscard;
 
 	resource_manager Resources;
 	draw_list DrawList;
-
-	u64 IndexBufferSize;
-	u64 VertexBufferSize;
 };
 
 
 
 static backend_state Backend;
 
+constexpr u32    DX11_FRAMES_IN_FLIGHT = 3;
+constexpr size_t UPLOAD_ALIGNMENT      = 16;
+constexpr size_t UPLOAD_MIN_SIZE       = Megabytes(SCAST(size_t, 1));
+
 #include "directx/dx11_camera.cpp"
 #include "directx/dx11_shaders.cpp"
 
@@ -171,14 +187,17 @@ static mesh_info* LoadMesh(const char* MeshPath)
 	u32 VertexDataSize = Header.DataSize;
 	u32 IndexBufferSize = AllocationSize - VertexDataSize;
 
+	Mesh->VertexCount = VertexDataSize / sizeof(draw_vertex);
+	Mesh->IndexCount  = IndexBufferSize / sizeof(u32);
+
 	Mesh->VertexBuffer = CreateBumpAllocator(VertexDataSize);
-	Mesh->VertexBuffer.At = VertexDataSize;
+	draw_vertex* Vertices = PushArray<draw_vertex>(Mesh->VertexCount, &Mesh->VertexBuffer);
 
 	Mesh->IndexBuffer = CreateBumpAllocator(IndexBufferSize);
-	Mesh->IndexBuffer.At = IndexBufferSize;
+	u32* Indices = PushArray<u32>(Mesh->IndexCount, &Mesh->IndexBuffer);
 
-	fread(Mesh->VertexBuffer.Memory, 1, VertexDataSize, File);
-	fread(Mesh->IndexBuffer.Memory, 1, IndexBufferSize, File);
+	fread(Vertices, sizeof(draw_vertex), Mesh->VertexCount, File);
+	fread(Indices, sizeof(u32), Mesh->IndexCount, File);
 
 	return Mesh;
 }
@@ -295,47 +314,79 @@ static u32 CreateObjectResource(void* Resource, size_t ResourceSize)
 	return Key;
 }
 
-static u32 CreateInstancedResource(u32 InstanceCount, void* Resource, size_t SizePerInstance)
+// Allocates room for Capacity instances of Stride bytes, and the view the shaders read them with.
+// Instance buffers are DEFAULT buffers written with UpdateSubresource, so a part of one can be
+// rewritten while the draws of the previous frames, still queued, read it: the runtime copies the
+// data aside and the GPU applies it after them. Mapping the buffer in place would race with them.
+static void CreateInstanceBuffer(instance_buffer* InstanceBuffer, u32 Capacity, u32 Stride)
 {
-	u32              ResourceSize   = InstanceCount * SizePerInstance;;
-	u32              Key            = Backend.Resources.InstanceResourceCount;
-	instance_buffer* InstanceBuffer = &Backend.Resources.InstanceDataBuffers[Key];
+	ASSERT(Capacity > 0, "An instance buffer needs room for at least one instance.");
 
 	D3D11_BUFFER_DESC Desc   = {};
-	Desc.Usage               = D3D11_USAGE_DYNAMIC;
-	Desc.ByteWidth           = ResourceSize;
+	Desc.Usage               = D3D11_USAGE_DEFAULT;
+	Desc.ByteWidth           = Capacity * Stride;
 	Desc.BindFlags           = D3D11_BIND_SHADER_RESOURCE;
-	Desc.CPUAccessFlags      = D3D11_CPU_ACCESS_WRITE;
+	Desc.CPUAccessFlags      = 0;
 	Desc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
-	Desc.StructureByteStride = SizePerInstance;
+	Desc.StructureByteStride = Stride;
 
 	ASSERT(SUCCEEDED(Backend.Device->CreateBuffer(&Desc, nullptr, &InstanceBuffer->Buffer)),
 		   "Failed to create a resource. Memory corruption?");
 
-	D3D11_MAPPED_SUBRESOURCE InitialData = {};
-	ASSERT(SUCCEEDED(Backend.ImmediateContext->Map(InstanceBuffer->Buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &InitialData)),
-		  "Failed to map the buffer. Memory corruption?");
-
-	memcpy(InitialData.pData, Resource, ResourceSize);
-	Backend.ImmediateContext->Unmap(InstanceBuffer->Buffer, 0);
-
 	D3D11_SHADER_RESOURCE_VIEW_DESC SRVDesc = {};
 	SRVDesc.Format                          = DXGI_FORMAT_UNKNOWN;
 	SRVDesc.ViewDimension                   = D3D11_SRV_DIMENSION_BUFFER;
 	SRVDesc.Buffer.FirstElement             = 0;
-	SRVDesc.Buffer.NumElements              = InstanceCount;
+	SRVDesc.Buffer.NumElements              = Capacity;
 
 	ASSERT(SUCCEEDED(Backend.Device->CreateShaderResourceView(InstanceBuffer->Buffer, &SRVDesc, &InstanceBuffer->SRV)),
 		   "Failed to create a SRV for an instance buffer.");
 
-	InstanceBuffer->Stride = SizePerInstance; 
-	InstanceBuffer->Count  = InstanceCount;
+	InstanceBuffer->Stride   = Stride;
+	InstanceBuffer->Capacity = Capacity;
+}
+
+static void ReleaseInstanceBuffer(instance_buffer* InstanceBuffer)
+{
+	SAFE_RELEASE(InstanceBuffer->SRV);
+	SAFE_RELEASE(InstanceBuffer->Buffer);
+	InstanceBuffer->Capacity = 0;
+}
+
+// Writes Size bytes of Data at Offset in the buffer.
+static void WriteInstanceBytes(instance_buffer* InstanceBuffer, const void* Data, size_t Offset, size_t Size)
+{
+	ASSERT(Offset + Size <= SCAST(size_t, InstanceBuffer->Capacity) * InstanceBuffer->Stride, "Writing past the end of an instance buffer.");
+
+	D3D11_BOX Box = {};
+	Box.left      = SCAST(UINT, Offset);
+	Box.right     = SCAST(UINT, Offset + Size);
+	Box.bottom    = 1;
+	Box.back      = 1;
+	Backend.ImmediateContext->UpdateSubresource(InstanceBuffer->Buffer, 0, &Box, Data, 0, 0);
+}
+
+static void WriteInstances(instance_buffer* InstanceBuffer, void* Resource, u32 InstanceCount)
+{
+	WriteInstanceBytes(InstanceBuffer, Resource, 0, SCAST(size_t, InstanceCount) * InstanceBuffer->Stride);
+}
+
+static u32 CreateInstancedResource(u32 InstanceCount, void* Resource, size_t SizePerInstance)
+{
+	u32              Key            = Backend.Resources.InstanceResourceCount;
+	instance_buffer* InstanceBuffer = &Backend.Resources.InstanceDataBuffers[Key];
+
+	CreateInstanceBuffer(InstanceBuffer, GrowInstanceCapacity(0, InstanceCount > 0 ? InstanceCount : 1), SizePerInstance);
+	WriteInstances(InstanceBuffer, Resource, InstanceCount);
+	InstanceBuffer->Count = InstanceCount;
 
 	Backend.Resources.InstanceResourceCount++;
 
 	return Key;
 }
 
+// With UPDATE_RESOURCE_RECREATE, ResourceSize is the size of one instance and Resource, when not
+// null, holds ResourceCount of them.
 static void UpdateInstanceData(u32 InstanceResourceKey, void* Resource, size_t ResourceSize,
 	                           u32 ResourceCount, size_t ResourceOffset, u16 UpdateFlags)
 {
@@ -343,75 +394,74 @@ static void UpdateInstanceData(u32 InstanceResourceKey, void* Resource, size_t R
 
 	if (UpdateFlags & UPDATE_RESOURCE_RECREATE)
 	{
-		if (InstanceBuffer->Buffer)
+		u32 SizePerInstance = ResourceSize;
+		if (InstanceBuffer->Buffer && InstanceBuffer->Stride != SizePerInstance)
 		{
-			InstanceBuffer->Buffer->Release();
+			ReleaseInstanceBuffer(InstanceBuffer);
 		}
-		if (InstanceBuffer->SRV)
+
+		u32 Capacity = GrowInstanceCapacity(InstanceBuffer->Capacity, ResourceCount > 0 ? ResourceCount : 1);
+		if (!InstanceBuffer->Buffer || Capacity != InstanceBuffer->Capacity)
 		{
-			InstanceBuffer->SRV->Release();
+			ReleaseInstanceBuffer(InstanceBuffer);
+			CreateInstanceBuffer(InstanceBuffer, Capacity, SizePerInstance);
 		}
 
-		u32 SizePerInstance = ResourceSize;
-		u32 ByteWidth       = ResourceCount * SizePerInstance;
-
-		D3D11_BUFFER_DESC Desc = {};
-		Desc.Usage = D3D11_USAGE_DYNAMIC;
-		Desc.ByteWidth = ByteWidth;
-		Desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-		Desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-		Desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
-		Desc.StructureByteStride = SizePerInstance;
-
-		ASSERT(SUCCEEDED(Backend.Device->CreateBuffer(&Desc, nullptr, &InstanceBuffer->Buffer)),
-			   "Failed to create a resource. Memory corruption?");
-
-		D3D11_MAPPED_SUBRESOURCE InitialData = {};
-		ASSERT(SUCCEEDED(Backend.ImmediateContext->Map(InstanceBuffer->Buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &InitialData)),
-			   "Failed to map the buffer. Memory corruption?");
-
-		memcpy(InitialData.pData, Resource, ByteWidth);
-		Backend.ImmediateContext->Unmap(InstanceBuffer->Buffer, 0);
-
-		D3D11_SHADER_RESOURCE_VIEW_DESC SRVDesc = {};
-		SRVDesc.Format = DXGI_FORMAT_UNKNOWN;
-		SRVDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
-		SRVDesc.Buffer.FirstElement = 0;
-		SRVDesc.Buffer.NumElements = ResourceCount;
-
-		ASSERT(SUCCEEDED(Backend.Device->CreateShaderResourceView(InstanceBuffer->Buffer, &SRVDesc, &InstanceBuffer->SRV)),
-			   "Failed to create a SRV for an instance buffer.");
-
-		InstanceBuffer->Stride = ResourceSize;
+		if (Resource && ResourceCount > 0)
+		{
+			WriteInstances(InstanceBuffer, Resource, ResourceCount);
+		}
 		InstanceBuffer->Count = ResourceCount;
 	}
 	else if (UpdateFlags & UPDATE_RESOURCE_DISCARD)
 	{
 		ASSERT(InstanceBuffer->Buffer, "NO BUFFER BOUND FOR UPDATE RESOURCE WITH KEY: %d", InstanceResourceKey);
 
-		D3D11_MAPPED_SUBRESOURCE InstanceData = {};
-		HRESULT Status = Backend.ImmediateContext->Map(InstanceBuffer->Buffer, 0, D3D11_MAP_WRITE_DISCARD,
-			                                           0, &InstanceData);
-
-		ASSERT(SUCCEEDED(Status), "FAILED TO MAP AN INSTANCE BUFFER WITH KEY: %d", InstanceResourceKey);
-
-		u32 BufferWidth = InstanceBuffer->Count * InstanceBuffer->Stride;
-		memcpy((char*)InstanceData.pData, Resource, BufferWidth);
-		Backend.ImmediateContext->Unmap(InstanceBuffer->Buffer, 0);
+		WriteInstances(InstanceBuffer, Resource, InstanceBuffer->Count);
 	}
 	else if (UpdateFlags & UPDATE_RESOURCE_NO_DISCARD)
 	{
 		ASSERT(InstanceBuffer->Buffer, "NO BUFFER BOUND FOR UPDATE RESOURCE WITH KEY: %d", InstanceResourceKey);
 
-		D3D11_MAPPED_SUBRESOURCE InstanceData = {};
-		HRESULT Status = Backend.ImmediateContext->Map(InstanceBuffer->Buffer, 0, D3D11_MAP_WRITE_NO_OVERWRITE,
-			                                           0, &InstanceData);
+		WriteInstanceBytes(InstanceBuffer, Resource, ResourceOffset, ResourceSize);
+	}
+}
+
+// Rewrites only Ranges of an instance buffer, the rest keeps its content, and draws InstanceCount
+// instances, e.g. one less once the last one moved into a removed one. Resource holds the whole
+// list, so a range is read and written at the same offset. Each range is one UpdateSubresource.
+static void UpdateInstanceRanges(u32 InstanceResourceKey, void* Resource, const instance_range* Ranges, u32 RangeCount,
+	                             u32 InstanceCount)
+{
+	instance_buffer* InstanceBuffer = &Backend.Resources.InstanceDataBuffers[InstanceResourceKey];
 
-		ASSERT(SUCCEEDED(Status), "FAILED TO MAP AN INSTANCE BUFFER WITH KEY: %d", InstanceResourceKey);
+	ASSERT(InstanceBuffer->Buffer, "NO BUFFER BOUND FOR UPDATE RESOURCE WITH KEY: %d", InstanceResourceKey);
+	ASSERT(InstanceCount <= InstanceBuffer->Capacity, "TOO MANY INSTANCES FOR THE BUFFER WITH KEY: %d", InstanceResourceKey);
 
-		memcpy((char*)InstanceData.pData + ResourceOffset, Resource, ResourceSize);
-		Backend.ImmediateContext->Unmap(InstanceBuffer->Buffer, 0);
+	for (u32 Index = 0; Index < RangeCount; Index++)
+	{
+		size_t Offset = SCAST(size_t, Ranges[Index].First) * InstanceBuffer->Stride;
+		WriteInstanceBytes(InstanceBuffer, (char*)Resource + Offset, Offset, SCAST(size_t, Ranges[Index].Count) * InstanceBuffer->Stride);
 	}
+	InstanceBuffer->Count = InstanceCount;
+}
+
+// Replaces the content of an instance buffer with a compacted list (e.g. the visible instances)
+// and draws that many. The buffer keeps its capacity; VisibleCount must fit in it.
+static void UpdateVisibleInstances(u32 InstanceResourceKey, void* Resource, u32 VisibleCount)
+{
+	instance_buffer* InstanceBuffer = &Backend.Resources.InstanceDataBuffers[InstanceResourceKey];
+
+	ASSERT(InstanceBuffer->Buffer, "NO BUFFER BOUND FOR UPDATE RESOURCE WITH KEY: %d", InstanceResourceKey);
+	ASSERT(VisibleCount <= InstanceBuffer->Capacity, "TOO MANY INSTANCES FOR THE BUFFER WITH KEY: %d", InstanceResourceKey);
+
+	InstanceBuffer->Count = VisibleCount;
+	if (VisibleCount == 0)
+	{
+		return;
+	}
+
+	WriteInstances(InstanceBuffer, Resource, VisibleCount);
 }
 
 static void UpdateObjectData(u32 ResourceKey, void* Resource, size_t ResourceSize, u16 UpdateFlags)
@@ -499,6 +549,19 @@ static void InitializeRendererBackend(u32 Width, u32 Height, u32 FrameRate, HWND
 		&Backend.ImmediateContext
 	);
 
+	// D3D11 has no fences here: the upload ring releases the oldest frame once DX11_FRAMES_IN_FLIGHT
+	// are pending (BeginRingFrame). That is only safe if Present never lets the CPU get more than
+	// DX11_FRAMES_IN_FLIGHT - 1 frames ahead of the GPU, so the queue is capped to that.
+	IDXGIDevice1* DXGIDevice = nullptr;
+	Status = Backend.Device->QueryInterface(__uuidof(IDXGIDevice1), (void**)&DXGIDevice);
+	ASSERT(SUCCEEDED(Status), "Failed to initialize backend.");
+	if (SUCCEEDED(Status))
+	{
+		Status = DXGIDevice->SetMaximumFrameLatency(DX11_FRAMES_IN_FLIGHT - 1);
+		ASSERT(SUCCEEDED(Status), "Failed to initialize backend.");
+		DXGIDevice->Release();
+	}
+
 	D3D11_TEXTURE2D_DESC DepthStencilDesc = { 0 };
 	DepthStencilDesc.Width = (UINT)Width;
 	DepthStencilDesc.Height = (UINT)Height;
@@ -559,10 +622,10 @@ static void PushDrawCommand(u32 ObjectResourceKey, u32 InstancedDataKey, mesh_in
 	                        render_pipeline* Pipeline)
 {
 	draw_list* List      = &Backend.DrawList;
-	u32 IndexOffset      = List->IndexBuffer.At / sizeof(u32);
-	u32 AttributesOffset = List->VertexBuffer.At / sizeof(draw_vertex);
-	u32 IndexCount       = GetElementsCount(&Info->IndexBuffer, sizeof(u32));
-	u32 VertexCount      = GetElementsCount(&Info->VertexBuffer, sizeof(draw_vertex));
+	u32 IndexOffset      = List->FrameIndexCount;
+	u32 AttributesOffset = List->FrameVertexCount;
+	u32 IndexCount       = Info->IndexCount;
+	u32 VertexCount      = Info->VertexCount;
 
 	draw_command Command    = {};
 	Command.ElementCount    = IndexCount;
@@ -572,102 +635,131 @@ static void PushDrawCommand(u32 ObjectResourceKey, u32 InstancedDataKey, mesh_in
 	Command.InstanceDataKey = InstancedDataKey;
 	Command.Pipeline        = Pipeline;
 
-	PushAndCopy(sizeof(draw_command), &Command                , &List->CommandBuffer);
-	PushAndCopy(Info->IndexBuffer.At , Info->IndexBuffer.Memory , &List->IndexBuffer);
-	PushAndCopy(Info->VertexBuffer.At, Info->VertexBuffer.Memory, &List->VertexBuffer);
+	u32*          Indices  = PushArray<u32>(IndexCount, &List->IndexBuffer);
+	draw_vertex*  Vertices = PushArray<draw_vertex>(VertexCount, &List->VertexBuffer);
+	draw_command* Commands = PushStruct<draw_command>(&List->CommandBuffer);
+	ASSERT(Indices && Vertices && Commands, "Draw list is out of memory.");
+
+	memcpy(Indices , Info->IndexBuffer.Memory , IndexCount * sizeof(u32));
+	memcpy(Vertices, Info->VertexBuffer.Memory, VertexCount * sizeof(draw_vertex));
+	*Commands = Command;
 
 	List->FrameIndexCount  += IndexCount;
 	List->FrameVertexCount += VertexCount;
 }
 
-static void RenderAppFrame()
+// Runs before the scene updates, so the frustum they cull against is this frame's.
+static void UpdateCameraFrame()
 {
-	draw_list* List        = &Backend.DrawList;
-
-	if (!Backend.VertexBuffer || Backend.VertexBufferSize < List->FrameVertexCount)
+	if (!ImGui::GetIO().WantCaptureMouse)
 	{
-		if (Backend.VertexBuffer)
-		{ 
-			Backend.VertexBuffer->Release();
-			Backend.VertexBuffer = nullptr;
+		bool ShouldUpdateCamera = UpdateProjectionCamera();
+		if (ShouldUpdateCamera)
+		{
+			// TODO: Use the function for verbosity
+			D3D11_MAPPED_SUBRESOURCE MappedData = {};
+			HRESULT Status = Backend.ImmediateContext->Map(Camera.Buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &MappedData);
+			if (SUCCEEDED(Status))
+			{
+				shared_object_data SharedData = {};
+				SharedData.View = Camera.ViewMatrix;
+				SharedData.Projection = Camera.Projection;
+
+				memcpy(MappedData.pData, &SharedData, sizeof(shared_object_data));
+				Backend.ImmediateContext->Unmap(Camera.Buffer, 0);
+			}
 		}
+	}
+}
 
-		Backend.VertexBufferSize = List->FrameVertexCount + 500;
+// The frame's vertices and indices share one dynamic buffer, bound as both vertex and index
+// buffer and sub-allocated as a ring: one Map per frame, and the data of the frames still in
+// flight stays untouched.
+static bool CreateUploadBuffer(size_t Size)
+{
+	SAFE_RELEASE(Backend.UploadBuffer);
 
-		D3D11_BUFFER_DESC Desc = {};
-		Desc.Usage             = D3D11_USAGE_DYNAMIC;
-		Desc.ByteWidth         = Backend.VertexBufferSize * sizeof(draw_vertex);
-		Desc.BindFlags         = D3D11_BIND_VERTEX_BUFFER;
-		Desc.CPUAccessFlags    = D3D11_CPU_ACCESS_WRITE;
+	D3D11_BUFFER_DESC Desc = {};
+	Desc.Usage             = D3D11_USAGE_DYNAMIC;
+	Desc.ByteWidth         = SCAST(UINT, Size);
+	Desc.BindFlags         = D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_INDEX_BUFFER;
+	Desc.CPUAccessFlags    = D3D11_CPU_ACCESS_WRITE;
 
-		if (Backend.Device->CreateBuffer(&Desc, nullptr, &Backend.VertexBuffer) < 0)
-		{
-			return;
-		}
+	if (FAILED(Backend.Device->CreateBuffer(&Desc, nullptr, &Backend.UploadBuffer)))
+	{
+		return false;
 	}
 
-	if (!Backend.IndexBuffer || Backend.IndexBufferSize < List->FrameIndexCount)
-	{
-		if (Backend.IndexBuffer)
-		{
-			Backend.IndexBuffer->Release();
-			Backend.IndexBuffer = nullptr;
-		}
+	// The pending frames keep the old buffer alive until the GPU is done with them.
+	Backend.UploadRing    = CreateRingAllocator(Size, DX11_FRAMES_IN_FLIGHT);
+	Backend.UploadDiscard = true;
+	return true;
+}
+
+static bool AllocateFrameUploads(size_t VertexBytes, size_t IndexBytes, size_t* VertexOffset, size_t* IndexOffset)
+{
+	ring_allocator* Ring = &Backend.UploadRing;
+	BeginRingFrame(Ring);
 
-		Backend.IndexBufferSize = List->FrameIndexCount + 500;
+	*VertexOffset = RingAllocate(Ring, VertexBytes, UPLOAD_ALIGNMENT);
+	*IndexOffset  = RingAllocate(Ring, IndexBytes, UPLOAD_ALIGNMENT);
 
-		D3D11_BUFFER_DESC Desc = {};
-		Desc.Usage             = D3D11_USAGE_DYNAMIC;
-		Desc.ByteWidth         = Backend.IndexBufferSize * sizeof(u32);
-		Desc.BindFlags         = D3D11_BIND_INDEX_BUFFER;
-		Desc.CPUAccessFlags    = D3D11_CPU_ACCESS_WRITE;
+	if (!Backend.UploadBuffer || *VertexOffset == RING_ALLOCATION_FAILED || *IndexOffset == RING_ALLOCATION_FAILED)
+	{
+		// Room for twice the frames in flight at this size, so the ring does not grow again right away.
+		size_t FrameBytes = VertexBytes + IndexBytes + 2 * UPLOAD_ALIGNMENT;
+		size_t Size       = 2 * DX11_FRAMES_IN_FLIGHT * FrameBytes;
+		Size              = Size > 2 * Ring->Size ? Size : 2 * Ring->Size;
+		Size              = Size > UPLOAD_MIN_SIZE ? Size : UPLOAD_MIN_SIZE;
 
-		if (Backend.Device->CreateBuffer(&Desc, nullptr, &Backend.IndexBuffer) < 0)
+		if (!CreateUploadBuffer(Size))
 		{
-			return;
+			return false;
 		}
+
+		*VertexOffset = RingAllocate(Ring, VertexBytes, UPLOAD_ALIGNMENT);
+		*IndexOffset  = RingAllocate(Ring, IndexBytes, UPLOAD_ALIGNMENT);
 	}
 
-	D3D11_MAPPED_SUBRESOURCE VertexResource = {};
-	if (Backend.ImmediateContext->Map(Backend.VertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &VertexResource) != S_OK)
+	return EndRingFrame(Ring);
+}
+
+static void RenderAppFrame()
+{
+	draw_list* List        = &Backend.DrawList;
+
+	size_t VertexBytes  = List->FrameVertexCount * sizeof(draw_vertex);
+	size_t IndexBytes   = List->FrameIndexCount * sizeof(u32);
+	size_t VertexOffset = 0;
+	size_t IndexOffset  = 0;
+
+	if (!AllocateFrameUploads(VertexBytes, IndexBytes, &VertexOffset, &IndexOffset))
 	{
 		return;
 	}
-	memcpy(VertexResource.pData, List->VertexBuffer.Memory, List->VertexBuffer.At);
-	Backend.ImmediateContext->Unmap(Backend.VertexBuffer, 0);
 
-	D3D11_MAPPED_SUBRESOURCE IndexResource = {};
-	if (Backend.ImmediateContext->Map(Backend.IndexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &IndexResource) != S_OK)
+	// Between wraps the frame only writes where no pending frame reads, so the buffer is mapped as
+	// is. After a wrap it is discarded anyway: all this frame reads is written below, and the
+	// rename keeps the driver from ever waiting on the GPU for it.
+	bool      Discard = Backend.UploadDiscard || Backend.UploadRing.WrapCount != Backend.UploadWrapCount;
+	D3D11_MAP MapType = Discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+
+	D3D11_MAPPED_SUBRESOURCE UploadResource = {};
+	if (Backend.ImmediateContext->Map(Backend.UploadBuffer, 0, MapType, 0, &UploadResource) != S_OK)
 	{
 		return;
 	}
-	memcpy(IndexResource.pData, List->IndexBuffer.Memory, List->IndexBuffer.At);
-	Backend.ImmediateContext->Unmap(Backend.IndexBuffer, 0);
-
-	u32 Stride = sizeof(draw_vertex);
-	u32 Offset = 0;
-	Backend.ImmediateContext->IASetVertexBuffers(0, 1, &Backend.VertexBuffer, &Stride, &Offset);
-	Backend.ImmediateContext->IASetIndexBuffer(Backend.IndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	memcpy((char*)UploadResource.pData + VertexOffset, List->VertexBuffer.Memory, VertexBytes);
+	memcpy((char*)UploadResource.pData + IndexOffset, List->IndexBuffer.Memory, IndexBytes);
+	Backend.ImmediateContext->Unmap(Backend.UploadBuffer, 0);
 
-	if (!ImGui::GetIO().WantCaptureMouse)
-	{
-		bool ShouldUpdateCamera = UpdateProjectionCamera();
-		if (ShouldUpdateCamera)
-		{
-			// TODO: Use the function for verbosity
-			D3D11_MAPPED_SUBRESOURCE MappedData = {};
-			HRESULT Status = Backend.ImmediateContext->Map(Camera.Buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &MappedData);
-			if (SUCCEEDED(Status))
-			{
-				shared_object_data SharedData = {};
-				SharedData.View = Camera.ViewMatrix;
-				SharedData.Projection = Camera.Projection;
+	Backend.UploadDiscard   = false;
+	Backend.UploadWrapCount = Backend.UploadRing.WrapCount;
 
-				memcpy(MappedData.pData, &SharedData, sizeof(shared_object_data));
-				Backend.ImmediateContext->Unmap(Camera.Buffer, 0);
-			}
-		}
-	}
+	u32 Stride = sizeof(draw_vertex);
+	u32 Offset = SCAST(u32, VertexOffset);
+	Backend.ImmediateContext->IASetVertexBuffers(0, 1, &Backend.UploadBuffer, &Stride, &Offset);
+	Backend.ImmediateContext->IASetIndexBuffer(Backend.UploadBuffer, DXGI_FORMAT_R32_UINT, SCAST(u32, IndexOffset));
 
 	const f32 ClearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
 	Backend.ImmediateContext->ClearRenderTargetView(Backend.RenderTargetView, ClearColor);
@@ -675,7 +767,7 @@ static void RenderAppFrame()
 	Backend.ImmediateContext->VSSetConstantBuffers(SHARED_OBJECT_DATA_SLOT, 1, &Camera.Buffer);
 
 	render_pipeline* LastPipeline = Backend.LastState;
-	u32              CommandCount = List->CommandBuffer.At / sizeof(draw_command);
+	u32              CommandCount = List->CommandBuffer.Size;
 
 	for (u32 CommandIndex = 0; CommandIndex < CommandCount; CommandIndex++)
 	{
@@ -701,6 +793,13 @@ static void RenderAppFrame()
 			ID3D11ShaderResourceView* SRV   = InstanceBuffer->SRV;
 			InstanceCount                   = InstanceBuffer->Count;
 
+			// Everything culled: nothing to draw, and a plain draw would read instance 0.
+			if (InstanceCount == 0)
+			{
+				LastPipeline = Command->Pipeline;
+				continue;
+			}
+
 			Backend.ImmediateContext->VSSetShaderResources(INSTANCE_DATA_SLOT, 1, &SRV);
 		}
 		
@@ -719,9 +818,9 @@ static void RenderAppFrame()
 	ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
 	Backend.SwapChain->Present(0, 0);
 	
-	ClearAllocator(&List->VertexBuffer);
-	ClearAllocator(&List->IndexBuffer);
-	ClearAllocator(&List->CommandBuffer);
+	ResetAllocator(&List->VertexBuffer);
+	ResetAllocator(&List->IndexBuffer);
+	ResetAllocator(&List->CommandBuffer);
 
 	List->FrameIndexCount  = 0;
 	List->FrameVertexCount = 0;
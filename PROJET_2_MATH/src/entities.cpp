@@ -1,22 +1,64 @@
 #include "math/matrix.hpp"
+#include "math/quaternion.hpp"
+#include "math/batch.hpp"
+#include "math/frustum.hpp"
+#include "math/simulation.hpp"
 #include "utility/allocators.h"
+#include "utility/pool_allocator.h"
+#include "utility/instance_capacity.h"
+#include "transform_hierarchy.cpp"
 #include <chrono>  // For the cube's shader
 
 constexpr auto MAX_CUBE_COUNT = 1;
-constexpr auto CONSTANT_DELTA_TIME = 0.030f;
+
+constexpr vec_3 CUBE_DEFAULT_POSITION = vec_3(1.5f, 0.5f, 1.5f);
+constexpr mat_4 CUBE_DEFAULT_TRANSFORM = TranslationMatrix(CUBE_DEFAULT_POSITION);
+
+// Radius of the debug_vector_base mesh around its axis.
+constexpr f32 VECTOR_GIZMO_RADIUS = 0.025f;
+
+// Above this fraction of dirty visible gizmos, the whole instance buffer is uploaded again instead
+// of the dirty ranges. Entity_manager.VectorFullUploadFraction starts with it.
+constexpr f32 VECTOR_FULL_UPLOAD_FRACTION = 0.5f;
+
+// The instance has no slot in the instance buffer: it was culled or not uploaded yet.
+constexpr u32 VECTOR_SLOT_NONE = 0xFFFFFFFF;
+
+// The per-vector arrays, each in its own arena. The three streams take three arrays each.
+enum VECTOR_ARRAY
+{
+    VECTOR_ARRAY_ORIGINS             = 0,
+    VECTOR_ARRAY_TIPS                = 3,
+    VECTOR_ARRAY_ROTATIONS           = 6,
+    VECTOR_ARRAY_DIRTY_VECTOR_BITS   = 9,
+    VECTOR_ARRAY_DIRTY_INSTANCE_BITS,
+    VECTOR_ARRAY_UPLOADED_VISIBLE,
+    VECTOR_ARRAY_UPLOADED_SLOTS,
+    VECTOR_ARRAY_INSTANCES,
+
+    VECTOR_ARRAY_COUNT
+};
 
 struct simulation_cube
 {
     u32   InstanceIndex;
+    transform_id Transform;
     f32   Mass;
     f32   ForceMagnitude;
-    vec_3 Position;
-    vec_3 Velocity;
-    vec_3 ForceApplied;
+    vec_3_sim Position;
+    vec_3_sim Velocity;
+    vec_3     ForceApplied;
     bool  AffectedByGravity;
     bool  IsBeingSimulated;
 };
 
+// Vectors and cubes live in pools and are referred to by handle. GetSimulationVector and
+// GetSimulationCube return nullptr once the entity is gone, so the UI never keeps a stale pointer.
+typedef pool_handle vector_handle;
+typedef pool_handle cube_handle;
+
+// The copy the UI edits. UpdateVectorPosition mirrors it into the Entity_manager's streams, indexed
+// by instance index, which the gizmo rebuild reads.
 struct simulation_vector
 {
     vec_3 Origin;
@@ -24,6 +66,7 @@ struct simulation_vector
     vec_3 Rotation;
     vec_4 Color;
     u32   InstanceIndex;
+    transform_id Transform;
 };
 
 struct vector_instance_data
@@ -32,6 +75,15 @@ struct vector_instance_data
     vec_4 Color;
 };
 
+// Bytes of culling scratch per vector: the centers, radii, visible indices, the visible instance
+// data and the upload ranges.
+constexpr size_t VECTOR_CULLING_BYTES = 4 * sizeof(f32) + sizeof(u32) + sizeof(vector_instance_data) + sizeof(instance_range);
+
+// Vectors the instance and culling data hold before growing. A session with 80 vectors peaked at
+// 6400 bytes of instance data and 8000 of culling scratch (allocator_telemetry.json), past the
+// 2 KB the instance data started with.
+constexpr u32 VECTOR_INITIAL_COUNT = 128;
+
 struct cube_instance_data
 {
     mat_4 Transform;
@@ -53,14 +105,28 @@ struct Entity_manager
     u32              VectorInstanceResourceKey;
     bump_allocator   VectorInstanceData;
     u16              VectorUpdateTypes;
+    bump_allocator   VectorCullingData;
+    u32              CulledFrustumVersion;
+    u64*             DirtyVectorBits;
+    u64*             DirtyInstanceBits;
+    u32*             UploadedVisible;
+    u32*             UploadedSlots;
+    u32              UploadedVisibleCount;
+    bool             UploadedVisibleValid;
+    f32              VectorFullUploadFraction;
+    u32              VectorCapacity;
+    bump_allocator   VectorArrays[VECTOR_ARRAY_COUNT];
+    soa_vec_3        VectorOrigins;
+    soa_vec_3        VectorTips;
+    soa_vec_3        VectorRotations;
+    pool_allocator   VectorPool;
+    vector_handle*   VectorInstances;
 
     render_pipeline* CubePipeline;
     mesh_info* CubeMesh;
     u32              CubeResourceKey;
-    u32              CubesCount;
-    simulation_cube  Cube;
-
-    simulation_vector Vectors[MAX_VECTORS];
+    pool_allocator   CubePool;
+    cube_handle      Cube;
 };
 
 static Entity_manager EntityManager;
@@ -69,161 +135,355 @@ auto StartTime = std::chrono::steady_clock::now();
 // -----------------
 // Vector Functions
 // -----------------
-static simulation_vector* CreateSimulationVector(vec_3 Origin, vec_3 Direction, vec_4 Color)
+static simulation_vector* GetSimulationVector(vector_handle Handle)
 {
-    u32 Index = EntityManager.VectorEntitysCount;
-    if (Index < MAX_VECTORS)
+    return GetPoolElement<simulation_vector>(&EntityManager.VectorPool, Handle);
+}
+
+// How many more vectors CreateSimulationVector and CreateSimulationVectors accept: the pool's
+// handles are the only limit.
+static inline u32 GetVectorRoomLeft()
+{
+    return EntityManager.VectorPool.MaxCount - EntityManager.VectorEntitysCount;
+}
+
+static inline bool CanCreateVector()
+{
+    return GetVectorRoomLeft() > 0;
+}
+
+static inline size_t GetVectorBitsSize(u32 Capacity)
+{
+    return (Capacity + 63) / 64 * sizeof(u64);
+}
+
+// Every per-vector array has its own BUMP_RESIZABLE arena, reserved for as many vectors as the pool
+// can hold. Growing commits pages after the array: no array moves and nothing is copied, so the
+// pointers in the Entity_manager are set once.
+static void* CreateVectorArray(u32 ArrayIndex, size_t MaxSize)
+{
+    bump_allocator* Arena = &EntityManager.VectorArrays[ArrayIndex];
+    *Arena                = CreateBumpAllocator(0, BUMP_RESIZABLE, "Vector Arrays", 2, MaxSize);
+    return Arena->Memory;
+}
+
+static void CreateVectorArrays()
+{
+    u32 ArrayIndex       = 0;
+    soa_vec_3* Streams[] = { &EntityManager.VectorOrigins, &EntityManager.VectorTips, &EntityManager.VectorRotations };
+    for (soa_vec_3* Stream : Streams)
     {
-        EntityManager.VectorEntitysCount += 1;
-        simulation_vector* Vector = &EntityManager.Vectors[Index];
-        Vector->Origin            = Origin;
-        Vector->Direction         = Direction;
-        Vector->Color             = Color;
-        Vector->InstanceIndex     = Index;
-        return Vector;
+        Stream->x = SCAST(f32*, CreateVectorArray(ArrayIndex++, POOL_MAX_COUNT * sizeof(f32)));
+        Stream->y = SCAST(f32*, CreateVectorArray(ArrayIndex++, POOL_MAX_COUNT * sizeof(f32)));
+        Stream->z = SCAST(f32*, CreateVectorArray(ArrayIndex++, POOL_MAX_COUNT * sizeof(f32)));
     }
-    return &EntityManager.Vectors[MAX_VECTORS - 1];
+
+    EntityManager.DirtyVectorBits   = SCAST(u64*, CreateVectorArray(ArrayIndex++, GetVectorBitsSize(POOL_MAX_COUNT)));
+    EntityManager.DirtyInstanceBits = SCAST(u64*, CreateVectorArray(ArrayIndex++, GetVectorBitsSize(POOL_MAX_COUNT)));
+    EntityManager.UploadedVisible   = SCAST(u32*, CreateVectorArray(ArrayIndex++, POOL_MAX_COUNT * sizeof(u32)));
+    EntityManager.UploadedSlots     = SCAST(u32*, CreateVectorArray(ArrayIndex++, POOL_MAX_COUNT * sizeof(u32)));
+    EntityManager.VectorInstances   = SCAST(vector_handle*, CreateVectorArray(ArrayIndex++, POOL_MAX_COUNT * sizeof(vector_handle)));
+    ASSERT(ArrayIndex == VECTOR_ARRAY_COUNT, "Every vector array needs its arena.");
 }
 
-static void CreateVectorEntity(simulation_vector* Vector)
+// Makes room for Required vectors, growing the arrays like the instance buffer, with
+// GrowInstanceCapacity. The new bits are clear and the new slots are VECTOR_SLOT_NONE.
+static bool ReserveVectorCapacity(u32 Required)
 {
-    vec_3 OriginToPoint      = Vector->Direction - Vector->Origin;
-    vec_3 Direction          = Normalize(OriginToPoint);
-    vec_3 DefaultOrientation = vec_3(0.0f, 0.0f, 1.0f);
+    u32 OldCapacity = EntityManager.VectorCapacity;
+    u32 Capacity    = GrowInstanceCapacity(OldCapacity, Required);
+    if (Capacity == OldCapacity)
+    {
+        return true;
+    }
 
-    f32 ScaleFactor   = VectorLength(OriginToPoint);
-    vec_3 ScaleVector = vec_3(1.0f, 1.0f, ScaleFactor);
-    mat_4 Scale       = ScalingMatrix(ScaleVector);
+    for (u32 ArrayIndex = 0; ArrayIndex < VECTOR_ARRAY_COUNT; ArrayIndex++)
+    {
+        bool IsBitset = ArrayIndex == VECTOR_ARRAY_DIRTY_VECTOR_BITS || ArrayIndex == VECTOR_ARRAY_DIRTY_INSTANCE_BITS;
+        size_t Size   = IsBitset ? GetVectorBitsSize(Capacity) : Capacity * sizeof(u32);
+        if (!GrowInPlace(Size, &EntityManager.VectorArrays[ArrayIndex]))
+        {
+            return false;
+        }
+    }
 
-    if (AreEqual(Direction, DefaultOrientation))
+    size_t OldBitsSize = GetVectorBitsSize(OldCapacity);
+    size_t BitsSize    = GetVectorBitsSize(Capacity);
+    memset((u8*)EntityManager.DirtyVectorBits + OldBitsSize, 0, BitsSize - OldBitsSize);
+    memset((u8*)EntityManager.DirtyInstanceBits + OldBitsSize, 0, BitsSize - OldBitsSize);
+    memset(EntityManager.UploadedSlots + OldCapacity, 0xFF, (Capacity - OldCapacity) * sizeof(u32));
+    EntityManager.VectorCapacity = Capacity;
+    return true;
+}
+
+static void StoreVectorStreams(simulation_vector* Vector)
+{
+    u32 Index = Vector->InstanceIndex;
+    EntityManager.VectorOrigins.x[Index]   = Vector->Origin.x;
+    EntityManager.VectorOrigins.y[Index]   = Vector->Origin.y;
+    EntityManager.VectorOrigins.z[Index]   = Vector->Origin.z;
+    EntityManager.VectorTips.x[Index]      = Vector->Direction.x;
+    EntityManager.VectorTips.y[Index]      = Vector->Direction.y;
+    EntityManager.VectorTips.z[Index]      = Vector->Direction.z;
+    EntityManager.VectorRotations.x[Index] = Vector->Rotation.x;
+    EntityManager.VectorRotations.y[Index] = Vector->Rotation.y;
+    EntityManager.VectorRotations.z[Index] = Vector->Rotation.z;
+}
+
+// The vector's instance index is the next one in the instance data, which CreateVectorEntity fills.
+// Returns POOL_HANDLE_NONE once the vector pool is full.
+static vector_handle CreateSimulationVector(vec_3 Origin, vec_3 Direction, vec_4 Color)
+{
+    u32 Index = EntityManager.VectorEntitysCount;
+    if (!CanCreateVector() || !ReserveVectorCapacity(Index + 1))
     {
-        DefaultOrientation = vec_3(0.0f, 1.0f, 0.0f);
+        return POOL_HANDLE_NONE;
     }
 
-    vec_3 Right = Normalize(VectorProduct(DefaultOrientation, Direction));
-    vec_3 Up = Normalize(VectorProduct(Direction, Right));
+    vector_handle Handle = PoolAllocate(&EntityManager.VectorPool);
+    if (Handle == POOL_HANDLE_NONE)
+    {
+        return POOL_HANDLE_NONE;
+    }
 
-    mat_4 Rotation = mat_4(
-        vec_4(Right.x, Up.x, Direction.x, 0),
-        vec_4(Right.y, Up.y, Direction.y, 0),
-        vec_4(Right.z, Up.z, Direction.z, 0),
-        vec_4(0, 0, 0, 1)
-    );
+    EntityManager.VectorEntitysCount    += 1;
+    EntityManager.VectorInstances[Index] = Handle;
+
+    simulation_vector* Vector = GetSimulationVector(Handle);
+    *Vector                   = simulation_vector();
+    Vector->Origin            = Origin;
+    Vector->Direction         = Direction;
+    Vector->Color             = Color;
+    Vector->InstanceIndex     = Index;
+    Vector->Transform         = CreateTransform();
+    StoreVectorStreams(Vector);
+    SetTransformBit(EntityManager.DirtyVectorBits, Index);
+    return Handle;
+}
 
-    vec_3 OffsetVector = vec_3((OriginToPoint.x / 2 + Vector->Origin.x),
-                               (OriginToPoint.y / 2 + Vector->Origin.y),
-                               (OriginToPoint.z / 2 + Vector->Origin.z));
-    mat_4 Translation = TranslationMatrix(OffsetVector);
+static void CreateVectorEntity(vector_handle Handle)
+{
+    simulation_vector* Vector = GetSimulationVector(Handle);
+    if (!Vector)
+    {
+        return;
+    }
 
+    // The transform is written by UpdateEntityTransforms, before the instance data is uploaded.
     vector_instance_data VectorEntityData = {};
-    VectorEntityData.Transform            = Translation * Rotation * Scale;
     VectorEntityData.Color                = Vector->Color;
 
-    PushAndCopy(sizeof(vector_instance_data), &VectorEntityData, &EntityManager.VectorInstanceData);
+    PushAndCopy(sizeof(vector_instance_data), &VectorEntityData, &EntityManager.VectorInstanceData, alignof(vector_instance_data));
     EntityManager.VectorUpdateTypes |= UPDATE_RESOURCE_RECREATE;
 }
 
-static void UpdateVectorPosition(simulation_vector* Vector)
+// Creates up to Count vectors and their gizmos in one go: the instance data grows once and the
+// instance buffer and the per-vector arrays grow once. Returns how many were created: it stops at
+// the first vector CreateSimulationVector refuses.
+static u32 CreateSimulationVectors(soa_vec_3 Origins, soa_vec_3 Destinations, vec_4 Color, u32 Count)
 {
-    auto* PreviousInstanceData = (vector_instance_data*)EntityManager.VectorInstanceData.Memory + Vector->InstanceIndex;
+    u32 Available = GetVectorRoomLeft();
+    if (Available == 0 || Count == 0)
+    {
+        return 0;
+    }
 
-    vec_3 OriginToPoint      = Vector->Direction - Vector->Origin;
-    vec_3 Direction          = Normalize(OriginToPoint);
-    vec_3 DefaultOrientation = vec_3(0.0f, 0.0f, 1.0f);
+    Count = Count < Available ? Count : Available;
+    if (!ReserveVectorCapacity(EntityManager.VectorEntitysCount + Count))
+    {
+        return 0;
+    }
 
-    f32 ScaleFactor   = VectorLength(OriginToPoint);
-    vec_3 ScaleVector = vec_3(1.0f, 1.0f, ScaleFactor);
-    mat_4 Scale       = ScalingMatrix(ScaleVector);
+    vector_instance_data* Instances = PushArray<vector_instance_data>(Count, &EntityManager.VectorInstanceData);
+    if (!Instances)
+    {
+        return 0;
+    }
 
-    if (AreEqual(Direction, DefaultOrientation))
+    // Same as CreateVectorEntity: the transform is written by UpdateEntityTransforms.
+    u32 CreatedCount = 0;
+    for (; CreatedCount < Count; CreatedCount++)
     {
-        DefaultOrientation = vec_3(0.0f, 1.0f, 0.0f);
+        vec_3 Origin      = vec_3(Origins.x[CreatedCount], Origins.y[CreatedCount], Origins.z[CreatedCount]);
+        vec_3 Destination = vec_3(Destinations.x[CreatedCount], Destinations.y[CreatedCount], Destinations.z[CreatedCount]);
+
+        if (CreateSimulationVector(Origin, Destination, Color) == POOL_HANDLE_NONE)
+        {
+            break;
+        }
+
+        Instances[CreatedCount]       = vector_instance_data();
+        Instances[CreatedCount].Color = Color;
     }
 
-    vec_3 Right = Normalize(VectorProduct(DefaultOrientation, Direction));
-    vec_3 Up    = Normalize(VectorProduct(Direction, Right));
+    // The instance data stays packed with the vectors that exist.
+    if (CreatedCount < Count)
+    {
+        PopSize((Count - CreatedCount) * sizeof(vector_instance_data), &EntityManager.VectorInstanceData);
+    }
 
-    mat_4 ObjectRotation = mat_4(
-        vec_4(Right.x, Up.x, Direction.x, 0),
-        vec_4(Right.y, Up.y, Direction.y, 0),
-        vec_4(Right.z, Up.z, Direction.z, 0),
-        vec_4(0, 0, 0, 1)
-    );
-    mat_4 EulerRotation = RotationMatrixFromEulerAngles(Vector->Rotation);
-    mat_4 FinalRotation = ObjectRotation * EulerRotation;
+    if (CreatedCount > 0)
+    {
+        EntityManager.VectorUpdateTypes |= UPDATE_RESOURCE_RECREATE;
+    }
+    return CreatedCount;
+}
 
-    vec_3 OffsetVector = vec_3((OriginToPoint.x / 2 + Vector->Origin.x),
-                               (OriginToPoint.y / 2 + Vector->Origin.y),
-                               (OriginToPoint.z / 2 + Vector->Origin.z));
-    mat_4 Translation = TranslationMatrix(OffsetVector);
+// The UI can call this on every edit: the gizmo is rebuilt once, in UpdateEntityTransforms.
+static void UpdateVectorPosition(simulation_vector* Vector)
+{
+    StoreVectorStreams(Vector);
+    SetTransformBit(EntityManager.DirtyVectorBits, Vector->InstanceIndex);
+}
 
-    PreviousInstanceData->Transform = Translation * FinalRotation * Scale;
-    EntityManager.VectorUpdateTypes |= UPDATE_RESOURCE_DISCARD;
+// The instance data of the vector changed: only its slot is uploaded, if it is visible.
+static void MarkVectorInstanceDirty(u32 InstanceIndex)
+{
+    SetTransformBit(EntityManager.DirtyInstanceBits, InstanceIndex);
+    EntityManager.VectorUpdateTypes |= UPDATE_RESOURCE_NO_DISCARD;
 }
 
 static void UpdateVectorColor(simulation_vector* Vector)
 {
     auto* PreviousInstanceData = (vector_instance_data*)EntityManager.VectorInstanceData.Memory + Vector->InstanceIndex;
     memcpy(PreviousInstanceData->Color.AsArray, Vector->Color.AsArray, sizeof(PreviousInstanceData->Color));
-    EntityManager.VectorUpdateTypes |= UPDATE_RESOURCE_DISCARD;
+    MarkVectorInstanceDirty(Vector->InstanceIndex);
+}
+
+static void MoveVectorBit(u64* Bits, u32 From, u32 To)
+{
+    if (IsTransformBitSet(Bits, From))
+    {
+        SetTransformBit(Bits, To);
+    }
+    else
+    {
+        ClearTransformBit(Bits, To);
+    }
+    ClearTransformBit(Bits, From);
+}
+
+// Swap-remove: the last vector takes the instance index of the destroyed one, so the instance data
+// stays packed, and on the GPU the last uploaded gizmo takes its slot. That gizmo is the only one
+// uploaded again. The moved vector keeps its handle; the destroyed one's handles become stale.
+static bool DestroySimulationVector(vector_handle Handle)
+{
+    simulation_vector* Vector = GetSimulationVector(Handle);
+    if (!Vector)
+    {
+        return false;
+    }
+
+    u32 Index          = Vector->InstanceIndex;
+    u32 LastIndex      = EntityManager.VectorEntitysCount - 1;
+    u32* UploadedSlots = EntityManager.UploadedSlots;
+    u32* Uploaded      = EntityManager.UploadedVisible;
+
+    u32 Slot = UploadedSlots[Index];
+    if (Slot != VECTOR_SLOT_NONE)
+    {
+        u32 LastSlot              = --EntityManager.UploadedVisibleCount;
+        u32 MovedIndex            = Uploaded[LastSlot];
+        Uploaded[Slot]            = MovedIndex;
+        UploadedSlots[MovedIndex] = Slot;
+        UploadedSlots[Index]      = VECTOR_SLOT_NONE;
+    }
+
+    if (Index != LastIndex)
+    {
+        auto* InstanceData      = (vector_instance_data*)EntityManager.VectorInstanceData.Memory;
+        vector_handle Moved     = EntityManager.VectorInstances[LastIndex];
+        simulation_vector* Last = GetSimulationVector(Moved);
+
+        Last->InstanceIndex                  = Index;
+        EntityManager.VectorInstances[Index] = Moved;
+        InstanceData[Index]                  = InstanceData[LastIndex];
+        StoreVectorStreams(Last);
+        MoveVectorBit(EntityManager.DirtyVectorBits, LastIndex, Index);
+        MoveVectorBit(EntityManager.DirtyInstanceBits, LastIndex, Index);
+
+        UploadedSlots[Index] = UploadedSlots[LastIndex];
+        if (UploadedSlots[Index] != VECTOR_SLOT_NONE)
+        {
+            Uploaded[UploadedSlots[Index]] = Index;
+        }
+    }
+    UploadedSlots[LastIndex] = VECTOR_SLOT_NONE;
+    ClearTransformBit(EntityManager.DirtyVectorBits, LastIndex);
+    ClearTransformBit(EntityManager.DirtyInstanceBits, LastIndex);
+
+    if (Slot != VECTOR_SLOT_NONE && Slot < EntityManager.UploadedVisibleCount)
+    {
+        MarkVectorInstanceDirty(Uploaded[Slot]);
+    }
+    EntityManager.VectorUpdateTypes |= UPDATE_RESOURCE_NO_DISCARD;
+
+    DestroyTransform(Vector->Transform);
+    PopSize(sizeof(vector_instance_data), &EntityManager.VectorInstanceData);
+    EntityManager.VectorInstances[LastIndex] = POOL_HANDLE_NONE;
+    EntityManager.VectorEntitysCount         = LastIndex;
+    PoolFree(&EntityManager.VectorPool, Handle);
+    return true;
 }
 
 // -----------------
 // Cube Functions
 // -----------------
-static simulation_cube* CreateSimulationCube(vec_3 Position)
-{
-    if (EntityManager.CubesCount < MAX_CUBE_COUNT)
-    {
-        u32 Index = EntityManager.CubesCount;
-        EntityManager.CubesCount += 1;
-        cube_instance_data CubeInstanceData = {};
-        CubeInstanceData.Time = 0;
-        CubeInstanceData.Transform = TranslationMatrix(Position);
-        simulation_cube* Cube = &EntityManager.Cube;
-        Cube->AffectedByGravity = false;
-        Cube->IsBeingSimulated = false;
-        Cube->Mass = 1.0f;
-        Cube->Position = Position;
-        Cube->Velocity = vec_3();
-        Cube->InstanceIndex = Index;
-        return Cube;
-    }
-    return nullptr;
+static simulation_cube* GetSimulationCube(cube_handle Handle)
+{
+    return GetPoolElement<simulation_cube>(&EntityManager.CubePool, Handle);
 }
 
-static void UpdateCube(simulation_cube* Cube)
+// The first cube is the one drawn with the cube object resource. Returns POOL_HANDLE_NONE once
+// MAX_CUBE_COUNT cubes exist.
+static cube_handle CreateSimulationCube(vec_3 Position)
 {
-    f32 DeltaTime   = 0.015f;
-    f32 Mass        = Cube->Mass;
-    vec_3 Direction = vec_3(1.0f, 0.0f, 0.0f);
-     
-    f32 Magnitude    = 2.0f;
-    vec_3 PushForce  = Normalize(Direction) * Magnitude;
-    vec_3 TotalForce = PushForce;
-
-    if (Cube->AffectedByGravity)
+    cube_handle Handle = PoolAllocate(&EntityManager.CubePool);
+    if (Handle == POOL_HANDLE_NONE)
     {
-        vec_3 GravityAccel = vec_3(0.0f, -9.81f, 0.0f);
-        vec_3 GravityForce = GravityAccel * Mass;
-        TotalForce = GravityForce + PushForce;
+        return POOL_HANDLE_NONE;
     }
 
-    vec_3 TotalAccel = TotalForce / Mass;
+    simulation_cube* Cube   = GetSimulationCube(Handle);
+    *Cube                   = simulation_cube();
+    Cube->AffectedByGravity = false;
+    Cube->IsBeingSimulated  = false;
+    Cube->Mass              = 1.0f;
+    Cube->Position          = VectorCast<sim_scalar>(Position);
+    Cube->Velocity          = vec_3_sim();
+    Cube->InstanceIndex     = EntityManager.CubePool.Count - 1;
+    Cube->Transform         = CreateTransform(TranslationAffine(Position));
+
+    if (!GetSimulationCube(EntityManager.Cube))
+    {
+        EntityManager.Cube = Handle;
+    }
+    return Handle;
+}
 
-    Cube->Velocity = Cube->Velocity + (TotalAccel * DeltaTime);
-    Cube->Position = Cube->Position + (Cube->Velocity * DeltaTime);
+// The object data follows the cube's world transform; UpdateEntities uploads it when it changes.
+static void MoveCube(simulation_cube* Cube)
+{
+    SetTransformLocal(Cube->Transform, TranslationAffine(VectorCast<f32>(Cube->Position)));
+}
 
-    mat_4 CubePosition = TranslationMatrix(Cube->Position);
-    auto Now           = std::chrono::steady_clock::now();
+static void UploadCubeObjectData(simulation_cube* Cube)
+{
+    auto Now = std::chrono::steady_clock::now();
 
     cube_object_data CubeData = {};
     CubeData.Time             = std::chrono::duration<float>(Now - StartTime).count();
-    CubeData.Transform        = CubePosition;
+    CubeData.Transform        = AffineToMatrix(GetWorldTransform(Cube->Transform));
 
     UpdateObjectData(EntityManager.CubeResourceKey, &CubeData, sizeof(cube_object_data), UPDATE_RESOURCE_DISCARD);
 }
 
+static void UpdateCube(simulation_cube* Cube)
+{
+    IntegrateCubeForces(&Cube->Position, &Cube->Velocity, Cube->Mass, Cube->AffectedByGravity);
+    MoveCube(Cube);
+}
+
 static void ApplyPushForce(simulation_cube* Cube, vec_3 ForceToApply)
 {
     f32 Magnitude = Cube->ForceMagnitude;
@@ -232,44 +492,26 @@ static void ApplyPushForce(simulation_cube* Cube, vec_3 ForceToApply)
         Magnitude = 1;
     }
 
-    vec_3 PushForce = Normalize(ForceToApply) * Magnitude;
-    vec_3 PushAccel = PushForce / Cube->Mass;
-    Cube->Velocity  = Cube->Velocity + PushAccel;
+    AddPushImpulse(&Cube->Velocity, ForceToApply, Magnitude, Cube->Mass);
 }
 
 static void ApplyGravity(simulation_cube* Cube)
 {
-    vec_3 GravityAccel = vec_3(0.0f, -3.2f, 0.0f);
-    Cube->Velocity     = Cube->Velocity + (GravityAccel * CONSTANT_DELTA_TIME);
+    IntegrateGravity(&Cube->Velocity);
 }
 
 static void SimulateCube(simulation_cube* Cube)
 {
-    Cube->Position     = Cube->Position + (Cube->Velocity * CONSTANT_DELTA_TIME);
-
-    mat_4 CubePosition = TranslationMatrix(Cube->Position);
-    auto Now           = std::chrono::steady_clock::now();
-
-    cube_object_data CubeData = {};
-    CubeData.Time             = std::chrono::duration<float>(Now - StartTime).count();
-    CubeData.Transform        = CubePosition;
-    UpdateObjectData(EntityManager.CubeResourceKey, &CubeData, sizeof(cube_object_data), UPDATE_RESOURCE_DISCARD);
+    IntegratePosition(&Cube->Position, Cube->Velocity);
+    MoveCube(Cube);
 }
 
 static void StopCubeSimulation(simulation_cube* Cube)
 {
-    Cube->Position         = vec_3(1.0f, 0.5f, 1.0f);
-    Cube->Velocity         = vec_3();
+    Cube->Position         = VectorCast<sim_scalar>(vec_3(1.0f, 0.5f, 1.0f));
+    Cube->Velocity         = vec_3_sim();
     Cube->IsBeingSimulated = false;
-
-    mat_4 CubePosition = TranslationMatrix(Cube->Position);
-    auto Now           = std::chrono::steady_clock::now();
-
-    cube_object_data CubeData = {};
-    CubeData.Time             = std::chrono::duration<float>(Now - StartTime).count();
-    CubeData.Transform        = CubePosition;
-
-    UpdateObjectData(EntityManager.CubeResourceKey, &CubeData, sizeof(cube_object_data), UPDATE_RESOURCE_DISCARD);
+    MoveCube(Cube);
 }
 
 // -----------------
@@ -281,42 +523,239 @@ static void InitializeEntityManager()
     u8 Dummy = 0;
     EntityManager.VectorPipeline = CreateRenderPipeline(PipelineTable[PIPELINE_GIZMOS]);
     EntityManager.VectorMesh = LoadMesh(AssetTable[ENTITY_ASSET_VECTOR_GIZMO].Path);
-    EntityManager.VectorInstanceData = CreateBumpAllocator(Kilobytes(2), BUMP_RESIZABLE, "Vector Entitys");
+    EntityManager.VectorInstanceData = CreateBumpAllocator(VECTOR_INITIAL_COUNT * sizeof(vector_instance_data), BUMP_RESIZABLE, "Vector Entitys");
     EntityManager.VectorInstanceResourceKey = CreateInstancedResource(1, &Dummy, sizeof(vector_instance_data));
+    EntityManager.VectorFullUploadFraction = VECTOR_FULL_UPLOAD_FRACTION;
+    EntityManager.VectorPool = CreatePoolAllocator(sizeof(simulation_vector), alignof(simulation_vector), "Vectors");
+    EntityManager.VectorCullingData = CreateBumpAllocator(VECTOR_INITIAL_COUNT * VECTOR_CULLING_BYTES + 6 * BUMP_CACHE_LINE, BUMP_RESIZABLE, "Vector Culling", 2,
+                                                          POOL_MAX_COUNT * VECTOR_CULLING_BYTES + 6 * BUMP_CACHE_LINE);
+    CreateVectorArrays();
+    ReserveVectorCapacity(1);
 
     EntityManager.CubePipeline = CreateRenderPipeline(PipelineTable[PIPELINE_CUBE]);
     EntityManager.CubeMesh = LoadMesh(AssetTable[ENTITY_ASSET_CUBE].Path);
-    EntityManager.Cube.Position = vec_3(1.5f, 0.5f, 1.5f);
-    EntityManager.Cube.AffectedByGravity = false;
-    EntityManager.Cube.Mass = 1.0f;
+    EntityManager.CubePool = CreatePoolAllocator(sizeof(simulation_cube), alignof(simulation_cube), "Cubes", MAX_CUBE_COUNT);
 
     cube_object_data CubeDefault = {};
-    CubeDefault.Transform = TranslationMatrix(vec_3(1.5f, 0.5f, 1.5f));
+    CubeDefault.Transform = CUBE_DEFAULT_TRANSFORM;
     EntityManager.CubeResourceKey = CreateObjectResource(&CubeDefault, sizeof(cube_object_data));
 }
 
-static void UpdateEntities()
+// Uploads the gizmos whose bounding sphere touches the camera frustum. The sphere comes from the
+// world transform: centered on the vector's midpoint, with the mesh's length along the Z axis and
+// its radius along the other two, so it holds whatever rotation and parent the vector has.
+//
+// The buffer holds the visible gizmos packed together. While the same gizmos stay visible, in any
+// order, they keep their slots and only the slots of the dirty ones are uploaded, as ranges of
+// neighbouring slots, unless more than VectorFullUploadFraction of them are dirty. Any other change
+// uploads the whole list.
+static u32 CullVectorGizmos()
 {
-    if (EntityManager.VectorUpdateTypes != UPDATE_RESOURCE_NONE)
+    u32 VectorCount         = EntityManager.VectorEntitysCount;
+    bump_allocator* Scratch = &EntityManager.VectorCullingData;
+    ResetAllocator(Scratch);
+
+    auto* Visible     = PushArray<vector_instance_data>(VectorCount, Scratch);
+    soa_vec_3 Centers = {};
+    Centers.x         = PushArray<f32>(VectorCount, Scratch, BUMP_CACHE_LINE);
+    Centers.y         = PushArray<f32>(VectorCount, Scratch, BUMP_CACHE_LINE);
+    Centers.z         = PushArray<f32>(VectorCount, Scratch, BUMP_CACHE_LINE);
+    f32* Radii        = PushArray<f32>(VectorCount, Scratch, BUMP_CACHE_LINE);
+    u32* VisibleIndex = PushArray<u32>(VectorCount, Scratch, BUMP_CACHE_LINE);
+    if (!Visible || !Centers.x || !Centers.y || !Centers.z || !Radii || !VisibleIndex)
     {
-        size_t ResourceOffset = 0;
-        void* UpdatedResource = EntityManager.VectorInstanceData.Memory;
-        UpdateInstanceData(EntityManager.VectorInstanceResourceKey, UpdatedResource, sizeof(vector_instance_data),
-            EntityManager.VectorEntitysCount, ResourceOffset, EntityManager.VectorUpdateTypes);
+        return 0;
     }
-    PushDrawCommand(0, EntityManager.VectorInstanceResourceKey, EntityManager.VectorMesh, EntityManager.VectorPipeline);
-    EntityManager.VectorUpdateTypes = UPDATE_RESOURCE_NONE;
-    simulation_cube* Cube = &EntityManager.Cube;
-    if (Cube->IsBeingSimulated)
+
+    auto* InstanceData = (vector_instance_data*)EntityManager.VectorInstanceData.Memory;
+    for (u32 Index = 0; Index < VectorCount; Index++)
+    {
+        mat_4 Transform = InstanceData[Index].Transform;
+        vec_3 AxisX     = vec_3(Transform.Rows[0].x, Transform.Rows[1].x, Transform.Rows[2].x);
+        vec_3 AxisY     = vec_3(Transform.Rows[0].y, Transform.Rows[1].y, Transform.Rows[2].y);
+        vec_3 AxisZ     = vec_3(Transform.Rows[0].z, Transform.Rows[1].z, Transform.Rows[2].z);
+
+        f32 HalfLength = VectorLength(AxisZ) * 0.5f;
+        f32 AxisScale  = VectorLength(AxisX) > VectorLength(AxisY) ? VectorLength(AxisX) : VectorLength(AxisY);
+        f32 Radius     = VECTOR_GIZMO_RADIUS * AxisScale;
+
+        Centers.x[Index] = Transform.Rows[0].w;
+        Centers.y[Index] = Transform.Rows[1].w;
+        Centers.z[Index] = Transform.Rows[2].w;
+        Radii[Index]     = SquareRoot(HalfLength * HalfLength + Radius * Radius);
+    }
+
+    u32 VisibleCount = CullSpheres(Camera.Frustum, Centers, Radii, VectorCount, VisibleIndex);
+
+    // Slots are unique, so as many visible gizmos that all have a slot are the uploaded ones.
+    bool SameVisible = EntityManager.UploadedVisibleValid && EntityManager.UploadedVisibleCount == VisibleCount;
+    for (u32 Index = 0; SameVisible && Index < VisibleCount; Index++)
+    {
+        SameVisible = EntityManager.UploadedSlots[VisibleIndex[Index]] != VECTOR_SLOT_NONE;
+    }
+
+    auto* Ranges  = SameVisible ? PushArray<instance_range>(VisibleCount, Scratch, BUMP_CACHE_LINE) : nullptr;
+    bool Uploaded = false;
+    if (Ranges)
+    {
+        u32 RangeCount  = 0;
+        u32 DirtyCount  = 0;
+        for (u32 Slot = 0; Slot < VisibleCount; Slot++)
+        {
+            u32 Index = EntityManager.UploadedVisible[Slot];
+            if (!IsTransformBitSet(EntityManager.DirtyInstanceBits, Index))
+            {
+                continue;
+            }
+
+            Visible[Slot] = InstanceData[Index];
+            DirtyCount   += 1;
+            if (RangeCount > 0 && Ranges[RangeCount - 1].First + Ranges[RangeCount - 1].Count == Slot)
+            {
+                Ranges[RangeCount - 1].Count += 1;
+            }
+            else
+            {
+                Ranges[RangeCount++] = { Slot, 1 };
+            }
+        }
+
+        Uploaded = DirtyCount <= EntityManager.VectorFullUploadFraction * VisibleCount;
+        if (Uploaded)
+        {
+            UpdateInstanceRanges(EntityManager.VectorInstanceResourceKey, Visible, Ranges, RangeCount, VisibleCount);
+        }
+    }
+
+    if (!Uploaded)
+    {
+        memset(EntityManager.UploadedSlots, 0xFF, EntityManager.VectorCapacity * sizeof(u32));
+        for (u32 Slot = 0; Slot < VisibleCount; Slot++)
+        {
+            Visible[Slot]                                   = InstanceData[VisibleIndex[Slot]];
+            EntityManager.UploadedVisible[Slot]             = VisibleIndex[Slot];
+            EntityManager.UploadedSlots[VisibleIndex[Slot]] = Slot;
+        }
+
+        UpdateVisibleInstances(EntityManager.VectorInstanceResourceKey, Visible, VisibleCount);
+        EntityManager.UploadedVisibleCount = VisibleCount;
+        EntityManager.UploadedVisibleValid = true;
+    }
+
+    memset(EntityManager.DirtyInstanceBits, 0, GetVectorBitsSize(EntityManager.VectorCapacity));
+    EntityManager.CulledFrustumVersion = Camera.FrustumVersion;
+    return VisibleCount;
+}
+
+// Rebuilds the gizmos of the vectors edited since the last frame, runs the hierarchy pass, then
+// copies the world matrices that changed to the instance data. The dirty range is rebuilt in one
+// batch, into the culling scratch, which CullVectorGizmos only needs later in the frame.
+static void UpdateEntityTransforms()
+{
+    u32 VectorCount = EntityManager.VectorEntitysCount;
+    u32 FirstDirty  = VectorCount;
+    u32 LastDirty   = 0;
+    for (u32 Index = 0; Index < VectorCount; Index++)
+    {
+        if (IsTransformBitSet(EntityManager.DirtyVectorBits, Index))
+        {
+            FirstDirty = FirstDirty < Index ? FirstDirty : Index;
+            LastDirty  = Index;
+        }
+    }
+
+    if (FirstDirty < VectorCount)
+    {
+        u32 DirtyCount = LastDirty - FirstDirty + 1;
+        ResetAllocator(&EntityManager.VectorCullingData);
+        mat_4* Gizmos = PushArray<mat_4>(DirtyCount, &EntityManager.VectorCullingData, BUMP_CACHE_LINE);
+        if (!Gizmos)
+        {
+            return;
+        }
+
+        BuildGizmoTransforms(OffsetVectorStreams(EntityManager.VectorOrigins, FirstDirty), OffsetVectorStreams(EntityManager.VectorTips, FirstDirty),
+                             OffsetVectorStreams(EntityManager.VectorRotations, FirstDirty), Gizmos, sizeof(mat_4), DirtyCount);
+
+        for (u32 Index = FirstDirty; Index <= LastDirty; Index++)
+        {
+            if (IsTransformBitSet(EntityManager.DirtyVectorBits, Index))
+            {
+                simulation_vector* Vector = GetSimulationVector(EntityManager.VectorInstances[Index]);
+                SetTransformLocal(Vector->Transform, MatrixToAffine(Gizmos[Index - FirstDirty]));
+            }
+        }
+    }
+    memset(EntityManager.DirtyVectorBits, 0, GetVectorBitsSize(EntityManager.VectorCapacity));
+
+    if (UpdateWorldTransforms() == 0)
+    {
+        return;
+    }
+
+    auto* InstanceData = (vector_instance_data*)EntityManager.VectorInstanceData.Memory;
+    for (u32 Index = 0; Index < VectorCount; Index++)
+    {
+        simulation_vector* Vector = GetSimulationVector(EntityManager.VectorInstances[Index]);
+        if (IsTransformChanged(Vector->Transform))
+        {
+            InstanceData[Index].Transform = AffineToMatrix(GetWorldTransform(Vector->Transform));
+            MarkVectorInstanceDirty(Index);
+        }
+    }
+
+    simulation_cube* Cube = GetSimulationCube(EntityManager.Cube);
+    if (Cube && IsTransformChanged(Cube->Transform))
+    {
+        UploadCubeObjectData(Cube);
+    }
+}
+
+static bool IsVectorAttachedToCube(simulation_vector* Vector)
+{
+    simulation_cube* Cube = GetSimulationCube(EntityManager.Cube);
+    return Cube && GetTransformParent(Vector->Transform) == Cube->Transform;
+}
+
+// The vector keeps its Origin and Direction, which are now relative to the cube.
+static void AttachVectorToCube(simulation_vector* Vector, bool Attach)
+{
+    simulation_cube* Cube = GetSimulationCube(EntityManager.Cube);
+    AttachTransform(Vector->Transform, Attach && Cube ? Cube->Transform : TRANSFORM_NONE);
+}
+
+static void UpdateEntities()
+{
+    // The cube moves first, so the vectors attached to it follow in the same frame.
+    simulation_cube* Cube = GetSimulationCube(EntityManager.Cube);
+    if (Cube && Cube->IsBeingSimulated)
     {
         if (Cube->AffectedByGravity)
             ApplyGravity(Cube);
         SimulateCube(Cube);
     }
-    PushDrawCommand(EntityManager.CubeResourceKey, 0, EntityManager.CubeMesh, EntityManager.CubePipeline);
-}
+    UpdateEntityTransforms();
 
-static inline bool CanCreateVector()
-{
-    return (EntityManager.VectorEntitysCount + 1) < MAX_VECTORS;
+    bool ShouldCull = EntityManager.VectorUpdateTypes != UPDATE_RESOURCE_NONE ||
+                      EntityManager.CulledFrustumVersion != Camera.FrustumVersion;
+
+    // New vectors: the buffer makes room for every vector, reallocating only when they outgrow its
+    // capacity. Nothing is copied, the culled upload fills it right after.
+    if (EntityManager.VectorUpdateTypes & UPDATE_RESOURCE_RECREATE)
+    {
+        size_t ResourceOffset = 0;
+        UpdateInstanceData(EntityManager.VectorInstanceResourceKey, nullptr, sizeof(vector_instance_data),
+            EntityManager.VectorEntitysCount, ResourceOffset, UPDATE_RESOURCE_RECREATE);
+        EntityManager.UploadedVisibleValid = false;
+    }
+    if (ShouldCull)
+    {
+        CullVectorGizmos();
+    }
+    PushDrawCommand(0, EntityManager.VectorInstanceResourceKey, EntityManager.VectorMesh, EntityManager.VectorPipeline);
+    EntityManager.VectorUpdateTypes = UPDATE_RESOURCE_NONE;
+    if (Cube)
+    {
+        PushDrawCommand(EntityManager.CubeResourceKey, 0, EntityManager.CubeMesh, EntityManager.CubePipeline);
+    }
 }
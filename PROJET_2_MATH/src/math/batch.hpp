@@ -0,0 +1,650 @@
+#pragma once
+
+#include "matrix.hpp"
+
+// Batched transform kernels over structure-of-arrays streams. The main loop runs
+// 8 lanes per iteration on AVX and 4 on SSE2; the remainder goes through the
+// scalar path with the same operation order.
+
+struct soa_vec_3
+{
+	f32* x;
+	f32* y;
+	f32* z;
+};
+
+inline static soa_vec_3 OffsetVectorStreams(soa_vec_3 Streams, u32 Offset)
+{
+	soa_vec_3 Result = { Streams.x + Offset, Streams.y + Offset, Streams.z + Offset };
+	return Result;
+}
+
+#if MATH_SIMD_AVX
+constexpr u32 BATCH_LANE_COUNT = 8;
+#elif MATH_SIMD_SSE2
+constexpr u32 BATCH_LANE_COUNT = 4;
+#else
+constexpr u32 BATCH_LANE_COUNT = 1;
+#endif
+
+// Out = Transform * (In, 1). Only the affine part of the matrix is used. In and Out may alias.
+inline static void TransformPoints(mat_4 Transform, soa_vec_3 In, soa_vec_3 Out, u32 Count)
+{
+	f32* M    = Transform.AsArray;
+	u32 Index = 0;
+
+#if MATH_SIMD_AVX
+	{
+		__m256 M00 = _mm256_set1_ps(M[0]), M01 = _mm256_set1_ps(M[1]), M02 = _mm256_set1_ps(M[2]) , M03 = _mm256_set1_ps(M[3]);
+		__m256 M10 = _mm256_set1_ps(M[4]), M11 = _mm256_set1_ps(M[5]), M12 = _mm256_set1_ps(M[6]) , M13 = _mm256_set1_ps(M[7]);
+		__m256 M20 = _mm256_set1_ps(M[8]), M21 = _mm256_set1_ps(M[9]), M22 = _mm256_set1_ps(M[10]), M23 = _mm256_set1_ps(M[11]);
+
+		for (; Index + 8 <= Count; Index += 8)
+		{
+			__m256 X = _mm256_loadu_ps(In.x + Index);
+			__m256 Y = _mm256_loadu_ps(In.y + Index);
+			__m256 Z = _mm256_loadu_ps(In.z + Index);
+
+			__m256 OutX = MulAdd8(M00, X, MulAdd8(M01, Y, MulAdd8(M02, Z, M03)));
+			__m256 OutY = MulAdd8(M10, X, MulAdd8(M11, Y, MulAdd8(M12, Z, M13)));
+			__m256 OutZ = MulAdd8(M20, X, MulAdd8(M21, Y, MulAdd8(M22, Z, M23)));
+
+			_mm256_storeu_ps(Out.x + Index, OutX);
+			_mm256_storeu_ps(Out.y + Index, OutY);
+			_mm256_storeu_ps(Out.z + Index, OutZ);
+		}
+	}
+#endif
+
+#if MATH_SIMD_SSE2
+	{
+		__m128 M00 = _mm_set1_ps(M[0]), M01 = _mm_set1_ps(M[1]), M02 = _mm_set1_ps(M[2]) , M03 = _mm_set1_ps(M[3]);
+		__m128 M10 = _mm_set1_ps(M[4]), M11 = _mm_set1_ps(M[5]), M12 = _mm_set1_ps(M[6]) , M13 = _mm_set1_ps(M[7]);
+		__m128 M20 = _mm_set1_ps(M[8]), M21 = _mm_set1_ps(M[9]), M22 = _mm_set1_ps(M[10]), M23 = _mm_set1_ps(M[11]);
+
+		for (; Index + 4 <= Count; Index += 4)
+		{
+			__m128 X = _mm_loadu_ps(In.x + Index);
+			__m128 Y = _mm_loadu_ps(In.y + Index);
+			__m128 Z = _mm_loadu_ps(In.z + Index);
+
+			__m128 OutX = MulAdd4(M00, X, MulAdd4(M01, Y, MulAdd4(M02, Z, M03)));
+			__m128 OutY = MulAdd4(M10, X, MulAdd4(M11, Y, MulAdd4(M12, Z, M13)));
+			__m128 OutZ = MulAdd4(M20, X, MulAdd4(M21, Y, MulAdd4(M22, Z, M23)));
+
+			_mm_storeu_ps(Out.x + Index, OutX);
+			_mm_storeu_ps(Out.y + Index, OutY);
+			_mm_storeu_ps(Out.z + Index, OutZ);
+		}
+	}
+#endif
+
+	for (; Index < Count; Index++)
+	{
+		f32 X = In.x[Index];
+		f32 Y = In.y[Index];
+		f32 Z = In.z[Index];
+
+		Out.x[Index] = M[0] * X + (M[1] * Y + (M[2]  * Z + M[3]));
+		Out.y[Index] = M[4] * X + (M[5] * Y + (M[6]  * Z + M[7]));
+		Out.z[Index] = M[8] * X + (M[9] * Y + (M[10] * Z + M[11]));
+	}
+}
+
+#if MATH_SIMD_SSE2
+// Transposes four column registers and writes row RowIndex of four consecutive matrices.
+inline static void StoreMatrixRows4(__m128 C0, __m128 C1, __m128 C2, __m128 C3, char* Out, size_t Stride, u32 RowIndex)
+{
+	_MM_TRANSPOSE4_PS(C0, C1, C2, C3);
+	_mm_storeu_ps(RCAST(mat_4*, Out + 0 * Stride)->Rows[RowIndex].AsArray, C0);
+	_mm_storeu_ps(RCAST(mat_4*, Out + 1 * Stride)->Rows[RowIndex].AsArray, C1);
+	_mm_storeu_ps(RCAST(mat_4*, Out + 2 * Stride)->Rows[RowIndex].AsArray, C2);
+	_mm_storeu_ps(RCAST(mat_4*, Out + 3 * Stride)->Rows[RowIndex].AsArray, C3);
+}
+#endif
+
+// Builds Translation * Rotation * Scale for Count transforms, where the rotation is given
+// by its three basis columns (the layout CreateVectorEntity uses). Out is written with a
+// byte stride so the matrices can land straight in instance data such as vector_instance_data.
+inline static void ComposeTransforms(soa_vec_3 Translation, soa_vec_3 Right, soa_vec_3 Up, soa_vec_3 Forward,
+	                                 soa_vec_3 Scale, mat_4* Out, size_t OutStride, u32 Count)
+{
+	char* OutBytes = RCAST(char*, Out);
+	u32   Index    = 0;
+
+#if MATH_SIMD_AVX
+	for (; Index + 8 <= Count; Index += 8)
+	{
+		__m256 Sx = _mm256_loadu_ps(Scale.x + Index);
+		__m256 Sy = _mm256_loadu_ps(Scale.y + Index);
+		__m256 Sz = _mm256_loadu_ps(Scale.z + Index);
+
+		__m256 Rows[3][4] =
+		{
+			{ _mm256_mul_ps(_mm256_loadu_ps(Right.x + Index), Sx), _mm256_mul_ps(_mm256_loadu_ps(Up.x + Index), Sy),
+			  _mm256_mul_ps(_mm256_loadu_ps(Forward.x + Index), Sz), _mm256_loadu_ps(Translation.x + Index) },
+			{ _mm256_mul_ps(_mm256_loadu_ps(Right.y + Index), Sx), _mm256_mul_ps(_mm256_loadu_ps(Up.y + Index), Sy),
+			  _mm256_mul_ps(_mm256_loadu_ps(Forward.y + Index), Sz), _mm256_loadu_ps(Translation.y + Index) },
+			{ _mm256_mul_ps(_mm256_loadu_ps(Right.z + Index), Sx), _mm256_mul_ps(_mm256_loadu_ps(Up.z + Index), Sy),
+			  _mm256_mul_ps(_mm256_loadu_ps(Forward.z + Index), Sz), _mm256_loadu_ps(Translation.z + Index) },
+		};
+
+		char* Low  = OutBytes + (Index + 0) * OutStride;
+		char* High = OutBytes + (Index + 4) * OutStride;
+		for (u32 RowIndex = 0; RowIndex < 3; RowIndex++)
+		{
+			__m256* R = Rows[RowIndex];
+			StoreMatrixRows4(_mm256_castps256_ps128(R[0]), _mm256_castps256_ps128(R[1]),
+				             _mm256_castps256_ps128(R[2]), _mm256_castps256_ps128(R[3]), Low, OutStride, RowIndex);
+			StoreMatrixRows4(_mm256_extractf128_ps(R[0], 1), _mm256_extractf128_ps(R[1], 1),
+				             _mm256_extractf128_ps(R[2], 1), _mm256_extractf128_ps(R[3], 1), High, OutStride, RowIndex);
+		}
+
+		for (u32 Lane = 0; Lane < 8; Lane++)
+		{
+			RCAST(mat_4*, OutBytes + (Index + Lane) * OutStride)->Rows[3] = vec_4(0, 0, 0, 1);
+		}
+	}
+#endif
+
+#if MATH_SIMD_SSE2
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		__m128 Sx = _mm_loadu_ps(Scale.x + Index);
+		__m128 Sy = _mm_loadu_ps(Scale.y + Index);
+		__m128 Sz = _mm_loadu_ps(Scale.z + Index);
+
+		char* Base = OutBytes + Index * OutStride;
+		StoreMatrixRows4(_mm_mul_ps(_mm_loadu_ps(Right.x + Index), Sx), _mm_mul_ps(_mm_loadu_ps(Up.x + Index), Sy),
+			             _mm_mul_ps(_mm_loadu_ps(Forward.x + Index), Sz), _mm_loadu_ps(Translation.x + Index), Base, OutStride, 0);
+		StoreMatrixRows4(_mm_mul_ps(_mm_loadu_ps(Right.y + Index), Sx), _mm_mul_ps(_mm_loadu_ps(Up.y + Index), Sy),
+			             _mm_mul_ps(_mm_loadu_ps(Forward.y + Index), Sz), _mm_loadu_ps(Translation.y + Index), Base, OutStride, 1);
+		StoreMatrixRows4(_mm_mul_ps(_mm_loadu_ps(Right.z + Index), Sx), _mm_mul_ps(_mm_loadu_ps(Up.z + Index), Sy),
+			             _mm_mul_ps(_mm_loadu_ps(Forward.z + Index), Sz), _mm_loadu_ps(Translation.z + Index), Base, OutStride, 2);
+
+		for (u32 Lane = 0; Lane < 4; Lane++)
+		{
+			RCAST(mat_4*, Base + Lane * OutStride)->Rows[3] = vec_4(0, 0, 0, 1);
+		}
+	}
+#endif
+
+	for (; Index < Count; Index++)
+	{
+		f32 Sx = Scale.x[Index];
+		f32 Sy = Scale.y[Index];
+		f32 Sz = Scale.z[Index];
+
+		mat_4* Result = RCAST(mat_4*, OutBytes + Index * OutStride);
+		*Result = mat_4(
+			vec_4(Right.x[Index] * Sx, Up.x[Index] * Sy, Forward.x[Index] * Sz, Translation.x[Index]),
+			vec_4(Right.y[Index] * Sx, Up.y[Index] * Sy, Forward.y[Index] * Sz, Translation.y[Index]),
+			vec_4(Right.z[Index] * Sx, Up.z[Index] * Sy, Forward.z[Index] * Sz, Translation.z[Index]),
+			vec_4(0, 0, 0, 1)
+		);
+	}
+}
+
+
+// ==================================================================================
+// Element-wise vector operations over SoA streams. Each operation is written once over a
+// "wide" lane type (__m256, __m128 or f32) and the driver runs the widest one available,
+// then the narrower ones on the remainder. Per lane, the math matches the scalar vec_3
+// functions operation for operation.
+
+template <typename wide>
+struct wide_vec_3
+{
+	wide x, y, z;
+};
+
+inline static f32 WideAdd(f32 A, f32 B) { return A + B; }
+inline static f32 WideSub(f32 A, f32 B) { return A - B; }
+inline static f32 WideMul(f32 A, f32 B) { return A * B; }
+inline static f32 WideDiv(f32 A, f32 B) { return A / B; }
+inline static f32 WideSqrt(f32 A) { return SquareRoot(A); }
+inline static f32 WideInvSqrt(f32 A) { return InverseSquareRoot(A); }
+inline static f32 WideZeroWhereZero(f32 Value, f32 Test) { return Test != 0 ? Value : 0.0f; }
+
+template <typename wide> inline static wide WideLoad(const f32* Memory);
+template <typename wide> inline static wide WideSplat(f32 Value);
+
+// Same NaN handling as minps/maxps: the second operand is returned when the comparison fails.
+static constexpr f32 WideMin(f32 A, f32 B) { return A < B ? A : B; }
+static constexpr f32 WideMax(f32 A, f32 B) { return A > B ? A : B; }
+inline static f32 WideNegate(f32 A) { return -A; }
+
+// Comparisons give a lane mask: bool for f32, all bits set per lane for the SIMD types.
+inline static bool WideLess(f32 A, f32 B) { return A < B; }
+inline static bool WideLessEqual(f32 A, f32 B) { return A <= B; }
+inline static bool WideNotEqual(f32 A, f32 B) { return A != B; }
+inline static bool WideAnd(bool A, bool B) { return A && B; }
+inline static bool WideOr(bool A, bool B) { return A || B; }
+inline static f32 WideSelect(bool Mask, f32 IfTrue, f32 IfFalse) { return Mask ? IfTrue : IfFalse; }
+inline static u32 WideMoveMask(bool Mask) { return Mask ? 1u : 0u; }
+
+template <> inline f32 WideLoad<f32>(const f32* Memory) { return *Memory; }
+template <> inline f32 WideSplat<f32>(f32 Value) { return Value; }
+inline static void WideStore(f32* Memory, f32 Value) { *Memory = Value; }
+
+#if MATH_SIMD_SSE2
+inline static __m128 WideAdd(__m128 A, __m128 B) { return _mm_add_ps(A, B); }
+inline static __m128 WideSub(__m128 A, __m128 B) { return _mm_sub_ps(A, B); }
+inline static __m128 WideMul(__m128 A, __m128 B) { return _mm_mul_ps(A, B); }
+inline static __m128 WideDiv(__m128 A, __m128 B) { return _mm_div_ps(A, B); }
+inline static __m128 WideSqrt(__m128 A) { return _mm_sqrt_ps(A); }
+inline static __m128 WideInvSqrt(__m128 A)
+{
+#if MATH_PRECISION_FAST
+	return FastInvSqrt4(A);
+#else
+	return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(A));
+#endif
+}
+inline static __m128 WideZeroWhereZero(__m128 Value, __m128 Test)
+{
+	return _mm_andnot_ps(_mm_cmpeq_ps(Test, _mm_setzero_ps()), Value);
+}
+
+inline static __m128 WideMin(__m128 A, __m128 B) { return _mm_min_ps(A, B); }
+inline static __m128 WideMax(__m128 A, __m128 B) { return _mm_max_ps(A, B); }
+inline static __m128 WideNegate(__m128 A) { return _mm_xor_ps(A, _mm_set1_ps(-0.0f)); }
+
+inline static __m128 WideLess(__m128 A, __m128 B) { return _mm_cmplt_ps(A, B); }
+inline static __m128 WideLessEqual(__m128 A, __m128 B) { return _mm_cmple_ps(A, B); }
+inline static __m128 WideNotEqual(__m128 A, __m128 B) { return _mm_cmpneq_ps(A, B); }
+inline static __m128 WideAnd(__m128 A, __m128 B) { return _mm_and_ps(A, B); }
+inline static __m128 WideOr(__m128 A, __m128 B) { return _mm_or_ps(A, B); }
+inline static __m128 WideSelect(__m128 Mask, __m128 IfTrue, __m128 IfFalse)
+{
+	return _mm_or_ps(_mm_and_ps(Mask, IfTrue), _mm_andnot_ps(Mask, IfFalse));
+}
+inline static u32 WideMoveMask(__m128 Mask) { return SCAST(u32, _mm_movemask_ps(Mask)); }
+
+template <> inline __m128 WideLoad<__m128>(const f32* Memory) { return _mm_loadu_ps(Memory); }
+template <> inline __m128 WideSplat<__m128>(f32 Value) { return _mm_set1_ps(Value); }
+inline static void WideStore(f32* Memory, __m128 Value) { _mm_storeu_ps(Memory, Value); }
+#endif
+
+#if MATH_SIMD_AVX
+inline static __m256 WideAdd(__m256 A, __m256 B) { return _mm256_add_ps(A, B); }
+inline static __m256 WideSub(__m256 A, __m256 B) { return _mm256_sub_ps(A, B); }
+inline static __m256 WideMul(__m256 A, __m256 B) { return _mm256_mul_ps(A, B); }
+inline static __m256 WideDiv(__m256 A, __m256 B) { return _mm256_div_ps(A, B); }
+inline static __m256 WideSqrt(__m256 A) { return _mm256_sqrt_ps(A); }
+inline static __m256 WideInvSqrt(__m256 A)
+{
+#if MATH_PRECISION_FAST
+	return FastInvSqrt8(A);
+#else
+	return _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(A));
+#endif
+}
+inline static __m256 WideZeroWhereZero(__m256 Value, __m256 Test)
+{
+	return _mm256_andnot_ps(_mm256_cmp_ps(Test, _mm256_setzero_ps(), _CMP_EQ_OQ), Value);
+}
+
+inline static __m256 WideMin(__m256 A, __m256 B) { return _mm256_min_ps(A, B); }
+inline static __m256 WideMax(__m256 A, __m256 B) { return _mm256_max_ps(A, B); }
+inline static __m256 WideNegate(__m256 A) { return _mm256_xor_ps(A, _mm256_set1_ps(-0.0f)); }
+
+inline static __m256 WideLess(__m256 A, __m256 B) { return _mm256_cmp_ps(A, B, _CMP_LT_OQ); }
+inline static __m256 WideLessEqual(__m256 A, __m256 B) { return _mm256_cmp_ps(A, B, _CMP_LE_OQ); }
+inline static __m256 WideNotEqual(__m256 A, __m256 B) { return _mm256_cmp_ps(A, B, _CMP_NEQ_UQ); }
+inline static __m256 WideAnd(__m256 A, __m256 B) { return _mm256_and_ps(A, B); }
+inline static __m256 WideOr(__m256 A, __m256 B) { return _mm256_or_ps(A, B); }
+inline static __m256 WideSelect(__m256 Mask, __m256 IfTrue, __m256 IfFalse) { return _mm256_blendv_ps(IfFalse, IfTrue, Mask); }
+inline static u32 WideMoveMask(__m256 Mask) { return SCAST(u32, _mm256_movemask_ps(Mask)); }
+
+template <> inline __m256 WideLoad<__m256>(const f32* Memory) { return _mm256_loadu_ps(Memory); }
+template <> inline __m256 WideSplat<__m256>(f32 Value) { return _mm256_set1_ps(Value); }
+inline static void WideStore(f32* Memory, __m256 Value) { _mm256_storeu_ps(Memory, Value); }
+#endif
+
+template <typename wide>
+inline static wide WideDot(wide_vec_3<wide> A, wide_vec_3<wide> B)
+{
+	return WideAdd(WideAdd(WideMul(A.x, B.x), WideMul(A.y, B.y)), WideMul(A.z, B.z));
+}
+
+template <typename wide>
+inline static wide_vec_3<wide> WideScale(wide_vec_3<wide> A, wide Scalar)
+{
+	return { WideMul(A.x, Scalar), WideMul(A.y, Scalar), WideMul(A.z, Scalar) };
+}
+
+template <typename wide>
+inline static wide_vec_3<wide> WideAddVectors(wide_vec_3<wide> A, wide_vec_3<wide> B)
+{
+	return { WideAdd(A.x, B.x), WideAdd(A.y, B.y), WideAdd(A.z, B.z) };
+}
+
+template <typename wide>
+inline static wide_vec_3<wide> WideSubtractVectors(wide_vec_3<wide> A, wide_vec_3<wide> B)
+{
+	return { WideSub(A.x, B.x), WideSub(A.y, B.y), WideSub(A.z, B.z) };
+}
+
+template <typename wide>
+inline static wide_vec_3<wide> WideVectorProduct(wide_vec_3<wide> A, wide_vec_3<wide> B)
+{
+	return { WideSub(WideMul(A.y, B.z), WideMul(A.z, B.y)),
+		     WideSub(WideMul(A.z, B.x), WideMul(A.x, B.z)),
+		     WideSub(WideMul(A.x, B.y), WideMul(A.y, B.x)) };
+}
+
+// ProjectVectorOnVector: zero where the target has zero length.
+template <typename wide>
+inline static wide_vec_3<wide> WideProjectOnVector(wide_vec_3<wide> Vector, wide_vec_3<wide> Target)
+{
+	wide Denom = WideDot(Target, Target);
+	wide Scale = WideDiv(WideDot(Vector, Target), Denom);
+	wide_vec_3<wide> Projection = WideScale(Target, Scale);
+	return { WideZeroWhereZero(Projection.x, Denom), WideZeroWhereZero(Projection.y, Denom),
+		     WideZeroWhereZero(Projection.z, Denom) };
+}
+
+// ProjectVectorOnPlane, with Normalize following the precision policy.
+template <typename wide>
+inline static wide_vec_3<wide> WideProjectOnPlane(wide_vec_3<wide> Vector, wide_vec_3<wide> PlaneNormal)
+{
+#if MATH_PRECISION_FAST
+	wide_vec_3<wide> n = WideScale(PlaneNormal, WideInvSqrt(WideDot(PlaneNormal, PlaneNormal)));
+#else
+	wide Length        = WideSqrt(WideDot(PlaneNormal, PlaneNormal));
+	wide_vec_3<wide> n = { WideDiv(PlaneNormal.x, Length), WideDiv(PlaneNormal.y, Length), WideDiv(PlaneNormal.z, Length) };
+#endif
+	return WideSubtractVectors(Vector, WideScale(n, WideDot(Vector, n)));
+}
+
+enum BATCH_BROADCAST
+{
+	BATCH_BROADCAST_NONE = 0,
+	BATCH_BROADCAST_A    = 1 << 0,   // A holds one vector, used for every element
+	BATCH_BROADCAST_B    = 1 << 1,
+};
+
+template <typename wide>
+inline static wide_vec_3<wide> WideLoadVector(soa_vec_3 Stream, u32 Index)
+{
+	return { WideLoad<wide>(Stream.x + Index), WideLoad<wide>(Stream.y + Index), WideLoad<wide>(Stream.z + Index) };
+}
+
+template <typename wide>
+inline static wide_vec_3<wide> WideSplatVector(soa_vec_3 Stream)
+{
+	return { WideSplat<wide>(Stream.x[0]), WideSplat<wide>(Stream.y[0]), WideSplat<wide>(Stream.z[0]) };
+}
+
+template <typename wide, typename op_fn>
+inline static u32 RunVectorOp(op_fn Op, soa_vec_3 A, soa_vec_3 B, soa_vec_3 Out, u32 Index, u32 Count, u32 Broadcast, u32 LaneCount)
+{
+	wide_vec_3<wide> SplatA = (Broadcast & BATCH_BROADCAST_A) ? WideSplatVector<wide>(A) : wide_vec_3<wide>();
+	wide_vec_3<wide> SplatB = (Broadcast & BATCH_BROADCAST_B) ? WideSplatVector<wide>(B) : wide_vec_3<wide>();
+
+	for (; Index + LaneCount <= Count; Index += LaneCount)
+	{
+		wide_vec_3<wide> ValueA = (Broadcast & BATCH_BROADCAST_A) ? SplatA : WideLoadVector<wide>(A, Index);
+		wide_vec_3<wide> ValueB = (Broadcast & BATCH_BROADCAST_B) ? SplatB : WideLoadVector<wide>(B, Index);
+		wide_vec_3<wide> Result = Op(ValueA, ValueB);
+
+		WideStore(Out.x + Index, Result.x);
+		WideStore(Out.y + Index, Result.y);
+		WideStore(Out.z + Index, Result.z);
+	}
+	return Index;
+}
+
+// Out[i] = Op(A[i], B[i]). Op is a generic callable taking two wide_vec_3 of the same lane type.
+template <typename op_fn>
+inline static void BatchVectorOp(op_fn Op, soa_vec_3 A, soa_vec_3 B, soa_vec_3 Out, u32 Count, u32 Broadcast)
+{
+	u32 Index = 0;
+#if MATH_SIMD_AVX
+	Index = RunVectorOp<__m256>(Op, A, B, Out, Index, Count, Broadcast, 8);
+#endif
+#if MATH_SIMD_SSE2
+	Index = RunVectorOp<__m128>(Op, A, B, Out, Index, Count, Broadcast, 4);
+#endif
+	RunVectorOp<f32>(Op, A, B, Out, Index, Count, Broadcast, 1);
+}
+
+inline static void BatchAddVectors(soa_vec_3 A, soa_vec_3 B, soa_vec_3 Out, u32 Count, u32 Broadcast = BATCH_BROADCAST_NONE)
+{
+	BatchVectorOp([](auto a, auto b) { return WideAddVectors(a, b); }, A, B, Out, Count, Broadcast);
+}
+
+inline static void BatchSubtractVectors(soa_vec_3 A, soa_vec_3 B, soa_vec_3 Out, u32 Count, u32 Broadcast = BATCH_BROADCAST_NONE)
+{
+	BatchVectorOp([](auto a, auto b) { return WideSubtractVectors(a, b); }, A, B, Out, Count, Broadcast);
+}
+
+inline static void BatchVectorProduct(soa_vec_3 A, soa_vec_3 B, soa_vec_3 Out, u32 Count, u32 Broadcast = BATCH_BROADCAST_NONE)
+{
+	BatchVectorOp([](auto a, auto b) { return WideVectorProduct(a, b); }, A, B, Out, Count, Broadcast);
+}
+
+inline static void BatchScaleVectors(soa_vec_3 A, f32 Scalar, soa_vec_3 Out, u32 Count, u32 Broadcast = BATCH_BROADCAST_NONE)
+{
+	BatchVectorOp([Scalar](auto a, auto) { return WideScale(a, WideSplat<decltype(a.x)>(Scalar)); },
+		          A, A, Out, Count, Broadcast & BATCH_BROADCAST_A);
+}
+
+// Projects A[i] onto B[i].
+inline static void BatchProjectOnVector(soa_vec_3 A, soa_vec_3 B, soa_vec_3 Out, u32 Count, u32 Broadcast = BATCH_BROADCAST_NONE)
+{
+	BatchVectorOp([](auto a, auto b) { return WideProjectOnVector(a, b); }, A, B, Out, Count, Broadcast);
+}
+
+// Projects A[i] on the plane of normal B[i].
+inline static void BatchProjectOnPlane(soa_vec_3 A, soa_vec_3 B, soa_vec_3 Out, u32 Count, u32 Broadcast = BATCH_BROADCAST_NONE)
+{
+	BatchVectorOp([](auto a, auto b) { return WideProjectOnPlane(a, b); }, A, B, Out, Count, Broadcast);
+}
+
+// ==================================================================================
+// Vector gizmos
+
+// Rounding for the quadrant reduction of WideSinCos. The SIMD round goes to even on exact halves
+// where the scalar one goes away from zero; either quadrant reduces the angle correctly.
+inline static f32 WideRound(f32 A) { return (f32)(i32)(A + (A >= 0 ? 0.5f : -0.5f)); }
+inline static f32 WideFloor(f32 A) { return floorf(A); }
+
+#if MATH_SIMD_SSE2
+inline static __m128 WideRound(__m128 A) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(A)); }
+inline static __m128 WideFloor(__m128 A)
+{
+	__m128 Truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(A));
+	return _mm_sub_ps(Truncated, _mm_and_ps(_mm_cmpgt_ps(Truncated, A), _mm_set1_ps(1.0f)));
+}
+#endif
+
+#if MATH_SIMD_AVX
+inline static __m256 WideRound(__m256 A) { return _mm256_round_ps(A, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline static __m256 WideFloor(__m256 A) { return _mm256_floor_ps(A); }
+#endif
+
+// FastSinCos per lane, with the same polynomials and selects.
+template <typename wide>
+inline static void WideSinCos(wide Angle, wide* OutSin, wide* OutCos)
+{
+	wide q  = WideRound(WideMul(Angle, WideSplat<wide>(FAST_TWO_OVER_PI)));
+	wide x  = WideSub(WideSub(WideSub(Angle, WideMul(q, WideSplat<wide>(FAST_PI_OVER_2_A))),
+		                      WideMul(q, WideSplat<wide>(FAST_PI_OVER_2_B))), WideMul(q, WideSplat<wide>(FAST_PI_OVER_2_C)));
+	wide x2 = WideMul(x, x);
+
+	wide SinPolynomial = WideAdd(WideSplat<wide>(8.3321608736e-3f), WideMul(x2, WideSplat<wide>(-1.9515295891e-4f)));
+	SinPolynomial      = WideAdd(WideSplat<wide>(-1.6666654611e-1f), WideMul(x2, SinPolynomial));
+	wide Sin           = WideAdd(x, WideMul(WideMul(x, x2), SinPolynomial));
+
+	wide CosPolynomial = WideAdd(WideSplat<wide>(-1.388731625493765e-3f), WideMul(x2, WideSplat<wide>(2.443315711809948e-5f)));
+	CosPolynomial      = WideAdd(WideSplat<wide>(4.166664568298827e-2f), WideMul(x2, CosPolynomial));
+	wide Cos           = WideAdd(WideSub(WideSplat<wide>(1.0f), WideMul(WideSplat<wide>(0.5f), x2)), WideMul(WideMul(x2, x2), CosPolynomial));
+
+	// The quadrant modulo 4, kept in floats: 0 to 3.
+	wide Quadrant    = WideSub(q, WideMul(WideFloor(WideMul(q, WideSplat<wide>(0.25f))), WideSplat<wide>(4.0f)));
+	auto OddQuadrant = WideNotEqual(WideMul(WideFloor(WideMul(Quadrant, WideSplat<wide>(0.5f))), WideSplat<wide>(2.0f)), Quadrant);
+	auto SinNegative = WideLessEqual(WideSplat<wide>(2.0f), Quadrant);
+	auto CosNegative = WideAnd(WideLessEqual(WideSplat<wide>(1.0f), Quadrant), WideLessEqual(Quadrant, WideSplat<wide>(2.0f)));
+
+	wide SwappedSin = WideSelect(OddQuadrant, Cos, Sin);
+	wide SwappedCos = WideSelect(OddQuadrant, Sin, Cos);
+	*OutSin         = WideSelect(SinNegative, WideNegate(SwappedSin), SwappedSin);
+	*OutCos         = WideSelect(CosNegative, WideNegate(SwappedCos), SwappedCos);
+}
+
+// Sine and cosine per lane under the precision policy: WideSinCos with MATH_FAST_APPROX, otherwise
+// Sine and Cosine lane by lane, so the default build gets the libm values like the scalar path.
+template <typename wide>
+inline static void WidePolicySinCos(wide Angle, wide* OutSin, wide* OutCos)
+{
+#if MATH_PRECISION_FAST
+	WideSinCos(Angle, OutSin, OutCos);
+#else
+	constexpr u32 LaneCount = sizeof(wide) / sizeof(f32);
+	f32 Angles[LaneCount], Sines[LaneCount], Cosines[LaneCount];
+	WideStore(Angles, Angle);
+	for (u32 Lane = 0; Lane < LaneCount; Lane++)
+	{
+		Sines[Lane]   = Sine(Angles[Lane]);
+		Cosines[Lane] = Cosine(Angles[Lane]);
+	}
+	*OutSin = WideLoad<wide>(Sines);
+	*OutCos = WideLoad<wide>(Cosines);
+#endif
+}
+
+// Writes one matrix per lane from its three affine rows. The last row is (0, 0, 0, 1).
+inline static void StoreWideMatrices(f32 (&Rows)[3][4], char* Out, size_t Stride)
+{
+	(void)Stride;
+	*RCAST(mat_4*, Out) = mat_4(vec_4(Rows[0][0], Rows[0][1], Rows[0][2], Rows[0][3]),
+		                        vec_4(Rows[1][0], Rows[1][1], Rows[1][2], Rows[1][3]),
+		                        vec_4(Rows[2][0], Rows[2][1], Rows[2][2], Rows[2][3]),
+		                        vec_4(0, 0, 0, 1));
+}
+
+#if MATH_SIMD_SSE2
+inline static void StoreWideMatrices(__m128 (&Rows)[3][4], char* Out, size_t Stride)
+{
+	for (u32 RowIndex = 0; RowIndex < 3; RowIndex++)
+	{
+		__m128* R = Rows[RowIndex];
+		StoreMatrixRows4(R[0], R[1], R[2], R[3], Out, Stride, RowIndex);
+	}
+	for (u32 Lane = 0; Lane < 4; Lane++)
+	{
+		RCAST(mat_4*, Out + Lane * Stride)->Rows[3] = vec_4(0, 0, 0, 1);
+	}
+}
+#endif
+
+#if MATH_SIMD_AVX
+inline static void StoreWideMatrices(__m256 (&Rows)[3][4], char* Out, size_t Stride)
+{
+	for (u32 RowIndex = 0; RowIndex < 3; RowIndex++)
+	{
+		__m256* R = Rows[RowIndex];
+		StoreMatrixRows4(_mm256_castps256_ps128(R[0]), _mm256_castps256_ps128(R[1]),
+			             _mm256_castps256_ps128(R[2]), _mm256_castps256_ps128(R[3]), Out, Stride, RowIndex);
+		StoreMatrixRows4(_mm256_extractf128_ps(R[0], 1), _mm256_extractf128_ps(R[1], 1),
+			             _mm256_extractf128_ps(R[2], 1), _mm256_extractf128_ps(R[3], 1), Out + 4 * Stride, Stride, RowIndex);
+	}
+	for (u32 Lane = 0; Lane < 8; Lane++)
+	{
+		RCAST(mat_4*, Out + Lane * Stride)->Rows[3] = vec_4(0, 0, 0, 1);
+	}
+}
+#endif
+
+template <typename wide>
+inline static u32 RunGizmoTransforms(soa_vec_3 Origins, soa_vec_3 Tips, soa_vec_3 Rotations, char* Out, size_t OutStride,
+	                                 u32 Index, u32 Count, u32 LaneCount)
+{
+	const wide Zero         = WideSplat<wide>(0.0f);
+	const wide One          = WideSplat<wide>(1.0f);
+	const wide Half         = WideSplat<wide>(0.5f);
+	const wide DegToRadian  = WideSplat<wide>(F_PI / 180.0f);
+	const wide AlongZ       = WideSplat<wide>(1e-30f);
+
+	for (; Index + LaneCount <= Count; Index += LaneCount)
+	{
+		wide_vec_3<wide> Origin  = WideLoadVector<wide>(Origins, Index);
+		wide_vec_3<wide> Vector  = WideSubtractVectors(WideLoadVector<wide>(Tips, Index), Origin);
+		wide             Length  = WideSqrt(WideDot(Vector, Vector));
+		wide_vec_3<wide> Forward = { WideDiv(Vector.x, Length), WideDiv(Vector.y, Length), WideDiv(Vector.z, Length) };
+
+		// The mesh points along +Z; a vector along +Z or -Z is turned around +Y instead. Its cross
+		// product with +Z would be too short to normalize, so the test is on that length, not on
+		// Forward being exactly (0, 0, 1).
+		auto NotAlongZ = WideLess(AlongZ, WideAdd(WideMul(Forward.x, Forward.x), WideMul(Forward.y, Forward.y)));
+		wide_vec_3<wide> DefaultOrientation = { Zero, WideSelect(NotAlongZ, Zero, One), WideSelect(NotAlongZ, One, Zero) };
+
+		wide_vec_3<wide> Right = WideVectorProduct(DefaultOrientation, Forward);
+		Right                  = WideScale(Right, WideInvSqrt(WideDot(Right, Right)));
+		wide_vec_3<wide> Up    = WideVectorProduct(Forward, Right);
+
+		// QuatToMatrix(QuatFromEulerAngles(Rotation)) is Rz * Ry * Rx, built here from the full angles.
+		wide_vec_3<wide> Angles = WideLoadVector<wide>(Rotations, Index);
+		wide SinX, CosX, SinY, CosY, SinZ, CosZ;
+		WidePolicySinCos(WideMul(Angles.x, DegToRadian), &SinX, &CosX);
+		WidePolicySinCos(WideMul(Angles.y, DegToRadian), &SinY, &CosY);
+		WidePolicySinCos(WideMul(Angles.z, DegToRadian), &SinZ, &CosZ);
+
+		wide SinXSinY = WideMul(SinX, SinY);
+		wide CosXSinY = WideMul(CosX, SinY);
+		wide Euler[3][3] =
+		{
+			{ WideMul(CosY, CosZ), WideSub(WideMul(SinXSinY, CosZ), WideMul(CosX, SinZ)), WideAdd(WideMul(CosXSinY, CosZ), WideMul(SinX, SinZ)) },
+			{ WideMul(CosY, SinZ), WideAdd(WideMul(SinXSinY, SinZ), WideMul(CosX, CosZ)), WideSub(WideMul(CosXSinY, SinZ), WideMul(SinX, CosZ)) },
+			{ WideNegate(SinY),    WideMul(SinX, CosY),                                   WideMul(CosX, CosY) },
+		};
+
+		// Translation * (Right, Up, Forward) * Euler * Scale(1, 1, Length).
+		wide Basis[3][3] =
+		{
+			{ Right.x, Up.x, Forward.x },
+			{ Right.y, Up.y, Forward.y },
+			{ Right.z, Up.z, Forward.z },
+		};
+		wide Translation[3] =
+		{
+			WideAdd(WideMul(Vector.x, Half), Origin.x),
+			WideAdd(WideMul(Vector.y, Half), Origin.y),
+			WideAdd(WideMul(Vector.z, Half), Origin.z),
+		};
+
+		wide Rows[3][4];
+		for (u32 Row = 0; Row < 3; Row++)
+		{
+			for (u32 Column = 0; Column < 3; Column++)
+			{
+				Rows[Row][Column] = WideAdd(WideAdd(WideMul(Basis[Row][0], Euler[0][Column]), WideMul(Basis[Row][1], Euler[1][Column])),
+					                        WideMul(Basis[Row][2], Euler[2][Column]));
+			}
+			Rows[Row][2] = WideMul(Rows[Row][2], Length);
+			Rows[Row][3] = Translation[Row];
+		}
+
+		StoreWideMatrices(Rows, Out + Index * OutStride, OutStride);
+	}
+	return Index;
+}
+
+// Gizmo transforms of the vectors going from Origins to Tips: the +Z mesh turned onto the vector,
+// turned again by the Euler angles in Rotations (degrees), scaled to the vector's length and
+// centered on its midpoint. Sine and cosine follow the precision policy, see WidePolicySinCos. Out is
+// written with a byte stride, like ComposeTransforms, so it can be instance data.
+inline static void BuildGizmoTransforms(soa_vec_3 Origins, soa_vec_3 Tips, soa_vec_3 Rotations, mat_4* Out, size_t OutStride, u32 Count)
+{
+	char* OutBytes = RCAST(char*, Out);
+	u32   Index    = 0;
+#if MATH_SIMD_AVX
+	Index = RunGizmoTransforms<__m256>(Origins, Tips, Rotations, OutBytes, OutStride, Index, Count, 8);
+#endif
+#if MATH_SIMD_SSE2
+	Index = RunGizmoTransforms<__m128>(Origins, Tips, Rotations, OutBytes, OutStride, Index, Count, 4);
+#endif
+	RunGizmoTransforms<f32>(Origins, Tips, Rotations, OutBytes, OutStride, Index, Count, 1);
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cmath>
+
+#include "utility/types.h"
+#include "simd.hpp"
+#include "precision.hpp"
+
+// constexpr replacements for the libm calls the math library needs. They are only used
+// while the compiler evaluates a constant expression; at run time the wrappers below call
+// sqrtf/sinf/cosf/tanf as before. Everything is computed in f64 and rounded once, so the
+// compile-time results are within an ulp of the exact run-time ones.
+
+constexpr f64 CONST_TWO_PI = 6.283185307179586;
+
+constexpr f64 ConstSqrt(f64 Value)
+{
+	if (!(Value > 0))
+	{
+		return Value == 0 ? 0.0 : NAN;
+	}
+
+	f64 Estimate = Value >= 1 ? Value : 1.0;
+	for (u32 Iteration = 0; Iteration < 128; Iteration++)
+	{
+		f64 Next = 0.5 * (Estimate + Value / Estimate);
+		if (Next >= Estimate)
+		{
+			break;
+		}
+		Estimate = Next;
+	}
+	return Estimate;
+}
+
+// Reduces to [-pi, pi] and sums the Taylor series until the terms stop contributing.
+constexpr f64 ConstSin(f64 Angle)
+{
+	f64 Turns   = Angle / CONST_TWO_PI;
+	i64 Rounded = (i64)(Turns + (Turns >= 0 ? 0.5 : -0.5));
+	f64 x       = Angle - (f64)Rounded * CONST_TWO_PI;
+
+	f64 Term   = x;
+	f64 Result = x;
+	for (u32 n = 1; n < 20; n++)
+	{
+		Term   *= -(x * x) / (f64)((2 * n) * (2 * n + 1));
+		Result += Term;
+	}
+	return Result;
+}
+
+constexpr f64 ConstCos(f64 Angle)
+{
+	return ConstSin(Angle + CONST_TWO_PI / 4);
+}
+
+constexpr f32 SquareRoot(f32 Value)
+{
+	return MATH_CONSTANT_EVALUATED() ? (f32)ConstSqrt(Value) : sqrtf(Value);
+}
+
+constexpr f64 SquareRoot(f64 Value)
+{
+	return MATH_CONSTANT_EVALUATED() ? ConstSqrt(Value) : sqrt(Value);
+}
+
+constexpr f32 InverseSquareRoot(f32 Value)
+{
+	return MATH_CONSTANT_EVALUATED() ? (f32)(1.0 / ConstSqrt(Value)) : MATH_PRECISION_FAST ? FastInvSqrt(Value) : 1.0f / sqrtf(Value);
+}
+
+constexpr f32 Sine(f32 Angle)
+{
+	return MATH_CONSTANT_EVALUATED() ? (f32)ConstSin(Angle) : MATH_PRECISION_FAST ? FastSin(Angle) : sinf(Angle);
+}
+
+constexpr f32 Cosine(f32 Angle)
+{
+	return MATH_CONSTANT_EVALUATED() ? (f32)ConstCos(Angle) : MATH_PRECISION_FAST ? FastCos(Angle) : cosf(Angle);
+}
+
+constexpr f32 Tangent(f32 Angle)
+{
+	return MATH_CONSTANT_EVALUATED() ? (f32)(ConstSin(Angle) / ConstCos(Angle)) : MATH_PRECISION_FAST ? FastTan(Angle) : tanf(Angle);
+}
\ No newline at end of file
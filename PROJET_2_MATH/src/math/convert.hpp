@@ -0,0 +1,259 @@
+#pragma once
+
+#include <string.h>
+
+#include "vector.hpp"
+
+// Conversions between the f32 compute type and the f64 / f16 storage types. The array
+// kernels run 8 lanes with AVX (F16C for halves) and 4 with SSE2; the tails are scalar.
+// Halves round to nearest even; overflow gives infinity and NaN stays NaN.
+
+inline static u32 F32Bits(f32 Value)
+{
+	u32 Bits = 0;
+	memcpy(&Bits, &Value, sizeof(Bits));
+	return Bits;
+}
+
+inline static f32 F32FromBits(u32 Bits)
+{
+	f32 Value = 0;
+	memcpy(&Value, &Bits, sizeof(Value));
+	return Value;
+}
+
+inline static f16 F32ToF16(f32 Value)
+{
+	u32 Bits = F32Bits(Value);
+	u32 Sign = Bits & 0x80000000u;
+	Bits    ^= Sign;
+
+	u32 Half = 0;
+	if (Bits >= 0x47800000u)
+	{
+		// Too large for a half, infinity or NaN.
+		Half = Bits > 0x7f800000u ? 0x7e00 : 0x7c00;
+	}
+	else if (Bits < 0x38800000u)
+	{
+		// Subnormal half or zero: let the float adder shift and round.
+		Half = F32Bits(F32FromBits(Bits) + 0.5f) - 0x3f000000u;
+	}
+	else
+	{
+		u32 MantissaOdd = (Bits >> 13) & 1;
+		Bits           += 0xc8000fffu + MantissaOdd;
+		Half            = Bits >> 13;
+	}
+
+	f16 Result = { SCAST(u16, Half | (Sign >> 16)) };
+	return Result;
+}
+
+inline static f32 F16ToF32(f16 Value)
+{
+	u32 Bits     = SCAST(u32, Value.Bits & 0x7fff) << 13;
+	u32 Exponent = Bits & (0x7c00u << 13);
+	Bits        += (127 - 15) << 23;
+
+	if (Exponent == (0x7c00u << 13))
+	{
+		Bits += (128 - 16) << 23;
+	}
+	else if (Exponent == 0)
+	{
+		Bits = F32Bits(F32FromBits(Bits + (1 << 23)) - F32FromBits(113 << 23));
+	}
+
+	return F32FromBits(Bits | (SCAST(u32, Value.Bits & 0x8000) << 16));
+}
+
+#if MATH_SIMD_SSE2
+// Same steps as F32ToF16, four lanes at a time. Returns the halves in the low 64 bits.
+inline static __m128i F32ToF16x4(__m128 Value)
+{
+	__m128i Bits = _mm_castps_si128(Value);
+	__m128i Sign = _mm_and_si128(Bits, _mm_set1_epi32(SCAST(i32, 0x80000000u)));
+	Bits         = _mm_xor_si128(Bits, Sign);
+
+	__m128i NaNMask    = _mm_cmpgt_epi32(Bits, _mm_set1_epi32(0x7f800000));
+	__m128i InfNaN     = _mm_or_si128(_mm_and_si128(NaNMask, _mm_set1_epi32(0x7e00)),
+		                              _mm_andnot_si128(NaNMask, _mm_set1_epi32(0x7c00)));
+	__m128i HugeMask   = _mm_cmpgt_epi32(Bits, _mm_set1_epi32(0x477fffff));
+	__m128i TinyMask   = _mm_cmplt_epi32(Bits, _mm_set1_epi32(0x38800000));
+	__m128i Subnormal  = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(Bits), _mm_set1_ps(0.5f))),
+		                               _mm_set1_epi32(0x3f000000));
+	__m128i MantissaOdd = _mm_and_si128(_mm_srli_epi32(Bits, 13), _mm_set1_epi32(1));
+	__m128i Normal      = _mm_add_epi32(_mm_add_epi32(Bits, _mm_set1_epi32(SCAST(i32, 0xc8000fffu))), MantissaOdd);
+	Normal              = _mm_srli_epi32(Normal, 13);
+
+	__m128i Half = _mm_or_si128(_mm_and_si128(TinyMask, Subnormal), _mm_andnot_si128(TinyMask, Normal));
+	Half         = _mm_or_si128(_mm_and_si128(HugeMask, InfNaN), _mm_andnot_si128(HugeMask, Half));
+	Half         = _mm_or_si128(Half, _mm_srli_epi32(Sign, 16));
+
+	// Sign-extend from 16 bits so the signed saturating pack keeps every bit pattern.
+	Half = _mm_srai_epi32(_mm_slli_epi32(Half, 16), 16);
+	return _mm_packs_epi32(Half, Half);
+}
+
+// Same steps as F16ToF32, for the four halves in the low 64 bits.
+inline static __m128 F16ToF32x4(__m128i Value)
+{
+	__m128i Halves   = _mm_unpacklo_epi16(Value, _mm_setzero_si128());
+	__m128i Bits     = _mm_slli_epi32(_mm_and_si128(Halves, _mm_set1_epi32(0x7fff)), 13);
+	__m128i Exponent = _mm_and_si128(Bits, _mm_set1_epi32(0x7c00 << 13));
+	Bits             = _mm_add_epi32(Bits, _mm_set1_epi32((127 - 15) << 23));
+
+	__m128i InfNaNMask = _mm_cmpeq_epi32(Exponent, _mm_set1_epi32(0x7c00 << 13));
+	Bits               = _mm_add_epi32(Bits, _mm_and_si128(InfNaNMask, _mm_set1_epi32((128 - 16) << 23)));
+
+	__m128i SubnormalMask = _mm_cmpeq_epi32(Exponent, _mm_setzero_si128());
+	__m128  Subnormal     = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(Bits, _mm_set1_epi32(1 << 23))),
+		                               _mm_castsi128_ps(_mm_set1_epi32(113 << 23)));
+	Bits                  = _mm_or_si128(_mm_and_si128(SubnormalMask, _mm_castps_si128(Subnormal)),
+		                                 _mm_andnot_si128(SubnormalMask, Bits));
+
+	__m128i Sign = _mm_slli_epi32(_mm_and_si128(Halves, _mm_set1_epi32(0x8000)), 16);
+	return _mm_castsi128_ps(_mm_or_si128(Bits, Sign));
+}
+#endif
+
+inline static void ConvertF32ToF16(const f32* In, f16* Out, size_t Count)
+{
+	size_t Index = 0;
+
+#if MATH_SIMD_F16C
+	for (; Index + 8 <= Count; Index += 8)
+	{
+		__m128i Halves = _mm256_cvtps_ph(_mm256_loadu_ps(In + Index), _MM_FROUND_TO_NEAREST_INT);
+		_mm_storeu_si128(RCAST(__m128i*, Out + Index), Halves);
+	}
+#endif
+
+#if MATH_SIMD_SSE2
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		_mm_storel_epi64(RCAST(__m128i*, Out + Index), F32ToF16x4(_mm_loadu_ps(In + Index)));
+	}
+#endif
+
+	for (; Index < Count; Index++)
+	{
+		Out[Index] = F32ToF16(In[Index]);
+	}
+}
+
+inline static void ConvertF16ToF32(const f16* In, f32* Out, size_t Count)
+{
+	size_t Index = 0;
+
+#if MATH_SIMD_F16C
+	for (; Index + 8 <= Count; Index += 8)
+	{
+		__m128i Halves = _mm_loadu_si128(RCAST(const __m128i*, In + Index));
+		_mm256_storeu_ps(Out + Index, _mm256_cvtph_ps(Halves));
+	}
+#endif
+
+#if MATH_SIMD_SSE2
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		_mm_storeu_ps(Out + Index, F16ToF32x4(_mm_loadl_epi64(RCAST(const __m128i*, In + Index))));
+	}
+#endif
+
+	for (; Index < Count; Index++)
+	{
+		Out[Index] = F16ToF32(In[Index]);
+	}
+}
+
+inline static void ConvertF32ToF64(const f32* In, f64* Out, size_t Count)
+{
+	size_t Index = 0;
+
+#if MATH_SIMD_AVX
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		_mm256_storeu_pd(Out + Index, _mm256_cvtps_pd(_mm_loadu_ps(In + Index)));
+	}
+#elif MATH_SIMD_SSE2
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		__m128 Value = _mm_loadu_ps(In + Index);
+		_mm_storeu_pd(Out + Index + 0, _mm_cvtps_pd(Value));
+		_mm_storeu_pd(Out + Index + 2, _mm_cvtps_pd(_mm_movehl_ps(Value, Value)));
+	}
+#endif
+
+	for (; Index < Count; Index++)
+	{
+		Out[Index] = SCAST(f64, In[Index]);
+	}
+}
+
+inline static void ConvertF64ToF32(const f64* In, f32* Out, size_t Count)
+{
+	size_t Index = 0;
+
+#if MATH_SIMD_AVX
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		_mm_storeu_ps(Out + Index, _mm256_cvtpd_ps(_mm256_loadu_pd(In + Index)));
+	}
+#elif MATH_SIMD_SSE2
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		__m128 Low  = _mm_cvtpd_ps(_mm_loadu_pd(In + Index + 0));
+		__m128 High = _mm_cvtpd_ps(_mm_loadu_pd(In + Index + 2));
+		_mm_storeu_ps(Out + Index, _mm_movelh_ps(Low, High));
+	}
+#endif
+
+	for (; Index < Count; Index++)
+	{
+		Out[Index] = SCAST(f32, In[Index]);
+	}
+}
+
+// Arrays of vectors are packed, so they convert as one flat stream of Count * N components.
+
+template <u32 N>
+inline static void ConvertVectors(const vec<f32, N>* In, vec<f16, N>* Out, size_t Count)
+{
+	ConvertF32ToF16(RCAST(const f32*, In), RCAST(f16*, Out), Count * N);
+}
+
+template <u32 N>
+inline static void ConvertVectors(const vec<f16, N>* In, vec<f32, N>* Out, size_t Count)
+{
+	ConvertF16ToF32(RCAST(const f16*, In), RCAST(f32*, Out), Count * N);
+}
+
+template <u32 N>
+inline static void ConvertVectors(const vec<f32, N>* In, vec<f64, N>* Out, size_t Count)
+{
+	ConvertF32ToF64(RCAST(const f32*, In), RCAST(f64*, Out), Count * N);
+}
+
+template <u32 N>
+inline static void ConvertVectors(const vec<f64, N>* In, vec<f32, N>* Out, size_t Count)
+{
+	ConvertF64ToF32(RCAST(const f64*, In), RCAST(f32*, Out), Count * N);
+}
+
+template <u32 N>
+inline static vec<f16, N> VectorToHalf(vec<f32, N> v)
+{
+	vec<f16, N> Result;
+	ConvertVectors(&v, &Result, 1);
+	return Result;
+}
+
+template <u32 N>
+inline static vec<f32, N> VectorFromHalf(vec<f16, N> v)
+{
+	vec<f32, N> Result;
+	ConvertVectors(&v, &Result, 1);
+	return Result;
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "vector.hpp"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// Signed Q32.32 fixed point: the value is Raw / 2^32, for a range of +-2^31 and a resolution
+// of 2.3e-10. Every operation below is integer arithmetic with a fixed rounding, so the results
+// are bit-identical whatever the compiler, optimization level or instruction set. The arithmetic
+// wraps on overflow. Conversions from floating point truncate toward zero, which every compiler
+// does the same way, so constants and UI inputs enter the simulation identically everywhere.
+
+constexpr i64 FIXED_ONE = SCAST(i64, 1) << 32;
+
+struct q32_32
+{
+	i64 Raw;
+
+	q32_32() = default;
+	constexpr explicit q32_32(f32 Value) : Raw(SCAST(i64, SCAST(f64, Value) * FIXED_ONE)) {}
+	constexpr explicit q32_32(f64 Value) : Raw(SCAST(i64, Value * FIXED_ONE)) {}
+
+	// For display and rendering only: the simulation itself never goes back through floats.
+	constexpr explicit operator f32() const { return SCAST(f32, SCAST(f64, Raw) / FIXED_ONE); }
+	constexpr explicit operator f64() const { return SCAST(f64, Raw) / FIXED_ONE; }
+};
+
+typedef vec<q32_32, 2> vec_2_q32;
+typedef vec<q32_32, 3> vec_3_q32;
+typedef vec<q32_32, 4> vec_4_q32;
+
+static_assert(sizeof(vec_3_q32) == 3 * sizeof(i64), "vec must stay packed");
+
+static constexpr q32_32 FixedFromRaw(i64 Raw)
+{
+	q32_32 Result = {};
+	Result.Raw    = Raw;
+	return Result;
+}
+
+// Signed overflow is undefined, so the sums go through u64, which wraps.
+static constexpr q32_32 operator+(q32_32 Left, q32_32 Right)
+{
+	return FixedFromRaw(SCAST(i64, SCAST(u64, Left.Raw) + SCAST(u64, Right.Raw)));
+}
+
+static constexpr q32_32 operator-(q32_32 Left, q32_32 Right)
+{
+	return FixedFromRaw(SCAST(i64, SCAST(u64, Left.Raw) - SCAST(u64, Right.Raw)));
+}
+
+static constexpr q32_32 operator-(q32_32 Value)
+{
+	return FixedFromRaw(SCAST(i64, SCAST(u64, 0) - SCAST(u64, Value.Raw)));
+}
+
+// (Left * Right) / 2^32 rounded to nearest, from four 32 x 32 partial products. Writing each
+// operand as High * 2^32 + Low, with High signed and Low unsigned, only the Low * Low term has
+// bits below 2^32, so the rounding is applied to it alone.
+static constexpr q32_32 operator*(q32_32 Left, q32_32 Right)
+{
+	u64 LeftHigh  = SCAST(u64, Left.Raw >> 32);
+	u64 LeftLow   = SCAST(u64, Left.Raw) & 0xFFFFFFFFu;
+	u64 RightHigh = SCAST(u64, Right.Raw >> 32);
+	u64 RightLow  = SCAST(u64, Right.Raw) & 0xFFFFFFFFu;
+
+	u64 Result = ((LeftHigh * RightHigh) << 32) + LeftHigh * RightLow + LeftLow * RightHigh +
+		         ((LeftLow * RightLow + 0x80000000u) >> 32);
+	return FixedFromRaw(SCAST(i64, Result));
+}
+
+// (Numerator * 2^32) / Divisor, truncated, with the low 64 bits of the quotient and the remainder.
+// One 128 / 64 divide where the compiler has one: __int128 on GCC and Clang, _udiv128 on x64 MSVC
+// when the quotient fits in 64 bits. Otherwise long division: the integer part first, then one bit
+// of fraction per step, which gives the same bits.
+static constexpr u64 DivideShiftedFixed(u64 Numerator, u64 Divisor, u64* OutRemainder)
+{
+#if defined(__SIZEOF_INT128__)
+	unsigned __int128 Shifted = SCAST(unsigned __int128, Numerator) << 32;
+	*OutRemainder             = SCAST(u64, Shifted % Divisor);
+	return SCAST(u64, Shifted / Divisor);
+#else
+#if defined(_MSC_VER) && defined(_M_X64) && _MSC_VER >= 1925
+	if (!MATH_CONSTANT_EVALUATED() && (Numerator >> 32) < Divisor)
+	{
+		return _udiv128(Numerator >> 32, Numerator << 32, Divisor, OutRemainder);
+	}
+#endif
+
+	u64 Quotient  = Numerator / Divisor;
+	u64 Remainder = Numerator % Divisor;
+	for (u32 Bit = 0; Bit < 32; Bit++)
+	{
+		bool Carry = (Remainder >> 63) != 0;
+		Remainder <<= 1;
+		Quotient  <<= 1;
+		if (Carry || Remainder >= Divisor)
+		{
+			Remainder -= Divisor;
+			Quotient  |= 1;
+		}
+	}
+	*OutRemainder = Remainder;
+	return Quotient;
+#endif
+}
+
+// (Left * 2^32) / Right rounded to nearest. Dividing by zero saturates toward the sign of Left.
+static constexpr q32_32 operator/(q32_32 Left, q32_32 Right)
+{
+	if (Right.Raw == 0)
+	{
+		return FixedFromRaw(Left.Raw < 0 ? INT64_MIN : INT64_MAX);
+	}
+
+	bool Negative  = (Left.Raw < 0) != (Right.Raw < 0);
+	u64  Numerator = Left.Raw < 0 ? SCAST(u64, 0) - SCAST(u64, Left.Raw) : SCAST(u64, Left.Raw);
+	u64  Divisor   = Right.Raw < 0 ? SCAST(u64, 0) - SCAST(u64, Right.Raw) : SCAST(u64, Right.Raw);
+
+	u64 Remainder = 0;
+	u64 Quotient  = DivideShiftedFixed(Numerator, Divisor, &Remainder);
+	if (Remainder >= Divisor - Remainder)
+	{
+		Quotient += 1;
+	}
+
+	return FixedFromRaw(SCAST(i64, Negative ? SCAST(u64, 0) - Quotient : Quotient));
+}
+
+static constexpr q32_32& operator+=(q32_32& Left, q32_32 Right) { Left = Left + Right; return Left; }
+static constexpr q32_32& operator-=(q32_32& Left, q32_32 Right) { Left = Left - Right; return Left; }
+
+static constexpr bool operator==(q32_32 Left, q32_32 Right) { return Left.Raw == Right.Raw; }
+static constexpr bool operator!=(q32_32 Left, q32_32 Right) { return Left.Raw != Right.Raw; }
+static constexpr bool operator<(q32_32 Left, q32_32 Right)  { return Left.Raw < Right.Raw; }
+static constexpr bool operator<=(q32_32 Left, q32_32 Right) { return Left.Raw <= Right.Raw; }
+static constexpr bool operator>(q32_32 Left, q32_32 Right)  { return Left.Raw > Right.Raw; }
+static constexpr bool operator>=(q32_32 Left, q32_32 Right) { return Left.Raw >= Right.Raw; }
+
+// Newton's iteration from above, like ConstSqrt: it decreases until it reaches the rounded root.
+// Negative values return 0.
+static constexpr q32_32 SquareRoot(q32_32 Value)
+{
+	if (Value.Raw <= 0)
+	{
+		return FixedFromRaw(0);
+	}
+
+	q32_32 Estimate = Value.Raw >= FIXED_ONE ? Value : FixedFromRaw(FIXED_ONE);
+	for (u32 Iteration = 0; Iteration < 128; Iteration++)
+	{
+		q32_32 Next = FixedFromRaw((Estimate + Value / Estimate).Raw >> 1);
+		if (Next >= Estimate)
+		{
+			break;
+		}
+		Estimate = Next;
+	}
+	return Estimate;
+}
+
+// The generic versions start their sums from a literal 0, which q32_32 does not convert from.
+static constexpr q32_32 Dot(vec_3_q32 vl, vec_3_q32 vr)
+{
+	return vl.x * vr.x + vl.y * vr.y + vl.z * vr.z;
+}
+
+static constexpr q32_32 VectorLength(vec_3_q32 v)
+{
+	return SquareRoot(Dot(v, v));
+}
+
+static constexpr vec_3_q32 Normalize(vec_3_q32 v)
+{
+	return v / VectorLength(v);
+}
+
+static_assert(q32_32(1.5f) * q32_32(-2.0f) == q32_32(-3.0f), "Fixed");
+static_assert(q32_32(-3.0f) / q32_32(2.0f) == q32_32(-1.5f), "Fixed");
+static_assert(q32_32(1.0f) / q32_32(3.0f) == FixedFromRaw(1431655765), "Fixed");
+static_assert(SquareRoot(q32_32(16.0f)) == q32_32(4.0f) && SquareRoot(q32_32(0.25f)) == q32_32(0.5f), "Fixed");
+static_assert(SCAST(u64, (Normalize(vec_3_q32(q32_32(3.0f), q32_32(0.0f), q32_32(4.0f))).z - q32_32(0.8)).Raw + 1) <= 2, "Fixed");
\ No newline at end of file
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "batch.hpp"
+
+// View frustum as six planes (Normal.x, Normal.y, Normal.z, Distance) pointing inwards:
+// a point p is inside a plane when Dot(Normal, p) + Distance >= 0. The normals are unit
+// length, so the same value is the signed distance to the plane in world units.
+
+enum FRUSTUM_PLANE
+{
+	FRUSTUM_PLANE_LEFT,
+	FRUSTUM_PLANE_RIGHT,
+	FRUSTUM_PLANE_BOTTOM,
+	FRUSTUM_PLANE_TOP,
+	FRUSTUM_PLANE_NEAR,
+	FRUSTUM_PLANE_FAR,
+
+	FRUSTUM_PLANE_COUNT
+};
+
+struct frustum
+{
+	vec_4 Planes[FRUSTUM_PLANE_COUNT];
+};
+
+static constexpr vec_4 NormalizePlane(vec_4 Plane)
+{
+	f32 Length = SquareRoot(Plane.x * Plane.x + Plane.y * Plane.y + Plane.z * Plane.z);
+	return Length != 0 ? Plane / Length : Plane;
+}
+
+// Gribb-Hartmann extraction from a Projection * View matrix (column vectors, clip = m * p).
+// The near plane is z >= 0, the D3D clip volume the backend renders with.
+static constexpr frustum ExtractFrustumPlanes(mat_4 ViewProjection)
+{
+	vec_4 Row0 = ViewProjection.Rows[0];
+	vec_4 Row1 = ViewProjection.Rows[1];
+	vec_4 Row2 = ViewProjection.Rows[2];
+	vec_4 Row3 = ViewProjection.Rows[3];
+
+	frustum Frustum = {};
+	Frustum.Planes[FRUSTUM_PLANE_LEFT]   = NormalizePlane(Row3 + Row0);
+	Frustum.Planes[FRUSTUM_PLANE_RIGHT]  = NormalizePlane(Row3 - Row0);
+	Frustum.Planes[FRUSTUM_PLANE_BOTTOM] = NormalizePlane(Row3 + Row1);
+	Frustum.Planes[FRUSTUM_PLANE_TOP]    = NormalizePlane(Row3 - Row1);
+	Frustum.Planes[FRUSTUM_PLANE_NEAR]   = NormalizePlane(Row2);
+	Frustum.Planes[FRUSTUM_PLANE_FAR]    = NormalizePlane(Row3 - Row2);
+	return Frustum;
+}
+
+static constexpr f32 PlaneDistance(vec_4 Plane, vec_3 Point)
+{
+	return Plane.x * Point.x + Plane.y * Point.y + Plane.z * Point.z + Plane.w;
+}
+
+// Conservative: a sphere crossing two planes outside a corner still counts as visible.
+static constexpr bool IsSphereInFrustum(const frustum& Frustum, vec_3 Center, f32 Radius)
+{
+	for (u32 PlaneIndex = 0; PlaneIndex < FRUSTUM_PLANE_COUNT; PlaneIndex++)
+	{
+		if (PlaneDistance(Frustum.Planes[PlaneIndex], Center) + Radius < 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Axis-aligned box given by its center and half extents. Same conservative test as the sphere,
+// with the box's extent along each plane normal as the radius.
+static constexpr bool IsBoxInFrustum(const frustum& Frustum, vec_3 Center, vec_3 HalfExtents)
+{
+	for (u32 PlaneIndex = 0; PlaneIndex < FRUSTUM_PLANE_COUNT; PlaneIndex++)
+	{
+		vec_4 Plane = Frustum.Planes[PlaneIndex];
+		f32 Radius  = (Plane.x < 0 ? -Plane.x : Plane.x) * HalfExtents.x +
+			          (Plane.y < 0 ? -Plane.y : Plane.y) * HalfExtents.y +
+			          (Plane.z < 0 ? -Plane.z : Plane.z) * HalfExtents.z;
+		if (PlaneDistance(Plane, Center) + Radius < 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+// ==================================================================================
+// Batched culling over SoA bounds, on the wide-lane layer of batch.hpp. Each call writes the
+// indices of the visible elements, in order, to VisibleIndices (room for Count entries) and
+// returns how many there are. The compaction is branch-free: every lane writes its index and
+// only advances the output when it is visible.
+
+// Bit i set when lane i of Value is negative.
+inline static u32 WideNegativeMask(f32 Value) { return Value < 0 ? 1u : 0u; }
+#if MATH_SIMD_SSE2
+inline static u32 WideNegativeMask(__m128 Value) { return SCAST(u32, _mm_movemask_ps(_mm_cmplt_ps(Value, _mm_setzero_ps()))); }
+#endif
+#if MATH_SIMD_AVX
+inline static u32 WideNegativeMask(__m256 Value)
+{
+	return SCAST(u32, _mm256_movemask_ps(_mm256_cmp_ps(Value, _mm256_setzero_ps(), _CMP_LT_OQ)));
+}
+#endif
+
+template <typename wide>
+struct wide_plane
+{
+	wide_vec_3<wide> Normal;
+	wide_vec_3<wide> AbsNormal;
+	wide             Distance;
+};
+
+// radius_fn(AbsNormal, Index) returns the lanes' extent along the plane normal.
+template <typename wide, typename radius_fn>
+inline static u32 RunFrustumCull(const frustum& Frustum, soa_vec_3 Centers, radius_fn Radius, u32 Index, u32 Count,
+	                             u32 LaneCount, u32* VisibleIndices, u32* VisibleCount)
+{
+	wide_plane<wide> Planes[FRUSTUM_PLANE_COUNT];
+	for (u32 PlaneIndex = 0; PlaneIndex < FRUSTUM_PLANE_COUNT; PlaneIndex++)
+	{
+		vec_4 Plane = Frustum.Planes[PlaneIndex];
+		Planes[PlaneIndex].Normal    = { WideSplat<wide>(Plane.x), WideSplat<wide>(Plane.y), WideSplat<wide>(Plane.z) };
+		Planes[PlaneIndex].AbsNormal = { WideSplat<wide>(Plane.x < 0 ? -Plane.x : Plane.x),
+			                             WideSplat<wide>(Plane.y < 0 ? -Plane.y : Plane.y),
+			                             WideSplat<wide>(Plane.z < 0 ? -Plane.z : Plane.z) };
+		Planes[PlaneIndex].Distance  = WideSplat<wide>(Plane.w);
+	}
+
+	u32 Visible = *VisibleCount;
+	for (; Index + LaneCount <= Count; Index += LaneCount)
+	{
+		wide_vec_3<wide> Center = WideLoadVector<wide>(Centers, Index);
+		u32 OutsideMask         = 0;
+
+		for (u32 PlaneIndex = 0; PlaneIndex < FRUSTUM_PLANE_COUNT; PlaneIndex++)
+		{
+			wide_plane<wide>* Plane = &Planes[PlaneIndex];
+			wide Distance = WideAdd(WideDot(Plane->Normal, Center), Plane->Distance);
+			OutsideMask  |= WideNegativeMask(WideAdd(Distance, Radius(Plane->AbsNormal, Index)));
+		}
+
+		for (u32 Lane = 0; Lane < LaneCount; Lane++)
+		{
+			VisibleIndices[Visible] = Index + Lane;
+			Visible                += ((OutsideMask >> Lane) & 1) ^ 1;
+		}
+	}
+
+	*VisibleCount = Visible;
+	return Index;
+}
+
+template <typename radius_fn>
+inline static u32 BatchFrustumCull(const frustum& Frustum, soa_vec_3 Centers, radius_fn Radius, u32 Count, u32* VisibleIndices)
+{
+	u32 Index        = 0;
+	u32 VisibleCount = 0;
+#if MATH_SIMD_AVX
+	Index = RunFrustumCull<__m256>(Frustum, Centers, Radius, Index, Count, 8, VisibleIndices, &VisibleCount);
+#endif
+#if MATH_SIMD_SSE2
+	Index = RunFrustumCull<__m128>(Frustum, Centers, Radius, Index, Count, 4, VisibleIndices, &VisibleCount);
+#endif
+	RunFrustumCull<f32>(Frustum, Centers, Radius, Index, Count, 1, VisibleIndices, &VisibleCount);
+	return VisibleCount;
+}
+
+// Spheres of center Centers[i] and radius Radii[i].
+inline static u32 CullSpheres(const frustum& Frustum, soa_vec_3 Centers, const f32* Radii, u32 Count, u32* VisibleIndices)
+{
+	return BatchFrustumCull(Frustum, Centers,
+		                    [Radii](auto AbsNormal, u32 Index) { return WideLoad<decltype(AbsNormal.x)>(Radii + Index); },
+		                    Count, VisibleIndices);
+}
+
+// Axis-aligned boxes of center Centers[i]. With BATCH_BROADCAST_B, HalfExtents holds one
+// extent shared by every box; otherwise it holds one per box.
+inline static u32 CullBoxes(const frustum& Frustum, soa_vec_3 Centers, soa_vec_3 HalfExtents, u32 Count, u32* VisibleIndices,
+	                        u32 Broadcast = BATCH_BROADCAST_NONE)
+{
+	return BatchFrustumCull(Frustum, Centers,
+		                    [HalfExtents, Broadcast](auto AbsNormal, u32 Index)
+		                    {
+			                    typedef decltype(AbsNormal.x) wide;
+			                    wide_vec_3<wide> Extents = (Broadcast & BATCH_BROADCAST_B) ? WideSplatVector<wide>(HalfExtents)
+				                                                                       : WideLoadVector<wide>(HalfExtents, Index);
+			                    return WideDot(AbsNormal, Extents);
+		                    },
+		                    Count, VisibleIndices);
+}
+
+static_assert(IsSphereInFrustum(ExtractFrustumPlanes(ProjectionMatrix(90, 1, 0.1f, 100)), vec_3(0, 0, 10), 1), "Frustum");
+static_assert(!IsSphereInFrustum(ExtractFrustumPlanes(ProjectionMatrix(90, 1, 0.1f, 100)), vec_3(0, 0, -10), 1), "Frustum");
+static_assert(!IsBoxInFrustum(ExtractFrustumPlanes(ProjectionMatrix(90, 1, 0.1f, 100)), vec_3(20, 0, 10), vec_3(1, 1, 1)), "Frustum");
\ No newline at end of file
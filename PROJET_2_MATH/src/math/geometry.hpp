@@ -0,0 +1,424 @@
+#pragma once
+
+#include "batch.hpp"
+
+// Geometric primitives and intersection queries. Each query has a scalar version on vec_3 and
+// a batched version over SoA streams, on the wide-lane layer of batch.hpp (8 lanes on AVX, 4 on
+// SSE2, scalar tail). The batched versions follow the scalar math operation for operation, so
+// they agree up to FMA contraction of the scalar code.
+
+// Ray hit distances are in units of the ray's Direction; a miss reports GEOMETRY_NO_HIT.
+constexpr f32 GEOMETRY_NO_HIT   = -1.0f;
+constexpr f32 GEOMETRY_MAX_T    = 3.402823466e+38f;
+// Squared segment lengths below this are treated as points.
+constexpr f32 GEOMETRY_EPSILON  = 1e-12f;
+
+// Points Origin + t * Direction, t >= 0. Direction does not need to be unit length.
+struct ray
+{
+	vec_3 Origin;
+	vec_3 Direction;
+};
+
+struct aabb
+{
+	vec_3 Min;
+	vec_3 Max;
+};
+
+struct sphere
+{
+	vec_3 Center;
+	f32   Radius;
+};
+
+// Points p with Dot(Normal, p) + Distance == 0, the same convention as the frustum planes.
+struct plane
+{
+	vec_3 Normal;
+	f32   Distance;
+};
+
+struct segment
+{
+	vec_3 Start;
+	vec_3 End;
+};
+
+// Closest points Start + s * (End - Start) on each segment, s and t in [0, 1].
+struct segment_closest_points
+{
+	f32   s;
+	f32   t;
+	vec_3 PointA;
+	vec_3 PointB;
+	f32   DistanceSquared;
+};
+
+static constexpr vec_3 RayPoint(ray Ray, f32 t)
+{
+	return Ray.Origin + Ray.Direction * t;
+}
+
+static constexpr plane PlaneFromPointNormal(vec_3 Point, vec_3 Normal)
+{
+	plane Result    = {};
+	Result.Normal   = Normal;
+	Result.Distance = -Dot(Normal, Point);
+	return Result;
+}
+
+// Counter-clockwise triangle, seen from the side the normal points to.
+static constexpr plane PlaneFromTriangle(vec_3 a, vec_3 b, vec_3 c)
+{
+	vec_3 Normal = Normalize(VectorProduct(b - a, c - a));
+	return PlaneFromPointNormal(a, Normal);
+}
+
+static constexpr f32 SignedDistance(plane Plane, vec_3 Point)
+{
+	return Dot(Plane.Normal, Point) + Plane.Distance;
+}
+
+// Slab test. HitT is the entry distance, 0 when the ray starts inside the box. A ray parallel
+// to a slab and starting exactly on its boundary may go either way.
+static constexpr bool RayIntersectsAABB(ray Ray, aabb Box, f32* HitT)
+{
+	f32 Enter = 0;
+	f32 Exit  = GEOMETRY_MAX_T;
+	for (u32 Axis = 0; Axis < VEC_3_LENGTH; Axis++)
+	{
+		f32 InvDirection = 1.0f / Ray.Direction[Axis];
+		f32 t1           = (Box.Min[Axis] - Ray.Origin[Axis]) * InvDirection;
+		f32 t2           = (Box.Max[Axis] - Ray.Origin[Axis]) * InvDirection;
+
+		// Written so a NaN slab (0 * inf) keeps the previous bounds.
+		Enter = WideMax(WideMin(t1, t2), Enter);
+		Exit  = WideMin(WideMax(t1, t2), Exit);
+	}
+
+	bool Hit = Enter <= Exit;
+	*HitT    = Hit ? Enter : GEOMETRY_NO_HIT;
+	return Hit;
+}
+
+// Hits either side of the plane; a ray parallel to it never hits.
+static constexpr bool RayIntersectsPlane(ray Ray, plane Plane, f32* HitT)
+{
+	f32 Denominator = Dot(Plane.Normal, Ray.Direction);
+	f32 t           = -SignedDistance(Plane, Ray.Origin) / Denominator;
+
+	bool Hit = Denominator != 0 && 0 <= t;
+	*HitT    = Hit ? t : GEOMETRY_NO_HIT;
+	return Hit;
+}
+
+// HitT is the first intersection, 0 when the ray starts inside the sphere.
+static constexpr bool RayIntersectsSphere(ray Ray, sphere Sphere, f32* HitT)
+{
+	vec_3 m          = Ray.Origin - Sphere.Center;
+	f32 a            = Dot(Ray.Direction, Ray.Direction);
+	f32 b            = Dot(m, Ray.Direction);
+	f32 c            = Dot(m, m) - Sphere.Radius * Sphere.Radius;
+	f32 Discriminant = b * b - a * c;
+
+	// Outside and pointing away, or passing beside it.
+	if ((0 < c && 0 < b) || Discriminant < 0)
+	{
+		*HitT = GEOMETRY_NO_HIT;
+		return false;
+	}
+
+	*HitT = WideMax((-b - SquareRoot(Discriminant)) / a, 0.0f);
+	return true;
+}
+
+static constexpr f32 Clamp01(f32 Value)
+{
+	return WideMin(WideMax(Value, 0.0f), 1.0f);
+}
+
+// Closest points between two segments (Ericson, Real-Time Collision Detection 5.1.9).
+// Degenerate segments are handled as points.
+static constexpr segment_closest_points ClosestPointsSegmentSegment(segment A, segment B)
+{
+	vec_3 d1 = A.End - A.Start;
+	vec_3 d2 = B.End - B.Start;
+	vec_3 r  = A.Start - B.Start;
+	f32 a    = Dot(d1, d1);
+	f32 e    = Dot(d2, d2);
+	f32 f    = Dot(d2, r);
+	f32 c    = Dot(d1, r);
+	f32 b    = Dot(d1, d2);
+
+	f32 s = 0;
+	f32 t = 0;
+	if (a <= GEOMETRY_EPSILON && e <= GEOMETRY_EPSILON)
+	{
+		s = 0;
+		t = 0;
+	}
+	else if (a <= GEOMETRY_EPSILON)
+	{
+		s = 0;
+		t = Clamp01(f / e);
+	}
+	else if (e <= GEOMETRY_EPSILON)
+	{
+		s = Clamp01(-c / a);
+		t = 0;
+	}
+	else
+	{
+		// Parallel segments (Denominator == 0) start from A.Start.
+		f32 Denominator = a * e - b * b;
+		s = Denominator != 0 ? Clamp01((b * f - c * e) / Denominator) : 0.0f;
+		t = (b * s + f) / e;
+
+		if (t < 0)
+		{
+			t = 0;
+			s = Clamp01(-c / a);
+		}
+		else if (1 < t)
+		{
+			t = 1;
+			s = Clamp01((b - c) / a);
+		}
+	}
+
+	segment_closest_points Result = {};
+	Result.s                      = s;
+	Result.t                      = t;
+	Result.PointA                 = A.Start + d1 * s;
+	Result.PointB                 = B.Start + d2 * t;
+	Result.DistanceSquared        = Dot(Result.PointA - Result.PointB, Result.PointA - Result.PointB);
+	return Result;
+}
+
+// Touching boxes overlap.
+static constexpr bool AABBOverlap(aabb A, aabb B)
+{
+	return A.Min.x <= B.Max.x && B.Min.x <= A.Max.x &&
+		   A.Min.y <= B.Max.y && B.Min.y <= A.Max.y &&
+		   A.Min.z <= B.Max.z && B.Min.z <= A.Max.z;
+}
+
+
+// ==================================================================================
+// Batched queries. One primitive is tested against Count others stored as SoA streams, or two
+// segment streams are paired element by element.
+
+struct soa_aabb
+{
+	soa_vec_3 Min;
+	soa_vec_3 Max;
+};
+
+struct soa_sphere
+{
+	soa_vec_3 Centers;
+	f32*      Radii;
+};
+
+struct soa_plane
+{
+	soa_vec_3 Normals;
+	f32*      Distances;
+};
+
+struct soa_segment
+{
+	soa_vec_3 Starts;
+	soa_vec_3 Ends;
+};
+
+template <typename wide>
+inline static wide_vec_3<wide> WideSplatVector(vec_3 Vector)
+{
+	return { WideSplat<wide>(Vector.x), WideSplat<wide>(Vector.y), WideSplat<wide>(Vector.z) };
+}
+
+template <typename wide>
+inline static wide WideClamp01(wide Value)
+{
+	return WideMin(WideMax(Value, WideSplat<wide>(0.0f)), WideSplat<wide>(1.0f));
+}
+
+template <typename wide, typename kernel_fn>
+inline static u32 RunGeometryKernel(kernel_fn Kernel, u32 Index, u32 Count, u32 LaneCount)
+{
+	for (; Index + LaneCount <= Count; Index += LaneCount)
+	{
+		Kernel(wide(), Index);
+	}
+	return Index;
+}
+
+// Calls Kernel(Lane, Index) for each group of lanes; Lane is only there to give the lane type.
+template <typename kernel_fn>
+inline static void BatchGeometryKernel(kernel_fn Kernel, u32 Count)
+{
+	u32 Index = 0;
+#if MATH_SIMD_AVX
+	Index = RunGeometryKernel<__m256>(Kernel, Index, Count, 8);
+#endif
+#if MATH_SIMD_SSE2
+	Index = RunGeometryKernel<__m128>(Kernel, Index, Count, 4);
+#endif
+	RunGeometryKernel<f32>(Kernel, Index, Count, 1);
+}
+
+// HitT[i] is the entry distance of Ray into box i, or GEOMETRY_NO_HIT.
+inline static void BatchRayAABB(ray Ray, soa_aabb Boxes, u32 Count, f32* HitT)
+{
+	vec_3 InvDirection = vec_3(1.0f / Ray.Direction.x, 1.0f / Ray.Direction.y, 1.0f / Ray.Direction.z);
+
+	BatchGeometryKernel([&](auto Lane, u32 Index)
+	{
+		typedef decltype(Lane) wide;
+		wide_vec_3<wide> Origin  = WideSplatVector<wide>(Ray.Origin);
+		wide_vec_3<wide> Inverse = WideSplatVector<wide>(InvDirection);
+		wide_vec_3<wide> Min     = WideLoadVector<wide>(Boxes.Min, Index);
+		wide_vec_3<wide> Max     = WideLoadVector<wide>(Boxes.Max, Index);
+		wide_vec_3<wide> t1      = { WideMul(WideSub(Min.x, Origin.x), Inverse.x), WideMul(WideSub(Min.y, Origin.y), Inverse.y),
+			                         WideMul(WideSub(Min.z, Origin.z), Inverse.z) };
+		wide_vec_3<wide> t2      = { WideMul(WideSub(Max.x, Origin.x), Inverse.x), WideMul(WideSub(Max.y, Origin.y), Inverse.y),
+			                         WideMul(WideSub(Max.z, Origin.z), Inverse.z) };
+
+		wide Enter = WideSplat<wide>(0.0f);
+		wide Exit  = WideSplat<wide>(GEOMETRY_MAX_T);
+		Enter      = WideMax(WideMin(t1.x, t2.x), Enter);
+		Exit       = WideMin(WideMax(t1.x, t2.x), Exit);
+		Enter      = WideMax(WideMin(t1.y, t2.y), Enter);
+		Exit       = WideMin(WideMax(t1.y, t2.y), Exit);
+		Enter      = WideMax(WideMin(t1.z, t2.z), Enter);
+		Exit       = WideMin(WideMax(t1.z, t2.z), Exit);
+
+		WideStore(HitT + Index, WideSelect(WideLessEqual(Enter, Exit), Enter, WideSplat<wide>(GEOMETRY_NO_HIT)));
+	}, Count);
+}
+
+// HitT[i] is the distance along Ray to plane i, or GEOMETRY_NO_HIT.
+inline static void BatchRayPlane(ray Ray, soa_plane Planes, u32 Count, f32* HitT)
+{
+	BatchGeometryKernel([&](auto Lane, u32 Index)
+	{
+		typedef decltype(Lane) wide;
+		wide_vec_3<wide> Normal = WideLoadVector<wide>(Planes.Normals, Index);
+		wide Denominator        = WideDot(Normal, WideSplatVector<wide>(Ray.Direction));
+		wide Distance           = WideAdd(WideDot(Normal, WideSplatVector<wide>(Ray.Origin)), WideLoad<wide>(Planes.Distances + Index));
+		wide t                  = WideDiv(WideNegate(Distance), Denominator);
+
+		auto Hit = WideAnd(WideNotEqual(Denominator, WideSplat<wide>(0.0f)), WideLessEqual(WideSplat<wide>(0.0f), t));
+		WideStore(HitT + Index, WideSelect(Hit, t, WideSplat<wide>(GEOMETRY_NO_HIT)));
+	}, Count);
+}
+
+// HitT[i] is the first intersection of Ray with sphere i, or GEOMETRY_NO_HIT.
+inline static void BatchRaySphere(ray Ray, soa_sphere Spheres, u32 Count, f32* HitT)
+{
+	f32 a = Dot(Ray.Direction, Ray.Direction);
+
+	BatchGeometryKernel([&](auto Lane, u32 Index)
+	{
+		typedef decltype(Lane) wide;
+		wide Zero                  = WideSplat<wide>(0.0f);
+		wide_vec_3<wide> Direction = WideSplatVector<wide>(Ray.Direction);
+		wide_vec_3<wide> m         = WideSubtractVectors(WideSplatVector<wide>(Ray.Origin), WideLoadVector<wide>(Spheres.Centers, Index));
+		wide Radius                = WideLoad<wide>(Spheres.Radii + Index);
+		wide b                     = WideDot(m, Direction);
+		wide c                     = WideSub(WideDot(m, m), WideMul(Radius, Radius));
+		wide Discriminant          = WideSub(WideMul(b, b), WideMul(WideSplat<wide>(a), c));
+
+		auto Miss = WideOr(WideAnd(WideLess(Zero, c), WideLess(Zero, b)), WideLess(Discriminant, Zero));
+		wide t    = WideMax(WideDiv(WideSub(WideNegate(b), WideSqrt(Discriminant)), WideSplat<wide>(a)), Zero);
+		WideStore(HitT + Index, WideSelect(Miss, WideSplat<wide>(GEOMETRY_NO_HIT), t));
+	}, Count);
+}
+
+// Closest points between segments A[i] and B[i]: the parameters go to s[i] and t[i], the squared
+// distance to DistanceSquared[i]. Same branches as the scalar version, as lane selects.
+inline static void BatchSegmentSegment(soa_segment A, soa_segment B, u32 Count, f32* s, f32* t, f32* DistanceSquared)
+{
+	BatchGeometryKernel([&](auto Lane, u32 Index)
+	{
+		typedef decltype(Lane) wide;
+		wide Zero    = WideSplat<wide>(0.0f);
+		wide One     = WideSplat<wide>(1.0f);
+		wide Epsilon = WideSplat<wide>(GEOMETRY_EPSILON);
+
+		wide_vec_3<wide> StartA = WideLoadVector<wide>(A.Starts, Index);
+		wide_vec_3<wide> StartB = WideLoadVector<wide>(B.Starts, Index);
+		wide_vec_3<wide> d1     = WideSubtractVectors(WideLoadVector<wide>(A.Ends, Index), StartA);
+		wide_vec_3<wide> d2     = WideSubtractVectors(WideLoadVector<wide>(B.Ends, Index), StartB);
+		wide_vec_3<wide> r      = WideSubtractVectors(StartA, StartB);
+		wide a                  = WideDot(d1, d1);
+		wide e                  = WideDot(d2, d2);
+		wide f                  = WideDot(d2, r);
+		wide c                  = WideDot(d1, r);
+		wide b                  = WideDot(d1, d2);
+
+		// General case, then the clamps on t, then the degenerate cases in reverse priority.
+		wide Denominator = WideSub(WideMul(a, e), WideMul(b, b));
+		wide SegmentS    = WideSelect(WideNotEqual(Denominator, Zero),
+			                          WideClamp01(WideDiv(WideSub(WideMul(b, f), WideMul(c, e)), Denominator)), Zero);
+		wide SegmentT    = WideDiv(WideAdd(WideMul(b, SegmentS), f), e);
+
+		auto BelowZero = WideLess(SegmentT, Zero);
+		auto AboveOne  = WideLess(One, SegmentT);
+		SegmentS       = WideSelect(BelowZero, WideClamp01(WideDiv(WideNegate(c), a)), SegmentS);
+		SegmentS       = WideSelect(AboveOne, WideClamp01(WideDiv(WideSub(b, c), a)), SegmentS);
+		SegmentT       = WideSelect(BelowZero, Zero, WideSelect(AboveOne, One, SegmentT));
+
+		auto PointA = WideLessEqual(a, Epsilon);
+		auto PointB = WideLessEqual(e, Epsilon);
+		SegmentS    = WideSelect(PointB, WideClamp01(WideDiv(WideNegate(c), a)), SegmentS);
+		SegmentT    = WideSelect(PointB, Zero, SegmentT);
+		SegmentS    = WideSelect(PointA, Zero, SegmentS);
+		SegmentT    = WideSelect(PointA, WideClamp01(WideDiv(f, e)), SegmentT);
+		SegmentT    = WideSelect(WideAnd(PointA, PointB), Zero, SegmentT);
+
+		wide_vec_3<wide> ClosestA = WideAddVectors(StartA, WideScale(d1, SegmentS));
+		wide_vec_3<wide> ClosestB = WideAddVectors(StartB, WideScale(d2, SegmentT));
+		wide_vec_3<wide> Between  = WideSubtractVectors(ClosestA, ClosestB);
+
+		WideStore(s + Index, SegmentS);
+		WideStore(t + Index, SegmentT);
+		WideStore(DistanceSquared + Index, WideDot(Between, Between));
+	}, Count);
+}
+
+// Writes the indices of the boxes overlapping Box to OverlapIndices (room for Count entries)
+// and returns how many there are.
+inline static u32 BatchAABBOverlap(aabb Box, soa_aabb Boxes, u32 Count, u32* OverlapIndices)
+{
+	u32 OverlapCount = 0;
+
+	BatchGeometryKernel([&](auto Lane, u32 Index)
+	{
+		typedef decltype(Lane) wide;
+		wide_vec_3<wide> Min      = WideSplatVector<wide>(Box.Min);
+		wide_vec_3<wide> Max      = WideSplatVector<wide>(Box.Max);
+		wide_vec_3<wide> OtherMin = WideLoadVector<wide>(Boxes.Min, Index);
+		wide_vec_3<wide> OtherMax = WideLoadVector<wide>(Boxes.Max, Index);
+
+		auto Overlap = WideAnd(WideAnd(WideLessEqual(Min.x, OtherMax.x), WideLessEqual(OtherMin.x, Max.x)),
+			                   WideAnd(WideLessEqual(Min.y, OtherMax.y), WideLessEqual(OtherMin.y, Max.y)));
+		Overlap      = WideAnd(Overlap, WideAnd(WideLessEqual(Min.z, OtherMax.z), WideLessEqual(OtherMin.z, Max.z)));
+
+		u32 Mask = WideMoveMask(Overlap);
+		for (u32 LaneIndex = 0; LaneIndex < sizeof(wide) / sizeof(f32); LaneIndex++)
+		{
+			OverlapIndices[OverlapCount] = Index + LaneIndex;
+			OverlapCount                += (Mask >> LaneIndex) & 1;
+		}
+	}, Count);
+
+	return OverlapCount;
+}
+
+static_assert(AABBOverlap(aabb{ vec_3(0, 0, 0), vec_3(1, 1, 1) }, aabb{ vec_3(1, 0.5f, 0.5f), vec_3(2, 2, 2) }), "AABBOverlap");
+static_assert(!AABBOverlap(aabb{ vec_3(0, 0, 0), vec_3(1, 1, 1) }, aabb{ vec_3(1.5f, 0, 0), vec_3(2, 1, 1) }), "AABBOverlap");
+static_assert(ClosestPointsSegmentSegment(segment{ vec_3(-1, 0, 0), vec_3(1, 0, 0) },
+	                                      segment{ vec_3(0, -1, 2), vec_3(0, 1, 2) }).DistanceSquared == 4, "ClosestPointsSegmentSegment");
\ No newline at end of file
@@ -10,59 +10,103 @@ constexpr auto MAT_4_ROW_COUNT = 4;
 
 struct mat_4
 {
+	// GCC and Clang reject members with constructors inside an anonymous struct,
+	// so the rows are stored as an array instead of r1..r4.
 	union
 	{
-		struct { 
-			vec_4 r1;
-			vec_4 r2;
-			vec_4 r3;
-			vec_4 r4;
-		};
-		f32 AsArray[16];
+		vec_4 Rows[MAT_4_ROW_COUNT];
+		f32   AsArray[16];
 	};
 
-	mat_4():
-		r1(vec_4(1, 0, 0, 0)),
-		r2(vec_4(0, 1, 0, 0)),
-		r3(vec_4(0, 0, 1, 0)),
-		r4(vec_4(0, 0, 0, 1))
+	constexpr mat_4():
+		Rows{
+			vec_4(1, 0, 0, 0),
+			vec_4(0, 1, 0, 0),
+			vec_4(0, 0, 1, 0),
+			vec_4(0, 0, 0, 1)
+		}
 	{}
 
-	mat_4(const vec_4& R1, const vec_4& R2, const vec_4& R3, const vec_4& R4)
-		  : r1(R1), r2(R2), r3(R3), r4(R4)
+	constexpr mat_4(const vec_4& R1, const vec_4& R2, const vec_4& R3, const vec_4& R4)
+		  : Rows{ R1, R2, R3, R4 }
 	{}
 
-	vec_4& operator[](u32 Index) { return (&r1)[Index]; }
+	constexpr vec_4& operator[](u32 Index) { return Rows[Index]; }
+	constexpr const vec_4& operator[](u32 Index) const { return Rows[Index]; }
 };
 
-inline static mat_4 operator*(mat_4 Transform, mat_4 Base)
+static constexpr mat_4 operator*(mat_4 Transform, mat_4 Base)
 {
+#if MATH_SIMD_AVX
+	if (!MATH_CONSTANT_EVALUATED())
+	{
+		// Two rows per iteration: each 128-bit half holds one row of the result.
+		__m256 BaseRow1 = _mm256_broadcast_ps(&Base.Rows[0].AsSIMD);
+		__m256 BaseRow2 = _mm256_broadcast_ps(&Base.Rows[1].AsSIMD);
+		__m256 BaseRow3 = _mm256_broadcast_ps(&Base.Rows[2].AsSIMD);
+		__m256 BaseRow4 = _mm256_broadcast_ps(&Base.Rows[3].AsSIMD);
+
+		mat_4 Result;
+		for (u32 PairIndex = 0; PairIndex < MAT_4_ROW_COUNT / 2; PairIndex++)
+		{
+			__m256 Rows = _mm256_loadu_ps(Transform.AsArray + PairIndex * 8);
+			__m256 Sum  = _mm256_setzero_ps();
+			Sum         = MulAdd8(Splat8<0>(Rows), BaseRow1, Sum);
+			Sum         = MulAdd8(Splat8<1>(Rows), BaseRow2, Sum);
+			Sum         = MulAdd8(Splat8<2>(Rows), BaseRow3, Sum);
+			Sum         = MulAdd8(Splat8<3>(Rows), BaseRow4, Sum);
+			_mm256_storeu_ps(Result.AsArray + PairIndex * 8, Sum);
+		}
+
+		return Result;
+	}
+#elif MATH_SIMD_SSE2
+	if (!MATH_CONSTANT_EVALUATED())
+	{
+		// Each result row is a linear combination of the rows of Base. Summing from zero
+		// in column order gives the same rounding as the scalar Dot() path.
+		mat_4 Result;
+		for (u32 RowIndex = 0; RowIndex < MAT_4_ROW_COUNT; RowIndex++)
+		{
+			__m128 Row = Transform[RowIndex].AsSIMD;
+			__m128 Sum = _mm_setzero_ps();
+			Sum        = MulAdd4(Splat4<0>(Row), Base.Rows[0].AsSIMD, Sum);
+			Sum        = MulAdd4(Splat4<1>(Row), Base.Rows[1].AsSIMD, Sum);
+			Sum        = MulAdd4(Splat4<2>(Row), Base.Rows[2].AsSIMD, Sum);
+			Sum        = MulAdd4(Splat4<3>(Row), Base.Rows[3].AsSIMD, Sum);
+			Result[RowIndex].AsSIMD = Sum;
+		}
+
+		return Result;
+	}
+#endif
+
 	vec_4 FirstColumn = vec_4(
-		Base.AsArray[0],
-		Base.AsArray[4],
-		Base.AsArray[8],
-		Base.AsArray[12]
+		Base[0].x,
+		Base[1].x,
+		Base[2].x,
+		Base[3].x
 	);
 
 	vec_4 SecondColumn = vec_4(
-		Base.AsArray[1],
-		Base.AsArray[5],
-		Base.AsArray[9],
-		Base.AsArray[13]
+		Base[0].y,
+		Base[1].y,
+		Base[2].y,
+		Base[3].y
 	);
 
 	vec_4 ThirdColumn = vec_4(
-		Base.AsArray[2],
-		Base.AsArray[6],
-		Base.AsArray[10],
-		Base.AsArray[14]
+		Base[0].z,
+		Base[1].z,
+		Base[2].z,
+		Base[3].z
 	);
 
 	vec_4 FourthColumn = vec_4(
-		Base.AsArray[3],
-		Base.AsArray[7],
-		Base.AsArray[11],
-		Base.AsArray[15]
+		Base[0].w,
+		Base[1].w,
+		Base[2].w,
+		Base[3].w
 	);
 
 	mat_4 Result;
@@ -81,27 +125,27 @@ inline static mat_4 operator*(mat_4 Transform, mat_4 Base)
 
 static void PrintMatrix(mat_4 m)
 {
-	PrintVector(m.r1, "Row 1: ");
-	PrintVector(m.r2, "Row 2: ");
-	PrintVector(m.r3, "Row 3: ");
-	PrintVector(m.r4, "Row 4: ");
+	PrintVector(m.Rows[0], "Row 1: ");
+	PrintVector(m.Rows[1], "Row 2: ");
+	PrintVector(m.Rows[2], "Row 3: ");
+	PrintVector(m.Rows[3], "Row 4: ");
 }
 
 static void PrintMatrix(mat_4 m, const char* Message)
 {
 	printf("%s: \n", Message);
-	PrintVector(m.r1, "Row 1: ");
-	PrintVector(m.r2, "Row 2: ");
-	PrintVector(m.r3, "Row 3: ");
-	PrintVector(m.r4, "Row 4: ");
+	PrintVector(m.Rows[0], "Row 1: ");
+	PrintVector(m.Rows[1], "Row 2: ");
+	PrintVector(m.Rows[2], "Row 3: ");
+	PrintVector(m.Rows[3], "Row 4: ");
 }
 
-static mat_4 ProjectionMatrix(f32 FOV, f32 AspectRatio, f32 Near, f32 Far)
+static constexpr mat_4 ProjectionMatrix(f32 FOV, f32 AspectRatio, f32 Near, f32 Far)
 {
 	f32 FOVRadians = FOV * (F_PI / 180.0f);
 	
-	f32 XProj        = 1 / (AspectRatio * tanf(FOVRadians / 2));
-	f32 YProj        = 1 / tanf(FOVRadians / 2);
+	f32 XProj        = 1 / (AspectRatio * Tangent(FOVRadians / 2));
+	f32 YProj        = 1 / Tangent(FOVRadians / 2);
 	f32 Depth        = Far - Near;
 
 	mat_4 ProjectionMatrix = mat_4(
@@ -114,7 +158,7 @@ static mat_4 ProjectionMatrix(f32 FOV, f32 AspectRatio, f32 Near, f32 Far)
 	return ProjectionMatrix;
 }
 
-static mat_4 FocusMatrix(vec_3 DefaultUp, vec_3 CameraPosition, vec_3 Focus)
+static constexpr mat_4 FocusMatrix(vec_3 DefaultUp, vec_3 CameraPosition, vec_3 Focus)
 {
 	vec_3 Forward = Normalize(Focus - CameraPosition);
 	vec_3 Right   = Normalize(VectorProduct(DefaultUp, Forward));
@@ -137,7 +181,7 @@ static mat_4 FocusMatrix(vec_3 DefaultUp, vec_3 CameraPosition, vec_3 Focus)
 	return Rotation * Translation;
 }
 
-static mat_4 IdentityMatrix()
+static constexpr mat_4 IdentityMatrix()
 {
 	mat_4 Result = mat_4(
 		vec_4(1, 0, 0, 0),
@@ -149,7 +193,7 @@ static mat_4 IdentityMatrix()
 	return Result;
 }
 
-static mat_4 ScalingMatrix(vec_3 ScaleVector)
+static constexpr mat_4 ScalingMatrix(vec_3 ScaleVector)
 {
 	f32 XScale = ScaleVector.x;
 	f32 YScale = ScaleVector.y;
@@ -165,7 +209,7 @@ static mat_4 ScalingMatrix(vec_3 ScaleVector)
 	return Result;
 }
 
-static mat_4 TranslationMatrix(vec_3 TranslationVector)
+static constexpr mat_4 TranslationMatrix(vec_3 TranslationVector)
 {
 	f32 XTrans = TranslationVector.x;
 	f32 YTrans = TranslationVector.y;
@@ -181,33 +225,405 @@ static mat_4 TranslationMatrix(vec_3 TranslationVector)
 	return Result;
 }
 
-static mat_4 RotationMatrixFromEulerAngles(vec_3 Angles)
+static constexpr mat_4 Transpose(mat_4 m)
+{
+#if MATH_SIMD_SSE2
+	if (!MATH_CONSTANT_EVALUATED())
+	{
+		__m128 Row1 = m.Rows[0].AsSIMD;
+		__m128 Row2 = m.Rows[1].AsSIMD;
+		__m128 Row3 = m.Rows[2].AsSIMD;
+		__m128 Row4 = m.Rows[3].AsSIMD;
+		_MM_TRANSPOSE4_PS(Row1, Row2, Row3, Row4);
+
+		mat_4 Result = mat_4(vec_4(Row1), vec_4(Row2), vec_4(Row3), vec_4(Row4));
+		return Result;
+	}
+#endif
+
+	mat_4 Result = mat_4(
+		vec_4(m[0].x, m[1].x, m[2].x, m[3].x),
+		vec_4(m[0].y, m[1].y, m[2].y, m[3].y),
+		vec_4(m[0].z, m[1].z, m[2].z, m[3].z),
+		vec_4(m[0].w, m[1].w, m[2].w, m[3].w)
+	);
+	return Result;
+}
+
+#if MATH_SIMD_SSE2
+// 2x2 matrices stored row by row in one register, for the block inverse below.
+// A * B
+inline static __m128 Mat2Multiply(__m128 A, __m128 B)
+{
+	__m128 Result = _mm_mul_ps(A, _mm_shuffle_ps(B, B, _MM_SHUFFLE(3, 0, 3, 0)));
+	return MulAdd4(_mm_shuffle_ps(A, A, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(B, B, _MM_SHUFFLE(1, 2, 1, 2)), Result);
+}
+
+// Adjugate(A) * B
+inline static __m128 Mat2AdjugateMultiply(__m128 A, __m128 B)
+{
+	return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(A, A, _MM_SHUFFLE(0, 0, 3, 3)), B),
+		              _mm_mul_ps(_mm_shuffle_ps(A, A, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(B, B, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+// A * Adjugate(B)
+inline static __m128 Mat2MultiplyAdjugate(__m128 A, __m128 B)
+{
+	return _mm_sub_ps(_mm_mul_ps(A, _mm_shuffle_ps(B, B, _MM_SHUFFLE(0, 3, 0, 3))),
+		              _mm_mul_ps(_mm_shuffle_ps(A, A, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(B, B, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+#endif
+
+// General inverse through the cofactor expansion. The twelve 2x2 minors of the top and
+// bottom row pairs are shared by every cofactor, which keeps it around 100 flops with
+// no branches besides the singular check. Returns the identity for a singular matrix.
+static constexpr mat_4 Inverse(mat_4 m)
+{
+#if MATH_SIMD_SSE2
+	if (!MATH_CONSTANT_EVALUATED())
+	{
+		// The same matrix as four 2x2 blocks [A B; C D], inverted blockwise through their
+		// adjugates, which leaves a single divide by the full determinant.
+		__m128 A = _mm_movelh_ps(m.Rows[0].AsSIMD, m.Rows[1].AsSIMD);
+		__m128 B = _mm_movehl_ps(m.Rows[1].AsSIMD, m.Rows[0].AsSIMD);
+		__m128 C = _mm_movelh_ps(m.Rows[2].AsSIMD, m.Rows[3].AsSIMD);
+		__m128 D = _mm_movehl_ps(m.Rows[3].AsSIMD, m.Rows[2].AsSIMD);
+
+		// Determinants of A, B, C and D, one per lane.
+		__m128 BlockDeterminants = _mm_sub_ps(
+			_mm_mul_ps(_mm_shuffle_ps(m.Rows[0].AsSIMD, m.Rows[2].AsSIMD, _MM_SHUFFLE(2, 0, 2, 0)),
+				       _mm_shuffle_ps(m.Rows[1].AsSIMD, m.Rows[3].AsSIMD, _MM_SHUFFLE(3, 1, 3, 1))),
+			_mm_mul_ps(_mm_shuffle_ps(m.Rows[0].AsSIMD, m.Rows[2].AsSIMD, _MM_SHUFFLE(3, 1, 3, 1)),
+				       _mm_shuffle_ps(m.Rows[1].AsSIMD, m.Rows[3].AsSIMD, _MM_SHUFFLE(2, 0, 2, 0))));
+		__m128 DetA = Splat4<0>(BlockDeterminants);
+		__m128 DetB = Splat4<1>(BlockDeterminants);
+		__m128 DetC = Splat4<2>(BlockDeterminants);
+		__m128 DetD = Splat4<3>(BlockDeterminants);
+
+		__m128 DC = Mat2AdjugateMultiply(D, C);
+		__m128 AB = Mat2AdjugateMultiply(A, B);
+		__m128 X  = _mm_sub_ps(_mm_mul_ps(DetD, A), Mat2Multiply(B, DC));
+		__m128 W  = _mm_sub_ps(_mm_mul_ps(DetA, D), Mat2Multiply(C, AB));
+		__m128 Y  = _mm_sub_ps(_mm_mul_ps(DetB, C), Mat2MultiplyAdjugate(D, AB));
+		__m128 Z  = _mm_sub_ps(_mm_mul_ps(DetC, B), Mat2MultiplyAdjugate(A, DC));
+
+		// det(M) = det(A) det(D) + det(B) det(C) - trace(Adjugate(A) B Adjugate(D) C), the
+		// trace summed across the lanes.
+		__m128 Trace = _mm_mul_ps(AB, _mm_shuffle_ps(DC, DC, _MM_SHUFFLE(3, 1, 2, 0)));
+		Trace        = _mm_add_ps(Trace, _mm_shuffle_ps(Trace, Trace, _MM_SHUFFLE(2, 3, 0, 1)));
+		Trace        = _mm_add_ps(Trace, _mm_shuffle_ps(Trace, Trace, _MM_SHUFFLE(1, 0, 3, 2)));
+		__m128 Determinant = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(DetA, DetD), _mm_mul_ps(DetB, DetC)), Trace);
+		if (_mm_cvtss_f32(Determinant) == 0)
+		{
+			return mat_4();
+		}
+
+		__m128 InvDet = _mm_div_ps(_mm_setr_ps(1, -1, -1, 1), Determinant);
+		X = _mm_mul_ps(X, InvDet);
+		Y = _mm_mul_ps(Y, InvDet);
+		Z = _mm_mul_ps(Z, InvDet);
+		W = _mm_mul_ps(W, InvDet);
+
+		// The blocks come out as adjugates, transposed back into rows here.
+		mat_4 Result = mat_4(
+			vec_4(_mm_shuffle_ps(X, Y, _MM_SHUFFLE(1, 3, 1, 3))),
+			vec_4(_mm_shuffle_ps(X, Y, _MM_SHUFFLE(0, 2, 0, 2))),
+			vec_4(_mm_shuffle_ps(Z, W, _MM_SHUFFLE(1, 3, 1, 3))),
+			vec_4(_mm_shuffle_ps(Z, W, _MM_SHUFFLE(0, 2, 0, 2)))
+		);
+		return Result;
+	}
+#endif
+
+	f32 a[16] = {
+		m[0].x, m[0].y, m[0].z, m[0].w,
+		m[1].x, m[1].y, m[1].z, m[1].w,
+		m[2].x, m[2].y, m[2].z, m[2].w,
+		m[3].x, m[3].y, m[3].z, m[3].w
+	};
+
+	f32 S0 = a[0] * a[5] - a[4] * a[1];
+	f32 S1 = a[0] * a[6] - a[4] * a[2];
+	f32 S2 = a[0] * a[7] - a[4] * a[3];
+	f32 S3 = a[1] * a[6] - a[5] * a[2];
+	f32 S4 = a[1] * a[7] - a[5] * a[3];
+	f32 S5 = a[2] * a[7] - a[6] * a[3];
+
+	f32 C5 = a[10] * a[15] - a[14] * a[11];
+	f32 C4 = a[9]  * a[15] - a[13] * a[11];
+	f32 C3 = a[9]  * a[14] - a[13] * a[10];
+	f32 C2 = a[8]  * a[15] - a[12] * a[11];
+	f32 C1 = a[8]  * a[14] - a[12] * a[10];
+	f32 C0 = a[8]  * a[13] - a[12] * a[9];
+
+	f32 Determinant = S0 * C5 - S1 * C4 + S2 * C3 + S3 * C2 - S4 * C1 + S5 * C0;
+	if (Determinant == 0)
+	{
+		return mat_4();
+	}
+
+	f32 InvDet   = 1.0f / Determinant;
+	mat_4 Result = mat_4(
+		vec_4(( a[5]  * C5 - a[6]  * C4 + a[7]  * C3) * InvDet,
+		      (-a[1]  * C5 + a[2]  * C4 - a[3]  * C3) * InvDet,
+		      ( a[13] * S5 - a[14] * S4 + a[15] * S3) * InvDet,
+		      (-a[9]  * S5 + a[10] * S4 - a[11] * S3) * InvDet),
+		vec_4((-a[4]  * C5 + a[6]  * C2 - a[7]  * C1) * InvDet,
+		      ( a[0]  * C5 - a[2]  * C2 + a[3]  * C1) * InvDet,
+		      (-a[12] * S5 + a[14] * S2 - a[15] * S1) * InvDet,
+		      ( a[8]  * S5 - a[10] * S2 + a[11] * S1) * InvDet),
+		vec_4(( a[4]  * C4 - a[5]  * C2 + a[7]  * C0) * InvDet,
+		      (-a[0]  * C4 + a[1]  * C2 - a[3]  * C0) * InvDet,
+		      ( a[12] * S4 - a[13] * S2 + a[15] * S0) * InvDet,
+		      (-a[8]  * S4 + a[9]  * S2 - a[11] * S0) * InvDet),
+		vec_4((-a[4]  * C3 + a[5]  * C1 - a[6]  * C0) * InvDet,
+		      ( a[0]  * C3 - a[1]  * C1 + a[2]  * C0) * InvDet,
+		      (-a[12] * S3 + a[13] * S1 - a[14] * S0) * InvDet,
+		      ( a[8]  * S3 - a[9]  * S1 + a[10] * S0) * InvDet)
+	);
+	return Result;
+}
+
+// Normal matrix: keeps normals perpendicular to surfaces under non-uniform scaling.
+static constexpr mat_4 InverseTranspose(mat_4 m)
+{
+	mat_4 Result = Transpose(Inverse(m));
+	return Result;
+}
+
+// Transforms (Point, 1) and divides by w. Used to unproject NDC points through an inverse view-projection.
+static constexpr vec_3 TransformProjectedPoint(mat_4 m, vec_3 Point)
+{
+	vec_4 Homogeneous = vec_4(Point.x, Point.y, Point.z, 1);
+	f32   W           = Dot(m.Rows[3], Homogeneous);
+	vec_3 Result      = vec_3(
+		Dot(m.Rows[0], Homogeneous),
+		Dot(m.Rows[1], Homogeneous),
+		Dot(m.Rows[2], Homogeneous)
+	);
+	return W != 0 ? Result / W : Result;
+}
+
+static constexpr mat_4 RotationMatrixFromEulerAngles(vec_3 Angles)
 {
 	f32 Pitch = DegToRad(Angles.x);
 	f32 Yaw   = DegToRad(Angles.y);
 	f32 Roll  = DegToRad(Angles.z);
 
+	f32 CosPitch = Cosine(Pitch);
+	f32 SinPitch = Sine(Pitch);
+	f32 CosYaw   = Cosine(Yaw);
+	f32 SinYaw   = Sine(Yaw);
+	f32 CosRoll  = Cosine(Roll);
+	f32 SinRoll  = Sine(Roll);
+
 	mat_4 Rx = mat_4(
 		vec_4(1, 0, 0, 0),
-		vec_4(0, cosf(Pitch), -sinf(Pitch), 0),
-		vec_4(0, sinf(Pitch), cosf(Pitch), 0),
+		vec_4(0, CosPitch, -SinPitch, 0),
+		vec_4(0, SinPitch, CosPitch, 0),
 		vec_4(0, 0, 0, 1)
 	);
 
 	mat_4 Ry = mat_4(
-		vec_4(cosf(Yaw), 0, sinf(Yaw), 0),
+		vec_4(CosYaw, 0, SinYaw, 0),
 		vec_4(0, 1, 0, 0),
-		vec_4(-sinf(Yaw), 0, cosf(Yaw), 0),
+		vec_4(-SinYaw, 0, CosYaw, 0),
 		vec_4(0, 0, 0, 1)
 	);
 
 	mat_4 Rz = mat_4(
-		vec_4(cosf(Roll), -sinf(Roll), 0, 0),
-		vec_4(sinf(Roll), cosf(Roll), 0, 0),
+		vec_4(CosRoll, -SinRoll, 0, 0),
+		vec_4(SinRoll, CosRoll, 0, 0),
 		vec_4(0, 0, 1, 0),
 		vec_4(0, 0, 0, 1)
 	);
 
 	mat_4 Combined = Rz * Ry * Rx;
 	return Combined;
-}
\ No newline at end of file
+}
+
+// ==================================================================================
+// Affine transforms. The implicit last row is (0, 0, 0, 1), so composition only needs
+// 36 multiplies instead of 64 and the storage is 48 bytes instead of 64.
+
+constexpr auto AFFINE_ROW_COUNT = 3;
+
+struct affine_3x4
+{
+	union
+	{
+		vec_4 Rows[AFFINE_ROW_COUNT];
+		f32   AsArray[12];
+	};
+
+	constexpr affine_3x4():
+		Rows{
+			vec_4(1, 0, 0, 0),
+			vec_4(0, 1, 0, 0),
+			vec_4(0, 0, 1, 0)
+		}
+	{}
+
+	constexpr affine_3x4(const vec_4& R1, const vec_4& R2, const vec_4& R3)
+		  : Rows{ R1, R2, R3 }
+	{}
+
+	constexpr vec_4& operator[](u32 Index) { return Rows[Index]; }
+	constexpr const vec_4& operator[](u32 Index) const { return Rows[Index]; }
+};
+
+static constexpr affine_3x4 operator*(affine_3x4 Transform, affine_3x4 Base)
+{
+	affine_3x4 Result;
+
+#if MATH_SIMD_SSE2
+	if (!MATH_CONSTANT_EVALUATED())
+	{
+		// Same order as the scalar path: the three products from the first one, then the
+		// translation. The other lanes add -0, which leaves every value as it is, -0 included.
+		__m128 TranslationMask = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+		__m128 NegativeZeros   = _mm_setr_ps(-0.0f, -0.0f, -0.0f, 0.0f);
+		for (u32 RowIndex = 0; RowIndex < AFFINE_ROW_COUNT; RowIndex++)
+		{
+			__m128 Row         = Transform[RowIndex].AsSIMD;
+			__m128 Translation = _mm_or_ps(_mm_and_ps(Row, TranslationMask), NegativeZeros);
+			__m128 Sum         = _mm_mul_ps(Splat4<0>(Row), Base.Rows[0].AsSIMD);
+			Sum                = MulAdd4(Splat4<1>(Row), Base.Rows[1].AsSIMD, Sum);
+			Sum                = MulAdd4(Splat4<2>(Row), Base.Rows[2].AsSIMD, Sum);
+			Result[RowIndex].AsSIMD = _mm_add_ps(Sum, Translation);
+		}
+		return Result;
+	}
+#endif
+
+	for (u32 RowIndex = 0; RowIndex < AFFINE_ROW_COUNT; RowIndex++)
+	{
+		vec_4 Row = Transform[RowIndex];
+		for (u32 Column = 0; Column < VEC_4_LENGTH; Column++)
+		{
+			Result[RowIndex][Column] = Row.x * Base.Rows[0][Column] +
+				                       Row.y * Base.Rows[1][Column] +
+				                       Row.z * Base.Rows[2][Column];
+		}
+		Result[RowIndex].w += Row.w;
+	}
+
+	return Result;
+}
+
+static constexpr vec_3 TransformPoint(affine_3x4 Transform, vec_3 Point)
+{
+	vec_4 Homogeneous = vec_4(Point.x, Point.y, Point.z, 1);
+	vec_3 Result      = vec_3(
+		Dot(Transform.Rows[0], Homogeneous),
+		Dot(Transform.Rows[1], Homogeneous),
+		Dot(Transform.Rows[2], Homogeneous)
+	);
+	return Result;
+}
+
+static constexpr vec_3 TransformDirection(affine_3x4 Transform, vec_3 Direction)
+{
+	vec_4 Homogeneous = vec_4(Direction.x, Direction.y, Direction.z, 0);
+	vec_3 Result      = vec_3(
+		Dot(Transform.Rows[0], Homogeneous),
+		Dot(Transform.Rows[1], Homogeneous),
+		Dot(Transform.Rows[2], Homogeneous)
+	);
+	return Result;
+}
+
+// Closed form: the 3x3 part is inverted through its adjugate, the translation becomes -Inverse * t.
+// Returns the identity when the transform is singular.
+static constexpr affine_3x4 Inverse(affine_3x4 Transform)
+{
+	f32 m[12] = {
+		Transform[0].x, Transform[0].y, Transform[0].z, Transform[0].w,
+		Transform[1].x, Transform[1].y, Transform[1].z, Transform[1].w,
+		Transform[2].x, Transform[2].y, Transform[2].z, Transform[2].w
+	};
+
+	f32 C00 = m[5] * m[10] - m[6] * m[9];
+	f32 C01 = m[6] * m[8]  - m[4] * m[10];
+	f32 C02 = m[4] * m[9]  - m[5] * m[8];
+
+	f32 Determinant = m[0] * C00 + m[1] * C01 + m[2] * C02;
+	if (Determinant == 0)
+	{
+		return affine_3x4();
+	}
+
+	f32 InvDet = 1.0f / Determinant;
+
+	f32 I00 = C00 * InvDet;
+	f32 I01 = (m[2] * m[9]  - m[1] * m[10]) * InvDet;
+	f32 I02 = (m[1] * m[6]  - m[2] * m[5])  * InvDet;
+	f32 I10 = C01 * InvDet;
+	f32 I11 = (m[0] * m[10] - m[2] * m[8])  * InvDet;
+	f32 I12 = (m[2] * m[4]  - m[0] * m[6])  * InvDet;
+	f32 I20 = C02 * InvDet;
+	f32 I21 = (m[1] * m[8]  - m[0] * m[9])  * InvDet;
+	f32 I22 = (m[0] * m[5]  - m[1] * m[4])  * InvDet;
+
+	f32 Tx = m[3], Ty = m[7], Tz = m[11];
+
+	affine_3x4 Result = affine_3x4(
+		vec_4(I00, I01, I02, -(I00 * Tx + I01 * Ty + I02 * Tz)),
+		vec_4(I10, I11, I12, -(I10 * Tx + I11 * Ty + I12 * Tz)),
+		vec_4(I20, I21, I22, -(I20 * Tx + I21 * Ty + I22 * Tz))
+	);
+	return Result;
+}
+
+static constexpr mat_4 AffineToMatrix(affine_3x4 Transform)
+{
+	mat_4 Result = mat_4(Transform.Rows[0], Transform.Rows[1], Transform.Rows[2], vec_4(0, 0, 0, 1));
+	return Result;
+}
+
+// Drops the last row, which must be (0, 0, 0, 1) for the result to be meaningful.
+static constexpr affine_3x4 MatrixToAffine(mat_4 Matrix)
+{
+	affine_3x4 Result = affine_3x4(Matrix.Rows[0], Matrix.Rows[1], Matrix.Rows[2]);
+	return Result;
+}
+
+static constexpr affine_3x4 TranslationAffine(vec_3 TranslationVector)
+{
+	affine_3x4 Result = affine_3x4(
+		vec_4(1, 0, 0, TranslationVector.x),
+		vec_4(0, 1, 0, TranslationVector.y),
+		vec_4(0, 0, 1, TranslationVector.z)
+	);
+	return Result;
+}
+
+static constexpr affine_3x4 ScalingAffine(vec_3 ScaleVector)
+{
+	affine_3x4 Result = affine_3x4(
+		vec_4(ScaleVector.x, 0            , 0            , 0),
+		vec_4(0            , ScaleVector.y, 0            , 0),
+		vec_4(0            , 0            , ScaleVector.z, 0)
+	);
+	return Result;
+}
+
+// ==================================================================================
+// Compile-time checks. These cost nothing at run time and fail the build if the
+// constexpr paths drift from the expected results.
+
+static_assert(AreEqual(VectorProduct(vec_3(1, 0, 0), vec_3(0, 1, 0)), vec_3(0, 0, 1)), "VectorProduct");
+static_assert(AreEqual(Normalize(vec_3(3, 4, 0)), vec_3(0.6f, 0.8f, 0)), "Normalize");
+static_assert(AreEqual(ProjectVectorOnVector(vec_3(2, 3, 0), vec_3(4, 0, 0)), vec_3(2, 0, 0)), "ProjectVectorOnVector");
+static_assert(AreEqual(ProjectVectorOnPlane(vec_3(2, 3, 4), vec_3(0, 2, 0)), vec_3(2, 0, 4)), "ProjectVectorOnPlane");
+static_assert(Dot(vec_4(1, 2, 3, 4), vec_4(5, 6, 7, 8)) == 70, "Dot(vec_4)");
+
+static_assert((TranslationMatrix(vec_3(1, 2, 3)) * TranslationMatrix(vec_3(4, 5, 6)))[2].w == 9, "mat_4 operator*");
+static_assert((IdentityMatrix() * ScalingMatrix(vec_3(2, 4, 8)))[1].y == 4, "mat_4 operator*");
+static_assert(Transpose(TranslationMatrix(vec_3(1, 2, 3)))[3].y == 2, "Transpose");
+static_assert(Inverse(ScalingMatrix(vec_3(2, 4, 8)))[2].z == 0.125f, "Inverse(mat_4)");
+static_assert(Inverse(TranslationMatrix(vec_3(1, 2, 3)))[0].w == -1, "Inverse(mat_4)");
+static_assert(AreNearlyEqual(TransformPoint(MatrixToAffine(RotationMatrixFromEulerAngles(vec_3(0, 0, 90))), vec_3(1, 0, 0)),
+	                         vec_3(0, 1, 0), 1e-6f), "RotationMatrixFromEulerAngles");
+static_assert(AreNearlyEqual(TransformPoint(Inverse(TranslationAffine(vec_3(1, 2, 3)) * ScalingAffine(vec_3(2, 2, 2))),
+	                                        vec_3(3, 4, 5)), vec_3(1, 1, 1), 1e-6f), "Inverse(affine_3x4)");
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "matrix.hpp"
+
+// Unit quaternions for rotations. (x, y, z) is the vector part, w the scalar part.
+// Composition follows the matrix convention: QuatToMatrix(a * b) == QuatToMatrix(a) * QuatToMatrix(b).
+struct quat
+{
+	union
+	{
+		struct { f32 x, y, z, w; };
+		f32 AsArray[4];
+	};
+
+	constexpr quat() : x(0), y(0), z(0), w(1) {}
+	constexpr quat(f32 X, f32 Y, f32 Z, f32 W) : x(X), y(Y), z(Z), w(W) {}
+};
+
+static constexpr quat operator*(quat ql, quat qr)
+{
+	quat Result = quat(
+		ql.w * qr.x + ql.x * qr.w + ql.y * qr.z - ql.z * qr.y,
+		ql.w * qr.y - ql.x * qr.z + ql.y * qr.w + ql.z * qr.x,
+		ql.w * qr.z + ql.x * qr.y - ql.y * qr.x + ql.z * qr.w,
+		ql.w * qr.w - ql.x * qr.x - ql.y * qr.y - ql.z * qr.z
+	);
+	return Result;
+}
+
+static constexpr f32 Dot(quat ql, quat qr)
+{
+	f32 Result = ql.x * qr.x + ql.y * qr.y + ql.z * qr.z + ql.w * qr.w;
+	return Result;
+}
+
+static constexpr quat Conjugate(quat q)
+{
+	quat Result = quat(-q.x, -q.y, -q.z, q.w);
+	return Result;
+}
+
+static constexpr quat Normalize(quat q)
+{
+	f32 Length = SquareRoot(Dot(q, q));
+	if (Length > 0)
+	{
+		f32 InvLength = 1.0f / Length;
+		quat Result   = quat(q.x * InvLength, q.y * InvLength, q.z * InvLength, q.w * InvLength);
+		return Result;
+	}
+
+	return quat();
+}
+
+// Axis must be normalized. Angle is in radians.
+static constexpr quat QuatFromAxisAngle(vec_3 Axis, f32 Angle)
+{
+	f32 HalfSin = Sine(Angle * 0.5f);
+	f32 HalfCos = Cosine(Angle * 0.5f);
+
+	quat Result = quat(Axis.x * HalfSin, Axis.y * HalfSin, Axis.z * HalfSin, HalfCos);
+	return Result;
+}
+
+// Same convention as RotationMatrixFromEulerAngles: degrees, applied as Rz * Ry * Rx.
+static constexpr quat QuatFromEulerAngles(vec_3 Angles)
+{
+	f32 HalfPitch = DegToRad(Angles.x) * 0.5f;
+	f32 HalfYaw   = DegToRad(Angles.y) * 0.5f;
+	f32 HalfRoll  = DegToRad(Angles.z) * 0.5f;
+
+	f32 CosPitch = Cosine(HalfPitch);
+	f32 SinPitch = Sine(HalfPitch);
+	f32 CosYaw   = Cosine(HalfYaw);
+	f32 SinYaw   = Sine(HalfYaw);
+	f32 CosRoll  = Cosine(HalfRoll);
+	f32 SinRoll  = Sine(HalfRoll);
+
+	quat Result = quat(
+		CosRoll * CosYaw * SinPitch - SinRoll * SinYaw * CosPitch,
+		CosRoll * SinYaw * CosPitch + SinRoll * CosYaw * SinPitch,
+		SinRoll * CosYaw * CosPitch - CosRoll * SinYaw * SinPitch,
+		CosRoll * CosYaw * CosPitch + SinRoll * SinYaw * SinPitch
+	);
+	return Result;
+}
+
+static constexpr mat_4 QuatToMatrix(quat q)
+{
+	f32 XX = q.x * q.x, YY = q.y * q.y, ZZ = q.z * q.z;
+	f32 XY = q.x * q.y, XZ = q.x * q.z, YZ = q.y * q.z;
+	f32 WX = q.w * q.x, WY = q.w * q.y, WZ = q.w * q.z;
+
+	mat_4 Result = mat_4(
+		vec_4(1 - 2 * (YY + ZZ),     2 * (XY - WZ),     2 * (XZ + WY), 0),
+		vec_4(    2 * (XY + WZ), 1 - 2 * (XX + ZZ),     2 * (YZ - WX), 0),
+		vec_4(    2 * (XZ - WY),     2 * (YZ + WX), 1 - 2 * (XX + YY), 0),
+		vec_4(0                , 0                , 0                , 1)
+	);
+	return Result;
+}
+
+// v' = v + w * t + q.xyz x t, with t = 2 * (q.xyz x v).
+static constexpr vec_3 RotateVector(quat q, vec_3 v)
+{
+	vec_3 Axis   = vec_3(q.x, q.y, q.z);
+	vec_3 T      = VectorProduct(Axis, v) * 2.0f;
+	vec_3 Result = v + (T * q.w) + VectorProduct(Axis, T);
+	return Result;
+}
+
+// Normalized linear interpolation, taking the shortest arc.
+static constexpr quat Nlerp(quat From, quat To, f32 t)
+{
+	f32 Sign = Dot(From, To) < 0 ? -1.0f : 1.0f;
+	f32 s    = 1.0f - t;
+
+	quat Result = quat(
+		From.x * s + To.x * t * Sign,
+		From.y * s + To.y * t * Sign,
+		From.z * s + To.z * t * Sign,
+		From.w * s + To.w * t * Sign
+	);
+	return Normalize(Result);
+}
+
+static quat Slerp(quat From, quat To, f32 t)
+{
+	f32 CosAngle = Dot(From, To);
+	if (CosAngle < 0)
+	{
+		To       = quat(-To.x, -To.y, -To.z, -To.w);
+		CosAngle = -CosAngle;
+	}
+
+	// Nearly parallel: the sine below goes to zero and nlerp is just as accurate.
+	if (CosAngle > 0.9995f)
+	{
+		return Nlerp(From, To, t);
+	}
+
+	f32 Angle     = acosf(CosAngle);
+	f32 InvSin    = 1.0f / sinf(Angle);
+	f32 FromScale = sinf((1.0f - t) * Angle) * InvSin;
+	f32 ToScale   = sinf(t * Angle) * InvSin;
+
+	quat Result = quat(
+		From.x * FromScale + To.x * ToScale,
+		From.y * FromScale + To.y * ToScale,
+		From.z * FromScale + To.z * ToScale,
+		From.w * FromScale + To.w * ToScale
+	);
+	return Result;
+}
+
+static_assert(AreNearlyEqual(RotateVector(QuatFromEulerAngles(vec_3(0, 90, 0)), vec_3(1, 0, 0)), vec_3(0, 0, -1), 1e-6f),
+	          "QuatFromEulerAngles");
+static_assert(AreNearlyEqual(TransformPoint(MatrixToAffine(QuatToMatrix(QuatFromEulerAngles(vec_3(30, 60, 90)))), vec_3(1, 2, 3)),
+	                         TransformPoint(MatrixToAffine(RotationMatrixFromEulerAngles(vec_3(30, 60, 90))), vec_3(1, 2, 3)), 1e-5f),
+	          "QuatToMatrix");
@@ -0,0 +1,87 @@
+#pragma once
+
+// Compile-time backend selection for the math library.
+// SSE2 is the baseline on every x64 target. AVX and FMA are picked up from the
+// compiler flags (/arch:AVX2 on MSVC, -mavx -mfma or -march=native on GCC/Clang).
+// Define MATH_FORCE_SCALAR to get the original scalar code back, or MATH_NO_FMA
+// to keep the SIMD paths bit-identical to the scalar ones (FMA rounds once
+// per multiply-add, so it changes the low bits).
+
+#if !defined(MATH_FORCE_SCALAR) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MATH_SIMD_SSE2 1
+#include <emmintrin.h>
+#else
+#define MATH_SIMD_SSE2 0
+#endif
+
+#if MATH_SIMD_SSE2 && defined(__AVX__)
+#define MATH_SIMD_AVX 1
+#include <immintrin.h>
+#else
+#define MATH_SIMD_AVX 0
+#endif
+
+#if MATH_SIMD_AVX && !defined(MATH_NO_FMA) && (defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#define MATH_SIMD_FMA 1
+#else
+#define MATH_SIMD_FMA 0
+#endif
+
+// Hardware half <-> float conversion. Shipped with every AVX2 part; GCC/Clang need -mf16c.
+#if MATH_SIMD_AVX && (defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#define MATH_SIMD_F16C 1
+#else
+#define MATH_SIMD_F16C 0
+#endif
+
+#if MATH_SIMD_AVX
+#define MATH_BACKEND_NAME "AVX"
+#elif MATH_SIMD_SSE2
+#define MATH_BACKEND_NAME "SSE2"
+#else
+#define MATH_BACKEND_NAME "Scalar"
+#endif
+
+#if MATH_SIMD_SSE2
+// A * B + C
+inline static __m128 MulAdd4(__m128 A, __m128 B, __m128 C)
+{
+#if MATH_SIMD_FMA
+	return _mm_fmadd_ps(A, B, C);
+#else
+	return _mm_add_ps(_mm_mul_ps(A, B), C);
+#endif
+}
+
+template <int Lane>
+inline static __m128 Splat4(__m128 V)
+{
+	return _mm_shuffle_ps(V, V, _MM_SHUFFLE(Lane, Lane, Lane, Lane));
+}
+#endif
+
+#if MATH_SIMD_AVX
+inline static __m256 MulAdd8(__m256 A, __m256 B, __m256 C)
+{
+#if MATH_SIMD_FMA
+	return _mm256_fmadd_ps(A, B, C);
+#else
+	return _mm256_add_ps(_mm256_mul_ps(A, B), C);
+#endif
+}
+
+// Broadcasts a lane inside each 128-bit half.
+template <int Lane>
+inline static __m256 Splat8(__m256 V)
+{
+	return _mm256_shuffle_ps(V, V, _MM_SHUFFLE(Lane, Lane, Lane, Lane));
+}
+#endif
+
+// True while the compiler evaluates a constexpr call. Lets the constexpr math pick a
+// plain scalar path at compile time and the intrinsics at run time.
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define MATH_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#define MATH_CONSTANT_EVALUATED() false
+#endif
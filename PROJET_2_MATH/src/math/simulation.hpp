@@ -0,0 +1,99 @@
+#pragma once
+
+#include <string.h>
+
+#include "fixed.hpp"
+
+// Integration steps of the physics cube, shared by entities.cpp and bench/determinism_bench.cpp.
+// They are templated on the scalar type; the game uses sim_scalar, picked at compile time:
+// f64 by default, or Q32.32 fixed point (math/fixed.hpp) when MATH_DETERMINISTIC is defined.
+// In the fixed-point mode a trajectory is bit-identical on every compiler and optimization level,
+// which the checksum in the benchmark verifies. Floats only come back for rendering and the UI.
+
+#if defined(MATH_DETERMINISTIC)
+#define MATH_SIMULATION_DETERMINISTIC 1
+#define MATH_SIMULATION_NAME "Fixed Q32.32"
+typedef q32_32 sim_scalar;
+#else
+#define MATH_SIMULATION_DETERMINISTIC 0
+#define MATH_SIMULATION_NAME "Float f64"
+typedef f64 sim_scalar;
+#endif
+
+typedef vec<sim_scalar, 3> vec_3_sim;
+
+constexpr f32 CONSTANT_DELTA_TIME = 0.030f;
+constexpr f32 CUBE_UPDATE_DELTA_TIME = 0.015f;
+constexpr f32 CUBE_UPDATE_PUSH_MAGNITUDE = 2.0f;
+constexpr f32 CUBE_UPDATE_GRAVITY = -9.81f;
+constexpr f64 CUBE_SIMULATION_GRAVITY = -3.2;
+
+// Constant push along +x, plus gravity when enabled, then one explicit Euler step.
+template <typename T>
+static constexpr void IntegrateCubeForces(vec<T, 3>* Position, vec<T, 3>* Velocity, f32 Mass, bool AffectedByGravity)
+{
+	T CubeMass           = T(Mass);
+	vec<T, 3> PushForce  = Normalize(vec<T, 3>(T(1.0f), T(0.0f), T(0.0f))) * T(CUBE_UPDATE_PUSH_MAGNITUDE);
+	vec<T, 3> TotalForce = PushForce;
+
+	if (AffectedByGravity)
+	{
+		vec<T, 3> GravityForce = vec<T, 3>(T(0.0f), T(CUBE_UPDATE_GRAVITY), T(0.0f)) * CubeMass;
+		TotalForce             = GravityForce + PushForce;
+	}
+
+	vec<T, 3> TotalAccel = TotalForce / CubeMass;
+	*Velocity            = *Velocity + TotalAccel * T(CUBE_UPDATE_DELTA_TIME);
+	*Position            = *Position + *Velocity * T(CUBE_UPDATE_DELTA_TIME);
+}
+
+// Instantaneous change of velocity from a push of the given magnitude.
+template <typename T>
+static constexpr void AddPushImpulse(vec<T, 3>* Velocity, vec_3 Force, f32 Magnitude, f32 Mass)
+{
+	vec<T, 3> PushForce = Normalize(VectorCast<T>(Force)) * T(Magnitude);
+	*Velocity           = *Velocity + PushForce / T(Mass);
+}
+
+template <typename T>
+static constexpr void IntegrateGravity(vec<T, 3>* Velocity)
+{
+	vec<T, 3> GravityAccel = vec<T, 3>(T(0.0), T(CUBE_SIMULATION_GRAVITY), T(0.0));
+	*Velocity              = *Velocity + GravityAccel * T(CONSTANT_DELTA_TIME);
+}
+
+template <typename T>
+static constexpr void IntegratePosition(vec<T, 3>* Position, vec<T, 3> Velocity)
+{
+	*Position = *Position + Velocity * T(CONSTANT_DELTA_TIME);
+}
+
+// FNV-1a over the bits of a state, for comparing trajectories between builds.
+constexpr u64 SIMULATION_HASH_SEED = 0xCBF29CE484222325ull;
+
+inline static u64 SimulationBits(q32_32 Value)
+{
+	return SCAST(u64, Value.Raw);
+}
+
+inline static u64 SimulationBits(f64 Value)
+{
+	u64 Bits = 0;
+	memcpy(&Bits, &Value, sizeof(Bits));
+	return Bits;
+}
+
+template <typename T>
+inline static u64 HashSimulationState(u64 Hash, vec<T, 3> v)
+{
+	for (u32 Index = 0; Index < 3; Index++)
+	{
+		u64 Bits = SimulationBits(v[Index]);
+		for (u32 Byte = 0; Byte < sizeof(Bits); Byte++)
+		{
+			Hash ^= (Bits >> (8 * Byte)) & 0xFF;
+			Hash *= 0x100000001B3ull;
+		}
+	}
+	return Hash;
+}
\ No newline at end of file
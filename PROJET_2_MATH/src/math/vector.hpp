@@ -3,116 +3,308 @@
 #include <cmath>
 
 #include "utility/types.h"
+#include "simd.hpp"
+#include "const_math.hpp"
 
-struct vec_2
+// Half-precision float, storage only. Convert to f32 (math/convert.hpp) before doing math.
+struct f16
 {
+	u16 Bits;
+};
+
+// Fixed-size vector. The f32 instantiations are the vec_2/vec_3/vec_4 the rest of the code
+// uses; f64 is for long-running accumulation and f16 for packed storage.
+template <typename T, u32 N>
+struct vec;
+
+template <typename T>
+struct vec<T, 2>
+{
+	typedef T scalar;
+
 	union
 	{
-		struct { f32 x, y; };
-		f32 AsArray[2];
+		struct { T x, y; };
+		T AsArray[2];
 	};
 
-	vec_2() : x(0), y(0) {}
-	vec_2(f32 X, f32 Y) : x(X), y(Y) {}
+	constexpr vec() : x(), y() {}
+	constexpr vec(T X, T Y) : x(X), y(Y) {}
+
+	// Constant evaluation cannot index through the union, so it selects the member instead.
+	constexpr T& operator[](size_t Index)
+	{
+		if (MATH_CONSTANT_EVALUATED())
+		{
+			return Index == 0 ? x : y;
+		}
+		return AsArray[Index];
+	}
+
+	constexpr T operator[](size_t Index) const
+	{
+		if (MATH_CONSTANT_EVALUATED())
+		{
+			return Index == 0 ? x : y;
+		}
+		return AsArray[Index];
+	}
 };
 
+template <typename T>
+struct vec<T, 3>
+{
+	typedef T scalar;
+
+	union
+	{
+		struct { T x, y, z; };
+		T AsArray[3];
+	};
+
+	constexpr vec() : x(), y(), z() {}
+	constexpr vec(T X, T Y, T Z) : x(X), y(Y), z(Z) {}
+
+	constexpr T& operator[](size_t Index)
+	{
+		if (MATH_CONSTANT_EVALUATED())
+		{
+			return Index == 0 ? x : Index == 1 ? y : z;
+		}
+		return AsArray[Index];
+	}
+
+	constexpr T operator[](size_t Index) const
+	{
+		if (MATH_CONSTANT_EVALUATED())
+		{
+			return Index == 0 ? x : Index == 1 ? y : z;
+		}
+		return AsArray[Index];
+	}
+};
 
-struct vec_3
+template <typename T>
+struct vec<T, 4>
 {
+	typedef T scalar;
+
 	union
 	{
-		struct { f32 x, y, z; };
-		f32 AsArray[3];
+		struct { T x, y, z, w; };
+		T AsArray[4];
 	};
 
-	vec_3() : x(0), y(0), z(0) {}
-	vec_3(f32 X, f32 Y, f32 Z) : x(X), y(Y), z(Z) {}
+	constexpr vec() : x(), y(), z(), w() {}
+	constexpr vec(T X, T Y, T Z, T W) : x(X), y(Y), z(Z), w(W) {}
+
+	constexpr T& operator[](size_t Index)
+	{
+		if (MATH_CONSTANT_EVALUATED())
+		{
+			return Index == 0 ? x : Index == 1 ? y : Index == 2 ? z : w;
+		}
+		return AsArray[Index];
+	}
+
+	constexpr T operator[](size_t Index) const
+	{
+		if (MATH_CONSTANT_EVALUATED())
+		{
+			return Index == 0 ? x : Index == 1 ? y : Index == 2 ? z : w;
+		}
+		return AsArray[Index];
+	}
 };
 
-struct vec_4
+// Same as the generic vec<T, 4>, plus the SSE register view.
+template <>
+struct vec<f32, 4>
 {
+	typedef f32 scalar;
+
 	union
 	{
 		struct { f32 x, y, z, w; };
 		f32 AsArray[4];
+#if MATH_SIMD_SSE2
+		__m128 AsSIMD;
+#endif
 	};
 
-	vec_4() : x(0), y(0), z(0) {}
-	vec_4(f32 X, f32 Y, f32 Z, f32 W) : x(X), y(Y), z(Z), w(W) {}
+	constexpr vec() : x(0), y(0), z(0), w(0) {}
+	constexpr vec(f32 X, f32 Y, f32 Z, f32 W) : x(X), y(Y), z(Z), w(W) {}
+#if MATH_SIMD_SSE2
+	vec(__m128 V) : AsSIMD(V) {}
+#endif
 
-	f32& operator[](size_t Index) { return (&x)[Index]; }
+	constexpr f32& operator[](size_t Index)
+	{
+		if (MATH_CONSTANT_EVALUATED())
+		{
+			return Index == 0 ? x : Index == 1 ? y : Index == 2 ? z : w;
+		}
+		return AsArray[Index];
+	}
+
+	constexpr f32 operator[](size_t Index) const
+	{
+		if (MATH_CONSTANT_EVALUATED())
+		{
+			return Index == 0 ? x : Index == 1 ? y : Index == 2 ? z : w;
+		}
+		return AsArray[Index];
+	}
 };
 
+typedef vec<f32, 2> vec_2;
+typedef vec<f32, 3> vec_3;
+typedef vec<f32, 4> vec_4;
+
+typedef vec<f64, 2> vec_2_f64;
+typedef vec<f64, 3> vec_3_f64;
+typedef vec<f64, 4> vec_4_f64;
+
+typedef vec<f16, 2> vec_2_f16;
+typedef vec<f16, 3> vec_3_f16;
+typedef vec<f16, 4> vec_4_f16;
+
+static_assert(sizeof(vec_3) == 3 * sizeof(f32) && sizeof(vec_3_f16) == 3 * sizeof(f16), "vec must stay packed");
+
 constexpr u32 VEC_4_LENGTH = 4;
 constexpr u32 VEC_3_LENGTH = 3;
 
-inline static vec_3 operator+(vec_3 vl, vec_3 vr)
+// The scalar parameters use vec<T, N>::scalar so that they convert instead of taking part in deduction.
+
+template <typename T, u32 N>
+static constexpr vec<T, N> operator+(vec<T, N> vl, vec<T, N> vr)
 {
-	vec_3 Result = vec_3(vl.x + vr.x, vl.y + vr.y, vl.z + vr.z);
+	vec<T, N> Result;
+	for (u32 Index = 0; Index < N; Index++)
+	{
+		Result[Index] = vl[Index] + vr[Index];
+	}
 	return Result;
 }
 
-inline static vec_3 operator-(vec_3 vl, vec_3 vr)
+template <typename T, u32 N>
+static constexpr vec<T, N> operator-(vec<T, N> vl, vec<T, N> vr)
 {
-	vec_3 Result = vec_3(vl.x - vr.x, vl.y - vr.y, vl.z - vr.z);
+	vec<T, N> Result;
+	for (u32 Index = 0; Index < N; Index++)
+	{
+		Result[Index] = vl[Index] - vr[Index];
+	}
 	return Result;
 }
 
-inline static vec_3 operator*(vec_3 v, f32 Scalar)
+template <typename T, u32 N>
+static constexpr vec<T, N> operator*(vec<T, N> v, typename vec<T, N>::scalar Scalar)
 {
-	vec_3 Result = vec_3(v.x * Scalar, v.y * Scalar, v.z * Scalar);
+	vec<T, N> Result;
+	for (u32 Index = 0; Index < N; Index++)
+	{
+		Result[Index] = v[Index] * Scalar;
+	}
 	return Result;
 }
 
-inline static vec_3 operator/(vec_3 v, f32 Divider)
+template <typename T, u32 N>
+static constexpr vec<T, N> operator/(vec<T, N> v, typename vec<T, N>::scalar Divider)
 {
-	vec_3 Result = vec_3();
-	Result.x = v.x / Divider;
-	Result.y = v.y / Divider;
-	Result.z = v.z / Divider;
+	vec<T, N> Result;
+	for (u32 Index = 0; Index < N; Index++)
+	{
+		Result[Index] = v[Index] / Divider;
+	}
 	return Result;
 }
 
-inline static bool AreEqual(vec_3 vl, vec_3 vr)
+template <typename T, u32 N>
+static constexpr bool AreEqual(vec<T, N> vl, vec<T, N> vr)
 {
-	bool Result = (vl.x == vr.x) && (vl.y == vr.y) && (vl.z == vr.z);
+	bool Result = true;
+	for (u32 Index = 0; Index < N; Index++)
+	{
+		Result = Result && (vl[Index] == vr[Index]);
+	}
+	return Result;
+}
+
+template <typename T, u32 N>
+static constexpr bool AreNearlyEqual(vec<T, N> vl, vec<T, N> vr, typename vec<T, N>::scalar Tolerance)
+{
+	bool Result = true;
+	for (u32 Index = 0; Index < N; Index++)
+	{
+		T Delta = vl[Index] - vr[Index];
+		Result  = Result && (Delta <= Tolerance && Delta >= -Tolerance);
+	}
 	return Result;
 }
 
-inline static bool IsZeroVector(vec_3 v)
+template <typename T, u32 N>
+static constexpr bool IsZeroVector(vec<T, N> v)
 {
-	bool Result = (v.x == 0) && (v.y == 0) && (v.z == 0);
+	bool Result = true;
+	for (u32 Index = 0; Index < N; Index++)
+	{
+		Result = Result && (v[Index] == 0);
+	}
 	return Result;
 }
 
-inline static vec_3 ScaleVector(vec_3 v, f32 Scalar)
+template <typename T, u32 N>
+static constexpr vec<T, N> ScaleVector(vec<T, N> v, typename vec<T, N>::scalar Scalar)
 {
-	vec_3 Result = vec_3(v.x * Scalar, v.y * Scalar, v.z * Scalar);
+	vec<T, N> Result = v * Scalar;
 	return Result;
 }
 
-inline static f32 Dot(vec_3 vl, vec_3 vr)
+// Element-wise conversion between arithmetic types, e.g. VectorCast<f64>(Velocity).
+template <typename To, typename From, u32 N>
+static constexpr vec<To, N> VectorCast(vec<From, N> v)
 {
-	f32 Result = 0;
-	Result += vl.x * vr.x;
-	Result += vl.y * vr.y;
-	Result += vl.z * vr.z;
+	vec<To, N> Result;
+	for (u32 Index = 0; Index < N; Index++)
+	{
+		Result[Index] = SCAST(To, v[Index]);
+	}
 	return Result;
 }
 
-inline static f32 Dot(vec_4 vl, vec_4 vr)
+template <typename T, u32 N>
+static constexpr T Dot(vec<T, N> vl, vec<T, N> vr)
 {
-	f32 Result = 0;
-	for (u32 VectorIndex = 0; VectorIndex < VEC_4_LENGTH; VectorIndex++)
+	T Result = 0;
+	for (u32 Index = 0; Index < N; Index++)
 	{
-		Result += vl.AsArray[VectorIndex] * vr.AsArray[VectorIndex];
+		Result += vl[Index] * vr[Index];
 	}
 	return Result;
 }
 
-inline static vec_3 VectorProduct(vec_3 vl, vec_3 vr)
+static constexpr f32 Dot(vec_4 vl, vec_4 vr)
+{
+#if MATH_SIMD_SSE2
+	if (!MATH_CONSTANT_EVALUATED())
+	{
+		// Lanes are summed in x, y, z, w order to match the scalar path bit for bit.
+		__m128 Product = _mm_mul_ps(vl.AsSIMD, vr.AsSIMD);
+		__m128 Sum     = _mm_add_ss(_mm_setzero_ps(), Product);
+		Sum            = _mm_add_ss(Sum, Splat4<1>(Product));
+		Sum            = _mm_add_ss(Sum, Splat4<2>(Product));
+		Sum            = _mm_add_ss(Sum, Splat4<3>(Product));
+		return _mm_cvtss_f32(Sum);
+	}
+#endif
+	return Dot<f32, VEC_4_LENGTH>(vl, vr);
+}
+
+template <typename T>
+static constexpr vec<T, 3> VectorProduct(vec<T, 3> vl, vec<T, 3> vr)
 {
-	vec_3 Result = vec_3(
+	vec<T, 3> Result = vec<T, 3>(
 		(vl.y * vr.z) - (vl.z * vr.y),
 		(vl.z * vr.x) - (vl.x * vr.z),
 		(vl.x * vr.y) - (vl.y * vr.x)
@@ -120,33 +312,45 @@ inline static vec_3 VectorProduct(vec_3 vl, vec_3 vr)
 	return Result;
 }
 
-inline static f32 VectorLength(vec_3 v)
+template <typename T, u32 N>
+static constexpr T VectorLength(vec<T, N> v)
 {
-	f32 SquaredSum = 0;
-	SquaredSum += v.x * v.x;
-	SquaredSum += v.y * v.y;
-	SquaredSum += v.z * v.z;
-
+	T SquaredSum = Dot(v, v);
 	if (SquaredSum >= 0)
 	{
-		f32 Result = sqrtf(SquaredSum);
+		T Result = SquareRoot(SquaredSum);
 		return Result;
 	}
 	
 	return 0;
 }
 
-static vec_3 Normalize(vec_3 v)
+template <typename T, u32 N>
+static constexpr vec<T, N> Normalize(vec<T, N> v)
 {
-	f32 Length   = VectorLength(v);
-	vec_3 Result = vec_3(
-		v.x / Length,
-		v.y / Length,
-		v.z / Length
-	);
+	T Length = VectorLength(v);
+	vec<T, N> Result = v / Length;
 	return Result;
 }
 
+// One rsqrt with a Newton step and three multiplies instead of sqrtf and three divides.
+// Max relative error per component 2.9e-7.
+static constexpr vec_3 FastNormalize(vec_3 v)
+{
+	vec_3 Result = v * InverseSquareRoot(Dot(v, v));
+	return Result;
+}
+
+// f32 vectors follow the precision policy, see precision.hpp.
+static constexpr vec_3 Normalize(vec_3 v)
+{
+#if MATH_PRECISION_FAST
+	return FastNormalize(v);
+#else
+	return Normalize<f32, VEC_3_LENGTH>(v);
+#endif
+}
+
 static f32 GetAngleBetween(vec_3 vl, vec_3 vr)
 {
 	f32 LengthLeft  = VectorLength(vl);
@@ -164,26 +368,28 @@ static f32 GetAngleBetween(vec_3 vl, vec_3 vr)
 	return 0.0f;
 }
 
-static vec_3 ProjectVectorOnVector(vec_3 pv, vec_3 tv)
+template <typename T, u32 N>
+static constexpr vec<T, N> ProjectVectorOnVector(vec<T, N> pv, vec<T, N> tv)
 {
-	f32 Denom = Dot(tv, tv);
+	T Denom = Dot(tv, tv);
 	if (Denom != 0)
 	{
-		f32 Numer = Dot(pv, tv);
-		f32 Scale = Numer / Denom;
+		T Numer = Dot(pv, tv);
+		T Scale = Numer / Denom;
 
-		vec_3 Projection = tv * Scale;
+		vec<T, N> Projection = tv * Scale;
 		return Projection;
 	}
 
-	return vec_3();
+	return vec<T, N>();
 }
 
-static vec_3 ProjectVectorOnPlane(vec_3 v, vec_3 pn)
+template <typename T, u32 N>
+static constexpr vec<T, N> ProjectVectorOnPlane(vec<T, N> v, vec<T, N> pn)
 {
-	vec_3 n                  = Normalize(pn);
-	vec_3 ProjectionOnNormal = n * Dot(v, n);
-	vec_3 ProjectionOnPlane  = v - ProjectionOnNormal;
+	vec<T, N> n                  = Normalize(pn);
+	vec<T, N> ProjectionOnNormal = n * Dot(v, n);
+	vec<T, N> ProjectionOnPlane  = v - ProjectionOnNormal;
 
 	return ProjectionOnPlane;
 }
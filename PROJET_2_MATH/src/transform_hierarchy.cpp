@@ -0,0 +1,483 @@
+#include "math/matrix.hpp"
+#include "utility/allocators.h"
+#include "utility/pool_allocator.h"
+#include "utility/instance_capacity.h"
+
+// -----------------
+// Transform hierarchy
+// -----------------
+// Parent/child transforms in one flat array where every parent comes before its children. Editing
+// a transform only stores its local matrix and sets its dirty bit; the world matrices are
+// recomputed once per frame by UpdateWorldTransforms, in a single linear pass where each node
+// inherits its parent's dirty bit. Moving a parent therefore costs one pass over the
+// array, whatever the number of descendants or edits.
+//
+// Entities hold a transform_id, which stays valid when the array is sorted again: Slots maps
+// ids to positions in the array and Ids maps back. Destroyed ids are handed out again, so an
+// entity drops its id when it destroys the transform. Each transform also links its children, by
+// id, so destroying or moving one only visits its children.
+//
+// The arrays hold Capacity transforms and grow with GrowInstanceCapacity. Each one has its own
+// BUMP_RESIZABLE arena reserved for TRANSFORM_MAX_COUNT transforms, so growing commits pages in
+// place and never moves or copies a transform.
+
+constexpr u32 TRANSFORM_NONE = 0xFFFFFFFF;
+
+// Vectors and cubes each come from a pool, and each has a transform.
+constexpr u32 TRANSFORM_MAX_COUNT = 2 * POOL_MAX_COUNT;
+
+typedef u32 transform_id;
+
+enum TRANSFORM_ARRAY
+{
+    TRANSFORM_ARRAY_FREE_IDS,
+    TRANSFORM_ARRAY_IDS,
+    TRANSFORM_ARRAY_PARENTS,
+    TRANSFORM_ARRAY_LOCALS,
+    TRANSFORM_ARRAY_WORLDS,
+    TRANSFORM_ARRAY_DIRTY_BITS,
+    TRANSFORM_ARRAY_SLOTS,
+    TRANSFORM_ARRAY_CHANGED_BITS,
+    TRANSFORM_ARRAY_FIRST_CHILDREN,
+    TRANSFORM_ARRAY_NEXT_SIBLINGS,
+    TRANSFORM_ARRAY_PREVIOUS_SIBLINGS,
+
+    TRANSFORM_ARRAY_COUNT
+};
+
+struct transform_hierarchy
+{
+    u32            Count;
+    u32            Capacity;
+    bool           NeedsSort;
+    u32            ChangedCount;
+    u32            FreeIdCount;
+    transform_id*  FreeIds;
+    bump_allocator Arrays[TRANSFORM_ARRAY_COUNT];
+    bump_allocator SortScratch;
+
+    // Indexed by slot, in depth order.
+    transform_id*  Ids;
+    u32*           Parents;
+    affine_3x4*    Locals;
+    affine_3x4*    Worlds;
+    u64*           DirtyBits;
+
+    // Indexed by id.
+    u32*           Slots;
+    u64*           ChangedBits;
+    transform_id*  FirstChildren;
+    transform_id*  NextSiblings;
+    transform_id*  PreviousSiblings;
+};
+
+static transform_hierarchy TransformHierarchy;
+
+static inline void SetTransformBit(u64* Bits, u32 Index)
+{
+    Bits[Index / 64] |= SCAST(u64, 1) << (Index % 64);
+}
+
+static inline void ClearTransformBit(u64* Bits, u32 Index)
+{
+    Bits[Index / 64] &= ~(SCAST(u64, 1) << (Index % 64));
+}
+
+static inline bool IsTransformBitSet(const u64* Bits, u32 Index)
+{
+    return (Bits[Index / 64] >> (Index % 64)) & 1;
+}
+
+static inline size_t GetTransformBitsSize(u32 Capacity)
+{
+    return (Capacity + 63) / 64 * sizeof(u64);
+}
+
+static size_t GetTransformArraySize(u32 ArrayIndex, u32 Capacity)
+{
+    switch (ArrayIndex)
+    {
+    case TRANSFORM_ARRAY_DIRTY_BITS:
+    case TRANSFORM_ARRAY_CHANGED_BITS: return GetTransformBitsSize(Capacity);
+    case TRANSFORM_ARRAY_LOCALS:
+    case TRANSFORM_ARRAY_WORLDS:       return SCAST(size_t, Capacity) * sizeof(affine_3x4);
+    default:                           return SCAST(size_t, Capacity) * sizeof(u32);
+    }
+}
+
+static void* CreateTransformArray(u32 ArrayIndex)
+{
+    bump_allocator* Arena = &TransformHierarchy.Arrays[ArrayIndex];
+    *Arena = CreateBumpAllocator(0, BUMP_RESIZABLE, "Transforms", 2, GetTransformArraySize(ArrayIndex, TRANSFORM_MAX_COUNT));
+    return Arena->Memory;
+}
+
+// The arrays never move, so their pointers are set once, before the first transform.
+static void CreateTransformArrays()
+{
+    transform_hierarchy* Hierarchy = &TransformHierarchy;
+    Hierarchy->FreeIds             = SCAST(transform_id*, CreateTransformArray(TRANSFORM_ARRAY_FREE_IDS));
+    Hierarchy->Ids                 = SCAST(transform_id*, CreateTransformArray(TRANSFORM_ARRAY_IDS));
+    Hierarchy->Parents             = SCAST(u32*, CreateTransformArray(TRANSFORM_ARRAY_PARENTS));
+    Hierarchy->Locals              = SCAST(affine_3x4*, CreateTransformArray(TRANSFORM_ARRAY_LOCALS));
+    Hierarchy->Worlds              = SCAST(affine_3x4*, CreateTransformArray(TRANSFORM_ARRAY_WORLDS));
+    Hierarchy->DirtyBits           = SCAST(u64*, CreateTransformArray(TRANSFORM_ARRAY_DIRTY_BITS));
+    Hierarchy->Slots               = SCAST(u32*, CreateTransformArray(TRANSFORM_ARRAY_SLOTS));
+    Hierarchy->ChangedBits         = SCAST(u64*, CreateTransformArray(TRANSFORM_ARRAY_CHANGED_BITS));
+    Hierarchy->FirstChildren       = SCAST(transform_id*, CreateTransformArray(TRANSFORM_ARRAY_FIRST_CHILDREN));
+    Hierarchy->NextSiblings        = SCAST(transform_id*, CreateTransformArray(TRANSFORM_ARRAY_NEXT_SIBLINGS));
+    Hierarchy->PreviousSiblings    = SCAST(transform_id*, CreateTransformArray(TRANSFORM_ARRAY_PREVIOUS_SIBLINGS));
+
+    // The sort's copies, reset on every sort.
+    size_t SortSize        = SCAST(size_t, TRANSFORM_MAX_COUNT) * (6 * sizeof(u32) + 2 * sizeof(affine_3x4)) +
+                             GetTransformBitsSize(TRANSFORM_MAX_COUNT) + 9 * BUMP_CACHE_LINE;
+    Hierarchy->SortScratch = CreateBumpAllocator(0, BUMP_RESIZABLE, "Transform Sort", 2, SortSize);
+}
+
+// Makes room for Required transforms. The new bits are clear.
+static bool ReserveTransformCapacity(u32 Required)
+{
+    transform_hierarchy* Hierarchy = &TransformHierarchy;
+    u32 OldCapacity                = Hierarchy->Capacity;
+    u32 Capacity                   = GrowInstanceCapacity(OldCapacity, Required);
+    if (Capacity == OldCapacity)
+    {
+        return true;
+    }
+
+    if (OldCapacity == 0)
+    {
+        CreateTransformArrays();
+    }
+    for (u32 ArrayIndex = 0; ArrayIndex < TRANSFORM_ARRAY_COUNT; ArrayIndex++)
+    {
+        if (!GrowInPlace(GetTransformArraySize(ArrayIndex, Capacity), &Hierarchy->Arrays[ArrayIndex]))
+        {
+            return false;
+        }
+    }
+
+    size_t OldBitsSize = GetTransformBitsSize(OldCapacity);
+    size_t BitsSize    = GetTransformBitsSize(Capacity);
+    memset((u8*)Hierarchy->DirtyBits + OldBitsSize, 0, BitsSize - OldBitsSize);
+    memset((u8*)Hierarchy->ChangedBits + OldBitsSize, 0, BitsSize - OldBitsSize);
+    Hierarchy->Capacity = Capacity;
+    return true;
+}
+
+// New transforms are roots. Groups of vectors are plain transforms that the vectors attach to.
+// Destroyed ids are reused first. Returns TRANSFORM_NONE if the hierarchy cannot grow.
+static transform_id CreateTransform(affine_3x4 Local = affine_3x4())
+{
+    transform_hierarchy* Hierarchy = &TransformHierarchy;
+    if (!ReserveTransformCapacity(Hierarchy->Count + 1))
+    {
+        return TRANSFORM_NONE;
+    }
+
+    // Without free ids, the ids in use are exactly 0 to Count - 1.
+    u32 Slot          = Hierarchy->Count;
+    transform_id Id   = Hierarchy->FreeIdCount > 0 ? Hierarchy->FreeIds[--Hierarchy->FreeIdCount] : Hierarchy->Count;
+    Hierarchy->Count += 1;
+
+    Hierarchy->Ids[Slot]             = Id;
+    Hierarchy->Parents[Slot]         = TRANSFORM_NONE;
+    Hierarchy->Locals[Slot]          = Local;
+    Hierarchy->Slots[Id]             = Slot;
+    Hierarchy->FirstChildren[Id]     = TRANSFORM_NONE;
+    Hierarchy->NextSiblings[Id]      = TRANSFORM_NONE;
+    Hierarchy->PreviousSiblings[Id]  = TRANSFORM_NONE;
+    SetTransformBit(Hierarchy->DirtyBits, Slot);
+    return Id;
+}
+
+// Stores the local matrix, relative to the parent. Nothing else is computed until the next pass.
+static void SetTransformLocal(transform_id Id, affine_3x4 Local)
+{
+    if (Id == TRANSFORM_NONE)
+    {
+        return;
+    }
+
+    u32 Slot                        = TransformHierarchy.Slots[Id];
+    TransformHierarchy.Locals[Slot] = Local;
+    SetTransformBit(TransformHierarchy.DirtyBits, Slot);
+}
+
+static transform_id GetTransformParent(transform_id Id)
+{
+    u32 ParentSlot = TransformHierarchy.Parents[TransformHierarchy.Slots[Id]];
+    return ParentSlot == TRANSFORM_NONE ? TRANSFORM_NONE : TransformHierarchy.Ids[ParentSlot];
+}
+
+static void LinkTransformChild(transform_id Parent, transform_id Child)
+{
+    transform_hierarchy* Hierarchy = &TransformHierarchy;
+    if (Parent == TRANSFORM_NONE)
+    {
+        return;
+    }
+
+    transform_id Next                  = Hierarchy->FirstChildren[Parent];
+    Hierarchy->NextSiblings[Child]     = Next;
+    Hierarchy->PreviousSiblings[Child] = TRANSFORM_NONE;
+    Hierarchy->FirstChildren[Parent]   = Child;
+    if (Next != TRANSFORM_NONE)
+    {
+        Hierarchy->PreviousSiblings[Next] = Child;
+    }
+}
+
+static void UnlinkTransformChild(transform_id Child)
+{
+    transform_hierarchy* Hierarchy = &TransformHierarchy;
+    transform_id Parent            = GetTransformParent(Child);
+    transform_id Previous          = Hierarchy->PreviousSiblings[Child];
+    transform_id Next              = Hierarchy->NextSiblings[Child];
+    if (Previous != TRANSFORM_NONE)
+    {
+        Hierarchy->NextSiblings[Previous] = Next;
+    }
+    else if (Parent != TRANSFORM_NONE)
+    {
+        Hierarchy->FirstChildren[Parent] = Next;
+    }
+    if (Next != TRANSFORM_NONE)
+    {
+        Hierarchy->PreviousSiblings[Next] = Previous;
+    }
+    Hierarchy->NextSiblings[Child]     = TRANSFORM_NONE;
+    Hierarchy->PreviousSiblings[Child] = TRANSFORM_NONE;
+}
+
+// Points the children of the transform in Slot at it again, after it moved.
+static void RepointTransformChildren(u32 Slot)
+{
+    transform_hierarchy* Hierarchy = &TransformHierarchy;
+    for (transform_id Child = Hierarchy->FirstChildren[Hierarchy->Ids[Slot]]; Child != TRANSFORM_NONE; Child = Hierarchy->NextSiblings[Child])
+    {
+        Hierarchy->Parents[Hierarchy->Slots[Child]] = Slot;
+    }
+}
+
+static void CopyTransformSlot(u32 From, u32 To)
+{
+    transform_hierarchy* Hierarchy = &TransformHierarchy;
+    Hierarchy->Ids[To]     = Hierarchy->Ids[From];
+    Hierarchy->Parents[To] = Hierarchy->Parents[From];
+    Hierarchy->Locals[To]  = Hierarchy->Locals[From];
+    Hierarchy->Worlds[To]  = Hierarchy->Worlds[From];
+    Hierarchy->Slots[Hierarchy->Ids[To]] = To;
+    if (IsTransformBitSet(Hierarchy->DirtyBits, From))
+    {
+        SetTransformBit(Hierarchy->DirtyBits, To);
+    }
+    else
+    {
+        ClearTransformBit(Hierarchy->DirtyBits, To);
+    }
+}
+
+// Parent is TRANSFORM_NONE to detach. The local matrix is kept, so the child now moves relative
+// to its new parent. Fails when Parent is Child or one of its descendants.
+static bool AttachTransform(transform_id Child, transform_id Parent)
+{
+    transform_hierarchy* Hierarchy = &TransformHierarchy;
+    if (Child == TRANSFORM_NONE)
+    {
+        return false;
+    }
+
+    for (transform_id Ancestor = Parent; Ancestor != TRANSFORM_NONE; Ancestor = GetTransformParent(Ancestor))
+    {
+        if (Ancestor == Child)
+        {
+            return false;
+        }
+    }
+
+    UnlinkTransformChild(Child);
+    LinkTransformChild(Parent, Child);
+
+    // A parent before the child keeps the order: the child's descendants already follow it.
+    u32 ChildSlot                 = Hierarchy->Slots[Child];
+    u32 ParentSlot                = Parent == TRANSFORM_NONE ? TRANSFORM_NONE : Hierarchy->Slots[Parent];
+    Hierarchy->Parents[ChildSlot] = ParentSlot;
+    Hierarchy->NeedsSort          = Hierarchy->NeedsSort || (ParentSlot != TRANSFORM_NONE && ParentSlot > ChildSlot);
+    SetTransformBit(Hierarchy->DirtyBits, ChildSlot);
+    return true;
+}
+
+// The children become roots and keep their local matrix. The last slot moves into the hole. It has
+// no children, since they would come after it, but its parent can follow the hole: then the two swap
+// places, up the ancestors, until the parent comes first again. That costs the children of the moved
+// transforms, never a pass over the array or a sort.
+static void DestroyTransform(transform_id Id)
+{
+    transform_hierarchy* Hierarchy = &TransformHierarchy;
+    if (Id == TRANSFORM_NONE)
+    {
+        return;
+    }
+
+    for (transform_id Child = Hierarchy->FirstChildren[Id]; Child != TRANSFORM_NONE;)
+    {
+        transform_id Next = Hierarchy->NextSiblings[Child];
+        u32 ChildSlot     = Hierarchy->Slots[Child];
+
+        Hierarchy->Parents[ChildSlot]      = TRANSFORM_NONE;
+        Hierarchy->NextSiblings[Child]     = TRANSFORM_NONE;
+        Hierarchy->PreviousSiblings[Child] = TRANSFORM_NONE;
+        SetTransformBit(Hierarchy->DirtyBits, ChildSlot);
+        Child = Next;
+    }
+    Hierarchy->FirstChildren[Id] = TRANSFORM_NONE;
+    UnlinkTransformChild(Id);
+
+    u32 Slot     = Hierarchy->Slots[Id];
+    u32 LastSlot = Hierarchy->Count - 1;
+    if (Slot != LastSlot)
+    {
+        CopyTransformSlot(LastSlot, Slot);
+        RepointTransformChildren(Slot);
+
+        for (u32 ParentSlot = Hierarchy->Parents[Slot]; ParentSlot != TRANSFORM_NONE && ParentSlot > Slot;
+             ParentSlot = Hierarchy->Parents[Slot])
+        {
+            CopyTransformSlot(Slot, LastSlot);
+            CopyTransformSlot(ParentSlot, Slot);
+            CopyTransformSlot(LastSlot, ParentSlot);
+            RepointTransformChildren(Slot);
+            RepointTransformChildren(ParentSlot);
+        }
+    }
+
+    ClearTransformBit(Hierarchy->DirtyBits, LastSlot);
+    ClearTransformBit(Hierarchy->ChangedBits, Id);
+    Hierarchy->Count                             = LastSlot;
+    Hierarchy->FreeIds[Hierarchy->FreeIdCount++] = Id;
+}
+
+// Stable counting sort by depth. Only runs after AttachTransform put a parent after its child.
+static void SortTransformHierarchy()
+{
+    transform_hierarchy* Hierarchy = &TransformHierarchy;
+    u32 Count                      = Hierarchy->Count;
+    size_t BitsSize                = GetTransformBitsSize(Count);
+
+    bump_allocator* Scratch = &Hierarchy->SortScratch;
+    ResetAllocator(Scratch);
+    u32* Depths              = PushArray<u32>(Count, Scratch, BUMP_CACHE_LINE);
+    u32* DepthOffsets        = PushArray<u32>(Count + 1, Scratch, BUMP_CACHE_LINE);
+    u32* NewSlots            = PushArray<u32>(Count, Scratch, BUMP_CACHE_LINE);
+    transform_id* SortedIds  = PushArray<transform_id>(Count, Scratch, BUMP_CACHE_LINE);
+    u32* SortedParents       = PushArray<u32>(Count, Scratch, BUMP_CACHE_LINE);
+    affine_3x4* SortedLocals = PushArray<affine_3x4>(Count, Scratch, BUMP_CACHE_LINE);
+    affine_3x4* SortedWorlds = PushArray<affine_3x4>(Count, Scratch, BUMP_CACHE_LINE);
+    u64* SortedDirtyBits     = PushArray<u64>(BitsSize / sizeof(u64), Scratch, BUMP_CACHE_LINE);
+    if (!Depths || !DepthOffsets || !NewSlots || !SortedIds || !SortedParents || !SortedLocals || !SortedWorlds || !SortedDirtyBits)
+    {
+        return;
+    }
+
+    u32 MaxDepth = 0;
+    for (u32 Slot = 0; Slot < Count; Slot++)
+    {
+        u32 Depth = 0;
+        for (u32 Parent = Hierarchy->Parents[Slot]; Parent != TRANSFORM_NONE; Parent = Hierarchy->Parents[Parent])
+        {
+            Depth += 1;
+        }
+        Depths[Slot] = Depth;
+        MaxDepth     = Depth > MaxDepth ? Depth : MaxDepth;
+    }
+
+    memset(DepthOffsets, 0, (MaxDepth + 2) * sizeof(u32));
+    for (u32 Slot = 0; Slot < Count; Slot++)
+    {
+        DepthOffsets[Depths[Slot] + 1] += 1;
+    }
+    for (u32 Depth = 0; Depth <= MaxDepth; Depth++)
+    {
+        DepthOffsets[Depth + 1] += DepthOffsets[Depth];
+    }
+    for (u32 Slot = 0; Slot < Count; Slot++)
+    {
+        NewSlots[Slot] = DepthOffsets[Depths[Slot]]++;
+    }
+
+    memset(SortedDirtyBits, 0, BitsSize);
+    for (u32 Slot = 0; Slot < Count; Slot++)
+    {
+        u32 NewSlot            = NewSlots[Slot];
+        u32 Parent             = Hierarchy->Parents[Slot];
+        SortedIds[NewSlot]     = Hierarchy->Ids[Slot];
+        SortedParents[NewSlot] = Parent == TRANSFORM_NONE ? TRANSFORM_NONE : NewSlots[Parent];
+        SortedLocals[NewSlot]  = Hierarchy->Locals[Slot];
+        SortedWorlds[NewSlot]  = Hierarchy->Worlds[Slot];
+        if (IsTransformBitSet(Hierarchy->DirtyBits, Slot))
+        {
+            SetTransformBit(SortedDirtyBits, NewSlot);
+        }
+    }
+
+    memcpy(Hierarchy->Ids, SortedIds, Count * sizeof(transform_id));
+    memcpy(Hierarchy->Parents, SortedParents, Count * sizeof(u32));
+    memcpy(Hierarchy->Locals, SortedLocals, Count * sizeof(affine_3x4));
+    memcpy(Hierarchy->Worlds, SortedWorlds, Count * sizeof(affine_3x4));
+    memcpy(Hierarchy->DirtyBits, SortedDirtyBits, BitsSize);
+    for (u32 Slot = 0; Slot < Count; Slot++)
+    {
+        Hierarchy->Slots[Hierarchy->Ids[Slot]] = Slot;
+    }
+    Hierarchy->NeedsSort = false;
+}
+
+// The once-per-frame pass. Afterwards IsTransformChanged tells which world matrices it rewrote;
+// returns how many.
+static u32 UpdateWorldTransforms()
+{
+    transform_hierarchy* Hierarchy = &TransformHierarchy;
+    if (Hierarchy->Capacity == 0)
+    {
+        return 0;
+    }
+    if (Hierarchy->NeedsSort)
+    {
+        SortTransformHierarchy();
+    }
+
+    memset(Hierarchy->ChangedBits, 0, GetTransformBitsSize(Hierarchy->Capacity));
+    Hierarchy->ChangedCount = 0;
+
+    for (u32 Slot = 0; Slot < Hierarchy->Count; Slot++)
+    {
+        u32 Parent = Hierarchy->Parents[Slot];
+        if (Parent != TRANSFORM_NONE && IsTransformBitSet(Hierarchy->DirtyBits, Parent))
+        {
+            SetTransformBit(Hierarchy->DirtyBits, Slot);
+        }
+        if (!IsTransformBitSet(Hierarchy->DirtyBits, Slot))
+        {
+            continue;
+        }
+
+        Hierarchy->Worlds[Slot] = Parent == TRANSFORM_NONE ? Hierarchy->Locals[Slot]
+                                                           : Hierarchy->Worlds[Parent] * Hierarchy->Locals[Slot];
+        SetTransformBit(Hierarchy->ChangedBits, Hierarchy->Ids[Slot]);
+        Hierarchy->ChangedCount += 1;
+    }
+
+    memset(Hierarchy->DirtyBits, 0, GetTransformBitsSize(Hierarchy->Capacity));
+    return Hierarchy->ChangedCount;
+}
+
+static bool IsTransformChanged(transform_id Id)
+{
+    return Id != TRANSFORM_NONE && IsTransformBitSet(TransformHierarchy.ChangedBits, Id);
+}
+
+static affine_3x4 GetWorldTransform(transform_id Id)
+{
+    return TransformHierarchy.Worlds[TransformHierarchy.Slots[Id]];
+}
\ No newline at end of file
@@ -1,9 +1,9 @@
 #pragma once
 
-#include "types.h"
+#include <string.h>
 
-#define WIN32_MEAN_AND_LEAN
-#include <Windows.h>
+#include "types.h"
+#include "os_memory.h"
 
 enum BUMP_ALLOCATOR_MODE
 {
@@ -11,6 +11,17 @@ enum BUMP_ALLOCATOR_MODE
 	BUMP_RESIZABLE,
 };
 
+// A BUMP_RESIZABLE allocator reserves ReserveSize bytes of address space when it is created and
+// commits pages as it grows, GrowthFactor times the committed size at a time. Growing never moves
+// the memory, so pointers into the allocator stay valid until it is cleared or freed.
+constexpr size_t BUMP_DEFAULT_RESERVE = Megabytes(SCAST(size_t, 64));
+
+// With ALLOCATOR_HUGE_PAGES, resizable allocators reserve their range for huge pages and commit
+// it a huge page at a time once they reach this size, and fixed ones of this size take huge pages
+// from the start. The large instance and vertex arrays then take far fewer TLB misses, while the
+// many small allocators do not round up to megabytes.
+constexpr size_t BUMP_HUGE_PAGE_THRESHOLD = Megabytes(SCAST(size_t, 2));
+
 struct bump_allocator
 {
 	char Tag[16]             = {};
@@ -19,59 +30,287 @@ struct bump_allocator
 	size_t At                = 0;
 	size_t Size              = 0;
 	size_t Capacity          = 0;
+	size_t Reserved          = 0;
+	u32 TempCount            = 0;
+	u32 TelemetrySlot        = 0;
+	u32 MemoryFlags          = OS_MEMORY_DEFAULT;
 	BUMP_ALLOCATOR_MODE Mode = BUMP_FIXED;
 };
 
-inline bump_allocator CreateBumpAllocator(size_t Size, BUMP_ALLOCATOR_MODE Mode = BUMP_FIXED, const char* Tag = "NONE", u32 GrowthFactor = 2)
+// A checkpoint of an allocator. EndTemp frees everything pushed since the matching BeginTemp.
+struct temp_memory
+{
+	bump_allocator* Allocator;
+	size_t At;
+	size_t Size;
+};
+
+// Alignment for hot data: a block aligned on it never shares a cache line with the previous one,
+// and SIMD kernels can use aligned loads on it.
+constexpr size_t BUMP_CACHE_LINE = 64;
+
+// Debug builds fill reset memory with this byte, so reads of stale allocations stand out.
+constexpr u8 BUMP_POISON_BYTE = 0xCD;
+
+// -----------------
+// Telemetry
+// -----------------
+// Compiled in with ALLOCATOR_TELEMETRY. Allocators sharing a tag share an entry; the byte counts
+// are their sum. BytesCopied counts the bytes moved to grow an allocator. It stays 0 as long as
+// growth commits in place, and is there to catch any allocator that goes back to copying. Slot 0
+// collects the tags that did not fit.
+
+constexpr u32 ALLOCATOR_TELEMETRY_MAX_TAGS = 64;
+
+struct allocator_telemetry
+{
+	char   Tag[16];
+	u32    AllocatorCount;
+	size_t CurrentBytes;
+	size_t PeakBytes;
+	size_t CommittedBytes;
+	u64    PushCount;
+	u64    GrowthCount;
+	u64    BytesCopied;
+	u64    ClearCount;
+};
+
+struct allocator_telemetry_registry
+{
+	u32                 Count;
+	allocator_telemetry Entries[ALLOCATOR_TELEMETRY_MAX_TAGS];
+};
+
+inline allocator_telemetry_registry AllocatorTelemetry;
+
+inline u32 RegisterAllocatorTag(const char* Tag)
+{
+#if defined(ALLOCATOR_TELEMETRY)
+	if (AllocatorTelemetry.Count == 0)
+	{
+		memcpy(AllocatorTelemetry.Entries[0].Tag, "OTHER", 6);
+		AllocatorTelemetry.Count = 1;
+	}
+
+	for (u32 Slot = 1; Slot < AllocatorTelemetry.Count; Slot++)
+	{
+		if (strcmp(AllocatorTelemetry.Entries[Slot].Tag, Tag) == 0)
+		{
+			return Slot;
+		}
+	}
+	if (AllocatorTelemetry.Count < ALLOCATOR_TELEMETRY_MAX_TAGS)
+	{
+		u32 Slot = AllocatorTelemetry.Count++;
+		memcpy(AllocatorTelemetry.Entries[Slot].Tag, Tag, sizeof(AllocatorTelemetry.Entries[Slot].Tag));
+		return Slot;
+	}
+#endif
+	return 0;
+}
+
+// Returns nullptr when the tag was never registered or telemetry is compiled out.
+inline allocator_telemetry* FindAllocatorTelemetry(const char* Tag)
+{
+	for (u32 Slot = 0; Slot < AllocatorTelemetry.Count; Slot++)
+	{
+		if (strcmp(AllocatorTelemetry.Entries[Slot].Tag, Tag) == 0)
+		{
+			return &AllocatorTelemetry.Entries[Slot];
+		}
+	}
+	return nullptr;
+}
+
+// The allocators' entry, or nullptr when telemetry is compiled out, so the counting is too.
+inline allocator_telemetry* GetAllocatorTelemetry(u32 TelemetrySlot)
 {
+#if defined(ALLOCATOR_TELEMETRY)
+	return &AllocatorTelemetry.Entries[TelemetrySlot];
+#else
+	return nullptr;
+#endif
+}
+
+// Called when an allocator moves from OldAt to NewAt.
+inline void TrackAllocatorBytes(u32 TelemetrySlot, size_t OldAt, size_t NewAt)
+{
+	if (allocator_telemetry* Telemetry = GetAllocatorTelemetry(TelemetrySlot))
+	{
+		Telemetry->CurrentBytes = Telemetry->CurrentBytes - OldAt + NewAt;
+		Telemetry->PeakBytes    = Telemetry->CurrentBytes > Telemetry->PeakBytes ? Telemetry->CurrentBytes : Telemetry->PeakBytes;
+	}
+}
+
+// Tags are source literals, but they are escaped anyway so the file always parses.
+inline void WriteJSONString(FILE* File, const char* String)
+{
+	fputc('"', File);
+	for (const char* Char = String; *Char; Char++)
+	{
+		u8 Code = SCAST(u8, *Char);
+		if (Code == '"' || Code == '\\')
+		{
+			fputc('\\', File);
+			fputc(Code, File);
+		}
+		else if (Code < 0x20)
+		{
+			fprintf(File, "\\u%04x", Code);
+		}
+		else
+		{
+			fputc(Code, File);
+		}
+	}
+	fputc('"', File);
+}
+
+// One object per tag, for sizing the initial capacities from the peaks of a real session.
+inline bool WriteAllocatorTelemetryJSON(const char* Path)
+{
+	FILE* File = fopen(Path, "w");
+	if (!File)
+	{
+		return false;
+	}
+
+	fprintf(File, "{\n  \"allocators\": [\n");
+	for (u32 Slot = 0; Slot < AllocatorTelemetry.Count; Slot++)
+	{
+		allocator_telemetry* Telemetry = &AllocatorTelemetry.Entries[Slot];
+		fprintf(File, "    {\"tag\": ");
+		WriteJSONString(File, Telemetry->Tag);
+		fprintf(File, ", \"allocators\": %u, \"current_bytes\": %zu, \"peak_bytes\": %zu, "
+			          "\"committed_bytes\": %zu, \"pushes\": %llu, \"growths\": %llu, \"bytes_copied\": %llu, \"clears\": %llu}%s\n",
+			    Telemetry->AllocatorCount, Telemetry->CurrentBytes, Telemetry->PeakBytes,
+			    Telemetry->CommittedBytes, (unsigned long long)Telemetry->PushCount, (unsigned long long)Telemetry->GrowthCount,
+			    (unsigned long long)Telemetry->BytesCopied, (unsigned long long)Telemetry->ClearCount,
+			    Slot + 1 < AllocatorTelemetry.Count ? "," : "");
+	}
+	fprintf(File, "  ]\n}\n");
+
+	fclose(File);
+	return true;
+}
+
+// -----------------
+// Bump allocator
+// -----------------
+
+// Commits go a page at a time, and a huge page at a time past BUMP_HUGE_PAGE_THRESHOLD when the
+// allocator's range was reserved for them.
+inline size_t GetBumpCommitGranularity(u32 MemoryFlags, size_t Capacity)
+{
+	return Capacity >= BUMP_HUGE_PAGE_THRESHOLD ? GetMemoryGranularity(MemoryFlags) : GetPageSize();
+}
+
+inline bump_allocator CreateBumpAllocator(size_t Size, BUMP_ALLOCATOR_MODE Mode = BUMP_FIXED, const char* Tag = "NONE", u32 GrowthFactor = 2,
+	                                      size_t ReserveSize = BUMP_DEFAULT_RESERVE)
+{
+	u32 MemoryFlags = OS_MEMORY_DEFAULT;
+#if defined(ALLOCATOR_HUGE_PAGES)
+	if (Mode == BUMP_RESIZABLE || Size >= BUMP_HUGE_PAGE_THRESHOLD)
+	{
+		MemoryFlags = OS_MEMORY_HUGE_PAGES;
+	}
+#endif
+
+	size_t CommitSize = RoundUpToPage(Size > 0 ? Size : 1, GetBumpCommitGranularity(MemoryFlags, Size));
+	if (Mode == BUMP_FIXED || ReserveSize < CommitSize)
+	{
+		ReserveSize = CommitSize;
+	}
+
 	bump_allocator Allocator = {};
-	Allocator.Capacity       = Size;
 	Allocator.Mode           = Mode;
 	Allocator.GrowthFactor   = GrowthFactor;
-	Allocator.Memory         = (char*)VirtualAlloc(NULL, Size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-	memcpy(Allocator.Tag, Tag, 16);
+	Allocator.MemoryFlags    = MemoryFlags;
+	Allocator.Reserved       = RoundUpToPage(ReserveSize, GetMemoryGranularity(MemoryFlags));
+	for (u32 Index = 0; Index + 1 < sizeof(Allocator.Tag) && Tag[Index]; Index++)
+	{
+		Allocator.Tag[Index] = Tag[Index];
+	}
+
+	if (Mode == BUMP_FIXED)
+	{
+		Allocator.Memory   = (char*)ReserveAndCommitMemory(Allocator.Reserved, MemoryFlags);
+		Allocator.Capacity = Allocator.Memory ? CommitSize : 0;
+	}
+	else
+	{
+		Allocator.Memory = (char*)ReserveMemory(Allocator.Reserved, MemoryFlags);
+		if (Allocator.Memory && CommitMemory(Allocator.Memory, CommitSize))
+		{
+			Allocator.Capacity = CommitSize;
+		}
+	}
 
-	ASSERT(Allocator.Memory, "Failed to allocate memory for allocator. Memory corruption?");
+	ASSERT(Allocator.Memory, "Failed to reserve memory for allocator. Out of address space?");
+
+	Allocator.TelemetrySlot = RegisterAllocatorTag(Allocator.Tag);
+	if (allocator_telemetry* Telemetry = GetAllocatorTelemetry(Allocator.TelemetrySlot))
+	{
+		Telemetry->AllocatorCount += Allocator.Memory ? 1 : 0;
+		Telemetry->CommittedBytes += Allocator.Capacity;
+	}
 
 	return Allocator;
 }
 
-inline void* PushSize(size_t Size, bump_allocator* Allocator)
+// Alignment must be a power of two. The address itself is aligned: the memory never moves, so
+// the padding computed here stays right when the allocator grows.
+inline void* PushSize(size_t Size, bump_allocator* Allocator, size_t Alignment = 1)
 {
-	if (Allocator->At + Size > Allocator->Capacity)
+	ASSERT((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two.");
+
+	size_t Address = RCAST(size_t, Allocator->Memory + Allocator->At);
+	size_t Padding = (Alignment - (Address & (Alignment - 1))) & (Alignment - 1);
+	size_t Needed  = Allocator->At + Padding + Size;
+
+	if (Needed > Allocator->Capacity)
 	{
-		if (Allocator->Mode == BUMP_RESIZABLE)
+		if (Allocator->Mode != BUMP_RESIZABLE || Needed > Allocator->Reserved)
 		{
-			size_t NewCapacity = Allocator->Capacity * Allocator->GrowthFactor;
-			if (NewCapacity < Allocator->At + Size)
-			{
-				NewCapacity = Allocator->At + Size;
-			}
-
-			void* NewMemory = VirtualAlloc(NULL, NewCapacity, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-			ASSERT(NewMemory, "Possible memory corruption? | Out of memory?");
-			memcpy(NewMemory, Allocator->Memory, Allocator->At);
-			VirtualFree(Allocator->Memory, 0, MEM_RELEASE);
-
-			Allocator->Memory   = (char*)NewMemory;
-			Allocator->Capacity = NewCapacity;
+			// TODO: Fatal Error - Out of memory
+			return nullptr;
 		}
-		else
+
+		size_t NewCapacity = Allocator->Capacity * Allocator->GrowthFactor;
+		NewCapacity        = NewCapacity < Needed ? Needed : NewCapacity;
+		NewCapacity        = RoundUpToPage(NewCapacity, GetBumpCommitGranularity(Allocator->MemoryFlags, NewCapacity));
+		NewCapacity        = NewCapacity > Allocator->Reserved ? Allocator->Reserved : NewCapacity;
+
+		bool Committed = CommitMemory(Allocator->Memory + Allocator->Capacity, NewCapacity - Allocator->Capacity);
+		ASSERT(Committed, "Possible memory corruption? | Out of memory?");
+		if (!Committed)
 		{
-			// TODO: Fatal Error - Out of memory
 			return nullptr;
 		}
+
+		if (allocator_telemetry* Telemetry = GetAllocatorTelemetry(Allocator->TelemetrySlot))
+		{
+			Telemetry->GrowthCount    += 1;
+			Telemetry->CommittedBytes += NewCapacity - Allocator->Capacity;
+		}
+		Allocator->Capacity = NewCapacity;
+	}
+
+	if (allocator_telemetry* Telemetry = GetAllocatorTelemetry(Allocator->TelemetrySlot))
+	{
+		Telemetry->PushCount += 1;
 	}
+	TrackAllocatorBytes(Allocator->TelemetrySlot, Allocator->At, Needed);
 
-	void* Block      = Allocator->Memory + Allocator->At;
-	Allocator->At   += Size;
+	void* Block      = Allocator->Memory + Allocator->At + Padding;
+	Allocator->At    = Needed;
 	Allocator->Size += 1;
 	return Block;
 }
 
-inline void* PushAndCopy(size_t Size, void* Data, bump_allocator* Allocator)
+inline void* PushAndCopy(size_t Size, void* Data, bump_allocator* Allocator, size_t Alignment = 1)
 {
-	void* Block = PushSize(Size, Allocator);
+	void* Block = PushSize(Size, Allocator, Alignment);
 	if (Block)
 	{
 		memcpy(Block, Data, Size);
@@ -79,20 +318,119 @@ inline void* PushAndCopy(size_t Size, void* Data, bump_allocator* Allocator)
 	return Block;
 }
 
+// Typed pushes, aligned for T unless asked for more (BUMP_CACHE_LINE). The memory is not
+// initialized. Consecutive pushes of the same T are contiguous, so they can be indexed as one array.
+template <typename T>
+inline T* PushArray(size_t Count, bump_allocator* Allocator, size_t Alignment = alignof(T))
+{
+	return SCAST(T*, PushSize(Count * sizeof(T), Allocator, Alignment < alignof(T) ? alignof(T) : Alignment));
+}
+
+template <typename T>
+inline T* PushStruct(bump_allocator* Allocator, size_t Alignment = alignof(T))
+{
+	return PushArray<T>(1, Allocator, Alignment);
+}
+
+// For an allocator that holds a single array: grows the array to Size bytes and returns its start.
+// A BUMP_RESIZABLE allocator commits the new pages right after the array, so the array never moves
+// and nothing is copied. Returns nullptr once Size is past the reserved range.
+inline void* GrowInPlace(size_t Size, bump_allocator* Allocator)
+{
+	if (Size > Allocator->At && !PushSize(Size - Allocator->At, Allocator))
+	{
+		return nullptr;
+	}
+	return Allocator->Memory;
+}
+
+// Only for allocators whose users expect zeroed memory: the cost grows with what was pushed.
 inline void ClearAllocator(bump_allocator* Allocator)
 {
+	if (allocator_telemetry* Telemetry = GetAllocatorTelemetry(Allocator->TelemetrySlot))
+	{
+		Telemetry->ClearCount += 1;
+	}
+	TrackAllocatorBytes(Allocator->TelemetrySlot, Allocator->At, 0);
+
 	memset(Allocator->Memory, 0, Allocator->At);
 	Allocator->At = 0;
 	Allocator->Size = 0;
 }
 
-inline void FreeAllocator(bump_allocator* Allocator)
+inline void PoisonAllocatorMemory(bump_allocator* Allocator, size_t From)
+{
+#if defined(_DEBUG)
+	memset(Allocator->Memory + From, BUMP_POISON_BYTE, Allocator->At - From);
+#endif
+}
+
+// Gives back the last Size bytes, for arrays kept packed by moving their last element into the
+// one removed. Size still counts the pushes: an element popped from a pushed array is not one.
+inline void PopSize(size_t Size, bump_allocator* Allocator)
+{
+	ASSERT(Size <= Allocator->At, "Popping more than was pushed.");
+
+	TrackAllocatorBytes(Allocator->TelemetrySlot, Allocator->At, Allocator->At - Size);
+
+	PoisonAllocatorMemory(Allocator, Allocator->At - Size);
+	Allocator->At -= Size;
+}
+
+// Frame arena reset: the memory is left as it is and overwritten by the next frame's pushes, so
+// the cost does not depend on how much was pushed. Committed pages stay committed.
+inline void ResetAllocator(bump_allocator* Allocator)
+{
+	ASSERT(Allocator->TempCount == 0, "Resetting an allocator inside a BeginTemp/EndTemp scope.");
+
+	if (allocator_telemetry* Telemetry = GetAllocatorTelemetry(Allocator->TelemetrySlot))
+	{
+		Telemetry->ClearCount += 1;
+	}
+	TrackAllocatorBytes(Allocator->TelemetrySlot, Allocator->At, 0);
+
+	PoisonAllocatorMemory(Allocator, 0);
+	Allocator->At   = 0;
+	Allocator->Size = 0;
+}
+
+inline temp_memory BeginTemp(bump_allocator* Allocator)
+{
+	temp_memory Temp = {};
+	Temp.Allocator   = Allocator;
+	Temp.At          = Allocator->At;
+	Temp.Size        = Allocator->Size;
+
+	Allocator->TempCount += 1;
+	return Temp;
+}
+
+// Checkpoints nest: they must end in the reverse order they began.
+inline void EndTemp(temp_memory Temp)
 {
-	VirtualFree(Allocator->Memory, 0, MEM_RELEASE);
+	bump_allocator* Allocator = Temp.Allocator;
+	ASSERT(Allocator->TempCount > 0 && Allocator->At >= Temp.At, "EndTemp without a matching BeginTemp.");
+
+	TrackAllocatorBytes(Allocator->TelemetrySlot, Allocator->At, Temp.At);
+
+	PoisonAllocatorMemory(Allocator, Temp.At);
+	Allocator->At         = Temp.At;
+	Allocator->Size       = Temp.Size;
+	Allocator->TempCount -= 1;
 }
 
-inline size_t GetElementsCount(bump_allocator* Allocator, size_t ElementsSize)
+inline void FreeAllocator(bump_allocator* Allocator)
 {
-	size_t ElementsCount = Allocator->At / ElementsSize;
-	return ElementsCount;
+	if (allocator_telemetry* Telemetry = GetAllocatorTelemetry(Allocator->TelemetrySlot))
+	{
+		Telemetry->AllocatorCount -= Allocator->Memory ? 1 : 0;
+		Telemetry->CommittedBytes -= Allocator->Capacity;
+	}
+	TrackAllocatorBytes(Allocator->TelemetrySlot, Allocator->At, 0);
+
+	if (Allocator->Memory)
+	{
+		ReleaseMemory(Allocator->Memory, Allocator->Reserved);
+	}
+	*Allocator = bump_allocator();
 }
\ No newline at end of file
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "types.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// -----------------
+// OS memory
+// -----------------
+// Page-level memory from the OS: VirtualAlloc on Windows, mmap everywhere else. Reserved memory
+// only takes address space. It has to be committed, a page at a time, before use.
+//
+// OS_MEMORY_HUGE_PAGES asks for huge pages (2 MB on x64), so large arrays take far fewer TLB
+// misses. It is a hint: the memory works the same when the OS says no.
+//   - Linux: the range is aligned on a huge page and marked MADV_HUGEPAGE, so the kernel backs
+//     every committed huge page of it with a single TLB entry. Commit whole huge pages to get them.
+//   - Windows: large pages cannot be reserved without being committed, so only
+//     ReserveAndCommitMemory uses them, and only with the SeLockMemoryPrivilege.
+
+enum OS_MEMORY_FLAGS : u32
+{
+	OS_MEMORY_DEFAULT    = 0,
+	OS_MEMORY_HUGE_PAGES = 1 << 0,
+};
+
+constexpr size_t OS_DEFAULT_HUGE_PAGE_SIZE = Megabytes(SCAST(size_t, 2));
+
+inline size_t GetPageSize()
+{
+#if defined(_WIN32)
+	SYSTEM_INFO Info = {};
+	GetSystemInfo(&Info);
+	return Info.dwPageSize;
+#else
+	return SCAST(size_t, sysconf(_SC_PAGESIZE));
+#endif
+}
+
+// 0 when the OS has no huge pages to give.
+inline size_t GetHugePageSize()
+{
+#if defined(_WIN32)
+	return GetLargePageMinimum();
+#else
+	static size_t HugePageSize = 0;
+	if (HugePageSize == 0)
+	{
+		HugePageSize = OS_DEFAULT_HUGE_PAGE_SIZE;
+
+		FILE* File = fopen("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r");
+		if (File)
+		{
+			unsigned long long Size = 0;
+			if (fscanf(File, "%llu", &Size) == 1 && Size > 0)
+			{
+				HugePageSize = SCAST(size_t, Size);
+			}
+			fclose(File);
+		}
+	}
+	return HugePageSize;
+#endif
+}
+
+inline size_t RoundUpToPage(size_t Size, size_t PageSize)
+{
+	return (Size + PageSize - 1) / PageSize * PageSize;
+}
+
+// What reservations and commits made with Flags should be rounded to.
+inline size_t GetMemoryGranularity(u32 Flags)
+{
+#if !defined(_WIN32)
+	size_t HugePageSize = GetHugePageSize();
+	if ((Flags & OS_MEMORY_HUGE_PAGES) && HugePageSize > GetPageSize())
+	{
+		return HugePageSize;
+	}
+#endif
+	return GetPageSize();
+}
+
+// Size should be a multiple of GetMemoryGranularity(Flags).
+inline void* ReserveMemory(size_t Size, u32 Flags = OS_MEMORY_DEFAULT)
+{
+#if defined(_WIN32)
+	return VirtualAlloc(NULL, Size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+	size_t Alignment = GetMemoryGranularity(Flags);
+	size_t Extra     = Alignment > GetPageSize() ? Alignment : 0;
+
+	char* Memory = (char*)mmap(nullptr, Size + Extra, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (Memory == MAP_FAILED)
+	{
+		return nullptr;
+	}
+
+	// mmap only aligns on a page: over-reserve by a huge page and give back both ends.
+	if (Extra)
+	{
+		char* Aligned = (char*)((RCAST(size_t, Memory) + Alignment - 1) & ~(Alignment - 1));
+		if (Aligned > Memory)
+		{
+			munmap(Memory, Aligned - Memory);
+		}
+		if (Aligned + Size < Memory + Size + Extra)
+		{
+			munmap(Aligned + Size, (Memory + Size + Extra) - (Aligned + Size));
+		}
+		Memory = Aligned;
+
+#if defined(MADV_HUGEPAGE)
+		madvise(Memory, Size, MADV_HUGEPAGE);
+#endif
+	}
+	return Memory;
+#endif
+}
+
+// Address and Size must be page aligned and inside a reserved range.
+inline bool CommitMemory(void* Address, size_t Size)
+{
+#if defined(_WIN32)
+	return VirtualAlloc(Address, Size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+#else
+	return mprotect(Address, Size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+#if defined(_WIN32)
+// Large pages need the SeLockMemoryPrivilege, granted by the system policy, enabled for the process.
+inline bool EnableLargePages()
+{
+	static i32 Enabled = -1;
+	if (Enabled < 0)
+	{
+		Enabled      = 0;
+		HANDLE Token = NULL;
+		if (GetLargePageMinimum() > 0 && OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &Token))
+		{
+			TOKEN_PRIVILEGES Privileges = {};
+			Privileges.PrivilegeCount            = 1;
+			Privileges.Privileges[0].Attributes  = SE_PRIVILEGE_ENABLED;
+			if (LookupPrivilegeValue(NULL, SE_LOCK_MEMORY_NAME, &Privileges.Privileges[0].Luid) &&
+				AdjustTokenPrivileges(Token, FALSE, &Privileges, 0, NULL, NULL) && GetLastError() == ERROR_SUCCESS)
+			{
+				Enabled = 1;
+			}
+			CloseHandle(Token);
+		}
+	}
+	return Enabled == 1;
+}
+#endif
+
+// A range that is usable right away, for memory that never grows.
+inline void* ReserveAndCommitMemory(size_t Size, u32 Flags = OS_MEMORY_DEFAULT)
+{
+#if defined(_WIN32)
+	if ((Flags & OS_MEMORY_HUGE_PAGES) && EnableLargePages())
+	{
+		void* Memory = VirtualAlloc(NULL, RoundUpToPage(Size, GetLargePageMinimum()), MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+			                        PAGE_READWRITE);
+		if (Memory)
+		{
+			return Memory;
+		}
+	}
+	return VirtualAlloc(NULL, Size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+	void* Memory = ReserveMemory(Size, Flags);
+	if (Memory && !CommitMemory(Memory, Size))
+	{
+		munmap(Memory, Size);
+		return nullptr;
+	}
+	return Memory;
+#endif
+}
+
+// Releases a whole reserved range. Size is the reserved size.
+inline void ReleaseMemory(void* Address, size_t Size)
+{
+#if defined(_WIN32)
+	VirtualFree(Address, 0, MEM_RELEASE);
+#else
+	munmap(Address, Size);
+#endif
+}
\ No newline at end of file
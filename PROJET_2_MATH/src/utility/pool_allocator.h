@@ -0,0 +1,173 @@
+#pragma once
+
+#include "allocators.h"
+
+// Fixed-size slots referred to by 32-bit handles: the low POOL_INDEX_BITS are the slot index, the
+// rest is the slot's generation, which changes every time the slot is freed. A handle kept after
+// its element was freed no longer matches, so GetPoolElement returns nullptr instead of whatever
+// reuses the slot. A free slot stores the index of the next free slot, so allocating and freeing
+// are O(1) and freed slots are reused before the pool grows.
+//
+// Like a BUMP_RESIZABLE allocator, the pool reserves its address range up front and commits
+// pages as it grows: elements never move and the count is only bounded by MaxCount.
+
+constexpr u32 POOL_INDEX_BITS      = 20;
+constexpr u32 POOL_MAX_COUNT       = 1u << POOL_INDEX_BITS;
+constexpr u32 POOL_INDEX_MASK      = POOL_MAX_COUNT - 1;
+constexpr u32 POOL_GENERATION_MASK = (1u << (32 - POOL_INDEX_BITS)) - 1;
+constexpr u32 POOL_FREE_NONE       = 0xFFFFFFFF;
+constexpr u16 POOL_SLOT_ALIVE      = 0x8000;
+
+// Generations start at 1, so a zero-initialized handle never refers to an element.
+typedef u32 pool_handle;
+constexpr pool_handle POOL_HANDLE_NONE = 0;
+
+struct pool_allocator
+{
+	char   Tag[16]        = {};
+	char*  Memory         = nullptr;
+	u16*   Generations    = nullptr;
+	u32    Stride         = 0;
+	u32    MaxCount       = 0;
+	u32    CommittedCount = 0;
+	u32    SlotCount      = 0;
+	u32    FreeHead       = POOL_FREE_NONE;
+	u32    Count          = 0;
+};
+
+inline pool_allocator CreatePoolAllocator(size_t ElementSize, size_t Alignment, const char* Tag = "NONE", u32 MaxCount = POOL_MAX_COUNT)
+{
+	ASSERT((Alignment & (Alignment - 1)) == 0 && Alignment <= GetPageSize(), "Alignment must be a power of two, at most a page.");
+
+	size_t Stride = ElementSize > sizeof(u32) ? ElementSize : sizeof(u32);
+	Stride        = (Stride + Alignment - 1) & ~(Alignment - 1);
+
+	pool_allocator Pool = {};
+	Pool.Stride         = SCAST(u32, Stride);
+	Pool.MaxCount       = MaxCount < POOL_MAX_COUNT ? MaxCount : POOL_MAX_COUNT;
+	Pool.Memory         = (char*)ReserveMemory(RoundUpToPage(Pool.MaxCount * Stride, GetPageSize()));
+	Pool.Generations    = (u16*)ReserveMemory(RoundUpToPage(Pool.MaxCount * sizeof(u16), GetPageSize()));
+	for (u32 Index = 0; Index + 1 < sizeof(Pool.Tag) && Tag[Index]; Index++)
+	{
+		Pool.Tag[Index] = Tag[Index];
+	}
+
+	ASSERT(Pool.Memory && Pool.Generations, "Failed to reserve memory for pool. Out of address space?");
+
+	return Pool;
+}
+
+// Commits twice the slots, at least a page worth, for the elements and their generations.
+inline bool GrowPool(pool_allocator* Pool)
+{
+	size_t PageSize = GetPageSize();
+	u32 PageCount   = Pool->Stride < PageSize ? SCAST(u32, PageSize / Pool->Stride) : 1;
+	u32 NewCount    = Pool->CommittedCount * 2;
+	NewCount        = NewCount > PageCount ? NewCount : PageCount;
+	NewCount        = NewCount > Pool->MaxCount ? Pool->MaxCount : NewCount;
+
+	size_t SlotsFrom       = RoundUpToPage(SCAST(size_t, Pool->CommittedCount) * Pool->Stride, PageSize);
+	size_t SlotsTo         = RoundUpToPage(SCAST(size_t, NewCount) * Pool->Stride, PageSize);
+	size_t GenerationsFrom = RoundUpToPage(Pool->CommittedCount * sizeof(u16), PageSize);
+	size_t GenerationsTo   = RoundUpToPage(NewCount * sizeof(u16), PageSize);
+
+	if ((SlotsTo > SlotsFrom && !CommitMemory(Pool->Memory + SlotsFrom, SlotsTo - SlotsFrom)) ||
+		(GenerationsTo > GenerationsFrom && !CommitMemory((char*)Pool->Generations + GenerationsFrom, GenerationsTo - GenerationsFrom)))
+	{
+		return false;
+	}
+
+	Pool->CommittedCount = NewCount;
+	return true;
+}
+
+// Returns POOL_HANDLE_NONE once MaxCount elements are alive. The element is not initialized.
+inline pool_handle PoolAllocate(pool_allocator* Pool)
+{
+	u32 Index = Pool->FreeHead;
+	if (Index != POOL_FREE_NONE)
+	{
+		Pool->FreeHead = *(u32*)(Pool->Memory + SCAST(size_t, Index) * Pool->Stride);
+	}
+	else
+	{
+		if (Pool->SlotCount >= Pool->MaxCount || !Pool->Memory)
+		{
+			return POOL_HANDLE_NONE;
+		}
+		if (Pool->SlotCount == Pool->CommittedCount && !GrowPool(Pool))
+		{
+			ASSERT(false, "Possible memory corruption? | Out of memory?");
+			return POOL_HANDLE_NONE;
+		}
+
+		Index                     = Pool->SlotCount;
+		Pool->SlotCount          += 1;
+		Pool->Generations[Index]  = 1;
+	}
+
+	Pool->Generations[Index] |= POOL_SLOT_ALIVE;
+	Pool->Count              += 1;
+
+	u32 Generation = Pool->Generations[Index] & POOL_GENERATION_MASK;
+	return (Generation << POOL_INDEX_BITS) | Index;
+}
+
+inline bool IsPoolHandleValid(pool_allocator* Pool, pool_handle Handle)
+{
+	u32 Index = Handle & POOL_INDEX_MASK;
+	if (Index >= Pool->SlotCount)
+	{
+		return false;
+	}
+
+	u16 Expected = SCAST(u16, POOL_SLOT_ALIVE | (Handle >> POOL_INDEX_BITS));
+	return Pool->Generations[Index] == Expected;
+}
+
+inline void* GetPoolElement(pool_allocator* Pool, pool_handle Handle)
+{
+	if (!IsPoolHandleValid(Pool, Handle))
+	{
+		return nullptr;
+	}
+	return Pool->Memory + SCAST(size_t, Handle & POOL_INDEX_MASK) * Pool->Stride;
+}
+
+template <typename T>
+inline T* GetPoolElement(pool_allocator* Pool, pool_handle Handle)
+{
+	return SCAST(T*, GetPoolElement(Pool, Handle));
+}
+
+// Every handle to the element becomes invalid. Freeing a stale handle does nothing.
+inline bool PoolFree(pool_allocator* Pool, pool_handle Handle)
+{
+	if (!IsPoolHandleValid(Pool, Handle))
+	{
+		return false;
+	}
+
+	u32 Index      = Handle & POOL_INDEX_MASK;
+	u16 Generation = SCAST(u16, ((Pool->Generations[Index] & POOL_GENERATION_MASK) + 1) & POOL_GENERATION_MASK);
+
+	Pool->Generations[Index] = Generation == 0 ? 1 : Generation;
+	Pool->Count             -= 1;
+
+	*(u32*)(Pool->Memory + SCAST(size_t, Index) * Pool->Stride) = Pool->FreeHead;
+	Pool->FreeHead                                             = Index;
+	return true;
+}
+
+inline void FreePoolAllocator(pool_allocator* Pool)
+{
+	if (Pool->Memory)
+	{
+		ReleaseMemory(Pool->Memory, RoundUpToPage(SCAST(size_t, Pool->MaxCount) * Pool->Stride, GetPageSize()));
+	}
+	if (Pool->Generations)
+	{
+		ReleaseMemory(Pool->Generations, RoundUpToPage(Pool->MaxCount * sizeof(u16), GetPageSize()));
+	}
+	*Pool = pool_allocator();
+}
\ No newline at end of file
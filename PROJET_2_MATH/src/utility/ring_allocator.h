@@ -0,0 +1,111 @@
+#pragma once
+
+#include "types.h"
+
+// Sub-allocates per-frame upload data out of one buffer used as a ring. Allocations go after the
+// previous ones and wrap to the start when they do not fit before the end. Nothing is freed on its
+// own: EndRingFrame marks where a frame's data ends, and ReleaseRingFrame gives the oldest frame
+// back once the GPU is done with it. At most FramesInFlight frames are pending, and an allocation
+// that would reach into one of them fails, so data the GPU may still read is never overwritten.
+//
+// The ring only hands out offsets. The memory behind them is the caller's: a mapped GPU buffer,
+// an arena, or nothing at all.
+
+constexpr u32    RING_MAX_FRAMES_IN_FLIGHT = 4;
+constexpr size_t RING_ALLOCATION_FAILED    = ~SCAST(size_t, 0);
+
+struct ring_allocator
+{
+	size_t Size                                    = 0;
+	size_t Head                                    = 0;
+	size_t Used                                    = 0;
+	size_t FrameUsed                               = 0;
+	size_t PendingUsed[RING_MAX_FRAMES_IN_FLIGHT]  = {};
+	u32    FramesInFlight                          = 0;
+	u32    PendingCount                            = 0;
+	u32    OldestPending                           = 0;
+	u32    WrapCount                               = 0;
+};
+
+inline ring_allocator CreateRingAllocator(size_t Size, u32 FramesInFlight)
+{
+	ASSERT(FramesInFlight > 0 && FramesInFlight <= RING_MAX_FRAMES_IN_FLIGHT, "Unsupported number of frames in flight.");
+
+	ring_allocator Ring = {};
+	Ring.Size           = Size;
+	Ring.FramesInFlight = FramesInFlight;
+	return Ring;
+}
+
+// Returns the offset of Size bytes aligned on Alignment, a power of two, or RING_ALLOCATION_FAILED
+// when they do not fit next to the pending frames. The end skipped when wrapping counts as used
+// until the frame is released. WrapCount counts the times the head went back to the start.
+inline size_t RingAllocate(ring_allocator* Ring, size_t Size, size_t Alignment = 1)
+{
+	ASSERT((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two.");
+
+	// Nothing pending: start over, so the whole ring is available in one piece.
+	if (Ring->Used == 0 && Ring->Head != 0)
+	{
+		Ring->Head       = 0;
+		Ring->WrapCount += 1;
+	}
+
+	size_t Offset  = (Ring->Head + Alignment - 1) & ~(Alignment - 1);
+	bool   Wraps   = Offset + Size > Ring->Size;
+	Offset         = Wraps ? 0 : Offset;
+
+	size_t Skipped = Wraps ? Ring->Size - Ring->Head : Offset - Ring->Head;
+	if (Size > Ring->Size || Ring->Used + Skipped + Size > Ring->Size)
+	{
+		return RING_ALLOCATION_FAILED;
+	}
+
+	Ring->Head       = Offset + Size;
+	Ring->Used      += Skipped + Size;
+	Ring->FrameUsed += Skipped + Size;
+	Ring->WrapCount += Wraps ? 1 : 0;
+
+	return Offset;
+}
+
+// Everything allocated since the previous EndRingFrame belongs to this frame. The caller releases
+// the oldest frame first when FramesInFlight are already pending.
+inline bool EndRingFrame(ring_allocator* Ring)
+{
+	if (Ring->PendingCount == Ring->FramesInFlight)
+	{
+		ASSERT(false, "Too many frames in flight. Was the oldest frame released?");
+		return false;
+	}
+
+	u32 Slot                = (Ring->OldestPending + Ring->PendingCount) % RING_MAX_FRAMES_IN_FLIGHT;
+	Ring->PendingUsed[Slot] = Ring->FrameUsed;
+	Ring->PendingCount     += 1;
+	Ring->FrameUsed         = 0;
+	return true;
+}
+
+// Call once the GPU finished the oldest pending frame, e.g. when its fence is signaled.
+inline bool ReleaseRingFrame(ring_allocator* Ring)
+{
+	if (Ring->PendingCount == 0)
+	{
+		return false;
+	}
+
+	Ring->Used          -= Ring->PendingUsed[Ring->OldestPending];
+	Ring->OldestPending  = (Ring->OldestPending + 1) % RING_MAX_FRAMES_IN_FLIGHT;
+	Ring->PendingCount  -= 1;
+	return true;
+}
+
+// For backends without fences, whose swap chain never queues more than FramesInFlight - 1 frames:
+// when a new frame starts with FramesInFlight frames pending, the oldest one is done.
+inline void BeginRingFrame(ring_allocator* Ring)
+{
+	if (Ring->PendingCount == Ring->FramesInFlight)
+	{
+		ReleaseRingFrame(Ring);
+	}
+}
\ No newline at end of file
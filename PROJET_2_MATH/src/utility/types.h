@@ -41,7 +41,6 @@ typedef double f64;
 
 #define SAFE_RELEASE(x) { if(x) { (x)->Release(); (x) = nullptr; } }
 
-constexpr auto MAX_VECTORS = 100;
 constexpr auto SHARED_OBJECT_DATA_SLOT = 0;
 constexpr auto OBJECT_DATA_SLOT = 1;
 constexpr auto INSTANCE_DATA_SLOT = 0;
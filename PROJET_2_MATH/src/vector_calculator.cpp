@@ -0,0 +1,253 @@
+#include "math/batch.hpp"
+#include "utility/allocators.h"
+
+// -----------------
+// Vector calculator engine
+// -----------------
+// Headless version of the calculator UI. It applies one operation to whole arrays of
+// simulation_vectors, either every left vector with a single right one (N x 1) or every left
+// vector with every right one (N x N). The operands are copied to SoA streams, the math runs
+// through the batch kernels, and the results become new vectors in one CreateSimulationVectors.
+
+enum OPERATION_TYPE
+{
+    OPERATION_ADDITION,
+    OPERATION_SUBTRACTION,
+    OPERATION_VECTOR_PRODUCT,
+    OPERATION_SCALING,
+    OPERATION_VECTOR_PROJECTION,
+    OPERATION_PLANE_PROJECTION,
+
+    OPERATION_TYPE_COUNT
+};
+
+enum CALCULATOR_LAYOUT
+{
+    CALCULATOR_N_BY_ONE,
+    CALCULATOR_N_BY_N,
+};
+
+struct calculator_batch
+{
+    OPERATION_TYPE     OpType;
+    CALCULATOR_LAYOUT  Layout;
+    simulation_vector* Left;
+    u32                LeftCount;
+    simulation_vector* Right;
+    u32                RightCount;
+    f32                Scalar;
+    vec_3              PlaneNormal;
+};
+
+// Output i of an N x N batch is Left[i / RightCount] with Right[i % RightCount].
+struct calculator_output
+{
+    soa_vec_3 Origins;
+    soa_vec_3 Destinations;
+    u32       Count;
+};
+
+struct calculator_operands
+{
+    soa_vec_3 Origins;
+    soa_vec_3 Tips;
+    soa_vec_3 Vectors;
+};
+
+static bump_allocator CalculatorScratch;
+
+static soa_vec_3 PushVectorStreams(u32 Count, bump_allocator* Allocator)
+{
+    soa_vec_3 Streams = {};
+    Streams.x         = PushArray<f32>(Count, Allocator, BUMP_CACHE_LINE);
+    Streams.y         = PushArray<f32>(Count, Allocator, BUMP_CACHE_LINE);
+    Streams.z         = PushArray<f32>(Count, Allocator, BUMP_CACHE_LINE);
+    return Streams;
+}
+
+static void FillVectorStreams(soa_vec_3 Streams, u32 Count, f32 x, f32 y, f32 z)
+{
+    for (u32 Index = 0; Index < Count; Index++)
+    {
+        Streams.x[Index] = x;
+        Streams.y[Index] = y;
+        Streams.z[Index] = z;
+    }
+}
+
+static void CopyVectorStreams(soa_vec_3 Destination, soa_vec_3 Source, u32 Count)
+{
+    memcpy(Destination.x, Source.x, Count * sizeof(f32));
+    memcpy(Destination.y, Source.y, Count * sizeof(f32));
+    memcpy(Destination.z, Source.z, Count * sizeof(f32));
+}
+
+static bool IsUnaryOperation(OPERATION_TYPE OpType)
+{
+    return OpType == OPERATION_SCALING || OpType == OPERATION_PLANE_PROJECTION;
+}
+
+static u32 GetCalculatorOutputCount(calculator_batch* Batch)
+{
+    if (IsUnaryOperation(Batch->OpType))
+    {
+        return Batch->LeftCount;
+    }
+    if (Batch->RightCount == 0)
+    {
+        return 0;
+    }
+    return Batch->Layout == CALCULATOR_N_BY_ONE ? Batch->LeftCount : Batch->LeftCount * Batch->RightCount;
+}
+
+// The world-space vector of a simulation_vector is Direction - Origin, as in the UI.
+static calculator_operands GatherOperands(simulation_vector* Vectors, u32 Count, bump_allocator* Allocator)
+{
+    calculator_operands Operands = {};
+    Operands.Origins             = PushVectorStreams(Count, Allocator);
+    Operands.Tips                = PushVectorStreams(Count, Allocator);
+    Operands.Vectors             = PushVectorStreams(Count, Allocator);
+
+    for (u32 Index = 0; Index < Count; Index++)
+    {
+        Operands.Origins.x[Index] = Vectors[Index].Origin.x;
+        Operands.Origins.y[Index] = Vectors[Index].Origin.y;
+        Operands.Origins.z[Index] = Vectors[Index].Origin.z;
+        Operands.Tips.x[Index]    = Vectors[Index].Direction.x;
+        Operands.Tips.y[Index]    = Vectors[Index].Direction.y;
+        Operands.Tips.z[Index]    = Vectors[Index].Direction.z;
+    }
+    BatchSubtractVectors(Operands.Tips, Operands.Origins, Operands.Vectors, Count);
+
+    return Operands;
+}
+
+static void RunCalculatorOperation(calculator_batch* Batch, soa_vec_3 Left, soa_vec_3 Right, soa_vec_3 Out, u32 Count, u32 Broadcast)
+{
+    switch (Batch->OpType)
+    {
+    case OPERATION_ADDITION:
+    {
+        BatchAddVectors(Left, Right, Out, Count, Broadcast);
+        break;
+    }
+    case OPERATION_SUBTRACTION:
+    {
+        BatchSubtractVectors(Left, Right, Out, Count, Broadcast);
+        break;
+    }
+    case OPERATION_VECTOR_PRODUCT:
+    {
+        BatchVectorProduct(Left, Right, Out, Count, Broadcast);
+        break;
+    }
+    case OPERATION_VECTOR_PROJECTION:
+    {
+        // Like the UI, the right vector is projected onto the left one.
+        u32 Swapped = ((Broadcast & BATCH_BROADCAST_A) ? BATCH_BROADCAST_B : 0) |
+                      ((Broadcast & BATCH_BROADCAST_B) ? BATCH_BROADCAST_A : 0);
+        BatchProjectOnVector(Right, Left, Out, Count, Swapped);
+        break;
+    }
+    case OPERATION_SCALING:
+    {
+        BatchScaleVectors(Left, Batch->Scalar, Out, Count, Broadcast);
+        break;
+    }
+    case OPERATION_PLANE_PROJECTION:
+    {
+        f32 NormalX      = Batch->PlaneNormal.x;
+        f32 NormalY      = Batch->PlaneNormal.y;
+        f32 NormalZ      = Batch->PlaneNormal.z;
+        soa_vec_3 Normal = { &NormalX, &NormalY, &NormalZ };
+        BatchProjectOnPlane(Left, Normal, Out, Count, (Broadcast & BATCH_BROADCAST_A) | BATCH_BROADCAST_B);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// Results live in Allocator until the caller's checkpoint ends.
+static calculator_output ComputeCalculatorBatch(calculator_batch* Batch, bump_allocator* Allocator)
+{
+    calculator_output Output = {};
+    Output.Count             = GetCalculatorOutputCount(Batch);
+    if (Output.Count == 0)
+    {
+        return Output;
+    }
+
+    Output.Origins      = PushVectorStreams(Output.Count, Allocator);
+    Output.Destinations = PushVectorStreams(Output.Count, Allocator);
+
+    bool IsUnary        = IsUnaryOperation(Batch->OpType);
+    bool IsSubtraction  = Batch->OpType == OPERATION_SUBTRACTION;
+    u32  RightCount     = Batch->Layout == CALCULATOR_N_BY_ONE ? 1 : Batch->RightCount;
+
+    // The gathered operands are only needed until the outputs are written.
+    temp_memory OperandsMemory = BeginTemp(Allocator);
+    calculator_operands Left   = GatherOperands(Batch->Left, Batch->LeftCount, Allocator);
+    calculator_operands Right = IsUnary ? Left : GatherOperands(Batch->Right, RightCount, Allocator);
+
+    if (IsUnary || Batch->Layout == CALCULATOR_N_BY_ONE)
+    {
+        u32 Broadcast = IsUnary ? BATCH_BROADCAST_NONE : BATCH_BROADCAST_B;
+        RunCalculatorOperation(Batch, Left.Vectors, Right.Vectors, Output.Destinations, Output.Count, Broadcast);
+
+        if (IsSubtraction)
+        {
+            FillVectorStreams(Output.Origins, Output.Count, Right.Tips.x[0], Right.Tips.y[0], Right.Tips.z[0]);
+        }
+        else
+        {
+            CopyVectorStreams(Output.Origins, Left.Origins, Output.Count);
+        }
+    }
+    else
+    {
+        for (u32 LeftIndex = 0; LeftIndex < Batch->LeftCount; LeftIndex++)
+        {
+            u32 OutputOffset = LeftIndex * RightCount;
+            soa_vec_3 Out    = OffsetVectorStreams(Output.Destinations, OutputOffset);
+            RunCalculatorOperation(Batch, OffsetVectorStreams(Left.Vectors, LeftIndex), Right.Vectors, Out, RightCount,
+                                   BATCH_BROADCAST_A);
+
+            soa_vec_3 Origins = OffsetVectorStreams(Output.Origins, OutputOffset);
+            if (IsSubtraction)
+            {
+                CopyVectorStreams(Origins, Right.Tips, RightCount);
+            }
+            else
+            {
+                FillVectorStreams(Origins, RightCount, Left.Origins.x[LeftIndex], Left.Origins.y[LeftIndex],
+                                  Left.Origins.z[LeftIndex]);
+            }
+        }
+    }
+
+    EndTemp(OperandsMemory);
+
+    // The operations produce world-space vectors; the new vectors start at their origin.
+    BatchAddVectors(Output.Origins, Output.Destinations, Output.Destinations, Output.Count);
+    return Output;
+}
+
+// Computes the batch and creates the resulting vectors. Returns how many were created, which can
+// be less than the output count once the vector storage is full.
+static u32 CreateCalculatedVectors(calculator_batch* Batch, vec_4 Color)
+{
+    // Growing commits more of the reserved range in place, so the streams already handed out stay valid.
+    // An 8 x 8 batch peaks at 2656 bytes, so 8 KB covers the batches the UI builds without growing.
+    if (!CalculatorScratch.Memory)
+    {
+        CalculatorScratch = CreateBumpAllocator(Kilobytes(8), BUMP_RESIZABLE, "Calculator");
+    }
+
+    temp_memory BatchMemory  = BeginTemp(&CalculatorScratch);
+    calculator_output Output = ComputeCalculatorBatch(Batch, &CalculatorScratch);
+    u32 CreatedCount         = CreateSimulationVectors(Output.Origins, Output.Destinations, Color, Output.Count);
+
+    EndTemp(BatchMemory);
+    return CreatedCount;
+}
\ No newline at end of file
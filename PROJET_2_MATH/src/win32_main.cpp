@@ -11,6 +11,7 @@
 #include "asset_table.cpp"
 #include "directx/dx11_main.cpp"
 #include "entities.cpp"
+#include "vector_calculator.cpp"
 #include "space.cpp"
 #include "ui/main_ui.cpp"
 
@@ -282,6 +283,7 @@ int main()
 
 			RenderSimulationUI();
 
+			UpdateCameraFrame();
 			UpdateEntities();
 			UpdateSpace();
 
@@ -305,6 +307,11 @@ int main()
 		ImGui_ImplDX11_Shutdown();
 		ImGui_ImplWin32_Shutdown();
 		ImGui::DestroyContext();
+
+#if defined(ALLOCATOR_TELEMETRY)
+		// Peak bytes per tag, to size the initial capacities of the allocators.
+		WriteAllocatorTelemetryJSON("allocator_telemetry.json");
+#endif
 	}
 	else
 	{